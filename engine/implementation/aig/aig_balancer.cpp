@@ -0,0 +1,179 @@
+#include "aig_balancer.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+// Marks nodes, that are not balanced yet.
+const TAigLiteral g_unbalanced_literal = ~TAigLiteral(0);
+
+class Balancer
+{
+public:
+   Balancer(const AigManager& source, AigManager& target);
+
+   TAigLiteral Balance(TAigLiteral root);
+
+private:
+   // Returns the literal of the target graph for the AND node of the source one.
+   TAigLiteral BalanceNode(std::uint32_t node);
+
+   // Collects inputs of the multi-input AND gate with the node at its top:
+   // uncomplemented fanins, which are AND nodes with a single fanout, are expanded.
+   void CollectGateInputs(std::uint32_t node, std::vector<TAigLiteral>& inputs) const;
+
+   TAigLiteral MapLiteral(TAigLiteral literal);
+
+private:
+   const AigManager& m_source;
+   AigManager& m_target;
+   std::vector<long> m_fanout_counts;
+   std::vector<TAigLiteral> m_balanced_literals;
+};
+
+Balancer::Balancer(const AigManager& source, AigManager& target) :
+   m_source(source), m_target(target), m_fanout_counts(), m_balanced_literals()
+{
+   assert(source.GetInputCount() == target.GetInputCount());
+}
+
+TAigLiteral Balancer::Balance(TAigLiteral root)
+{
+   // Fanouts are counted among nodes, reachable from the root.
+   const auto node_count = AigManager::GetNode(root) + 1;
+   m_fanout_counts.resize(node_count, 0);
+   m_balanced_literals.resize(node_count, g_unbalanced_literal);
+
+   std::vector<bool> visited(node_count, false);
+   std::vector<std::uint32_t> stack(1, AigManager::GetNode(root));
+   while (!stack.empty())
+   {
+      const auto node = stack.back();
+      stack.pop_back();
+      if (visited[node] || !m_source.IsAnd(node))
+      {
+         continue;
+      }
+
+      visited[node] = true;
+      for (const auto fanin : { m_source.GetFanin0(node), m_source.GetFanin1(node) })
+      {
+         ++m_fanout_counts[AigManager::GetNode(fanin)];
+         stack.push_back(AigManager::GetNode(fanin));
+      }
+   }
+
+   return MapLiteral(root);
+}
+
+TAigLiteral Balancer::MapLiteral(TAigLiteral literal)
+{
+   const auto node = AigManager::GetNode(literal);
+   const auto is_complemented = AigManager::IsComplemented(literal);
+   if (m_source.IsConstant(node))
+   {
+      return literal;
+   }
+   if (m_source.IsInput(node))
+   {
+      const auto input = m_target.GetInput(m_source.GetInputIndex(node));
+      return is_complemented ? AigManager::Not(input) : input;
+   }
+
+   const auto balanced = BalanceNode(node);
+   return is_complemented ? AigManager::Not(balanced) : balanced;
+}
+
+TAigLiteral Balancer::BalanceNode(std::uint32_t node)
+{
+   if (m_balanced_literals[node] != g_unbalanced_literal)
+   {
+      return m_balanced_literals[node];
+   }
+
+   std::vector<TAigLiteral> inputs;
+   CollectGateInputs(node, inputs);
+   for (auto& input : inputs)
+   {
+      input = MapLiteral(input);
+   }
+
+   // Repeated inputs are dropped, and complementary ones make the gate constant.
+   std::sort(inputs.begin(), inputs.end());
+   inputs.erase(std::unique(inputs.begin(), inputs.end()), inputs.end());
+
+   auto result = g_aig_true;
+   for (auto index = size_t(1); index < inputs.size(); ++index)
+   {
+      if (inputs[index] == AigManager::Not(inputs[index - 1]))
+      {
+         result = g_aig_false;
+         break;
+      }
+   }
+
+   if (g_aig_true == result)
+   {
+      // Two inputs with the lowest levels are paired at first, like in Huffman coding.
+      const auto is_deeper = [this](TAigLiteral left, TAigLiteral right)
+      {
+         const auto left_level = m_target.GetLevel(AigManager::GetNode(left));
+         const auto right_level = m_target.GetLevel(AigManager::GetNode(right));
+         return (left_level > right_level) || (left_level == right_level && left > right);
+      };
+      std::priority_queue<TAigLiteral, std::vector<TAigLiteral>, decltype(is_deeper)> queue(
+         is_deeper, std::move(inputs));
+      while (queue.size() > 1)
+      {
+         const auto left = queue.top();
+         queue.pop();
+         const auto right = queue.top();
+         queue.pop();
+         queue.push(m_target.And(left, right));
+      }
+      if (!queue.empty())
+      {
+         result = queue.top();
+      }
+   }
+
+   m_balanced_literals[node] = result;
+   return result;
+}
+
+void Balancer::CollectGateInputs(std::uint32_t node, std::vector<TAigLiteral>& inputs) const
+{
+   std::vector<TAigLiteral> stack = { m_source.GetFanin1(node), m_source.GetFanin0(node) };
+   while (!stack.empty())
+   {
+      const auto literal = stack.back();
+      stack.pop_back();
+
+      const auto fanin_node = AigManager::GetNode(literal);
+      if (AigManager::IsComplemented(literal) || !m_source.IsAnd(fanin_node) ||
+          m_fanout_counts[fanin_node] > 1)
+      {
+         inputs.push_back(literal);
+         continue;
+      }
+
+      stack.push_back(m_source.GetFanin1(fanin_node));
+      stack.push_back(m_source.GetFanin0(fanin_node));
+   }
+}
+
+} // namespace
+
+TAigLiteral BalanceAig(const AigManager& source, TAigLiteral root, AigManager& target)
+{
+   return Balancer(source, target).Balance(root);
+}
+
+} // namespace dm
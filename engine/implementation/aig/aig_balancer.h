@@ -0,0 +1,13 @@
+#pragma once
+
+#include "aig_manager.h"
+
+namespace dm
+{
+
+// Rebuilds the graph of the root in the target manager with the same amount of inputs,
+// reducing its depth. Trees of AND nodes, which are not shared, are collected into
+// multi-input AND gates, and inputs of each gate are paired from the lowest levels.
+TAigLiteral BalanceAig(const AigManager& source, TAigLiteral root, AigManager& target);
+
+} // namespace dm
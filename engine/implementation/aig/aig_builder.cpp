@@ -0,0 +1,198 @@
+#include "aig_builder.h"
+
+#include <unordered_map>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+using TBuiltAigMap = std::unordered_map<const UniqueExpression*, TAigLiteral>;
+using TBuiltExpressionMap = std::unordered_map<TAigLiteral, TUniqueExpressionPtr>;
+
+TAigLiteral BuildAigImpl(AigManager& manager, const TUniqueExpressionPtr& expr, TBuiltAigMap& built)
+{
+   switch (expr->GetType())
+   {
+      case ExpressionType::Literal:
+         return LiteralType::True == expr->GetLiteral() ? g_aig_true : g_aig_false;
+
+      case ExpressionType::ParamRef:
+         return manager.GetInput(expr->GetParamIndex());
+
+      case ExpressionType::Operation:
+      {
+         const auto iter = built.find(expr.get());
+         if (iter != built.end())
+         {
+            return iter->second;
+         }
+
+         const auto operation = expr->GetOperation();
+         const auto child_count = expr->GetChildCount();
+
+         auto result = BuildAigImpl(manager, expr->GetChild(0), built);
+         if (OperationType::Negation == operation)
+         {
+            assert(1 == child_count);
+            result = AigManager::Not(result);
+            built.emplace(expr.get(), result);
+            return result;
+         }
+
+         // Operations are folded from left to right, like PerformOperation does.
+         for (auto index = 1L; index < child_count; ++index)
+         {
+            const auto child = BuildAigImpl(manager, expr->GetChild(index), built);
+            switch (operation)
+            {
+               case OperationType::Conjunction:
+                  result = manager.And(result, child);
+                  break;
+
+               case OperationType::Disjunction:
+                  result = manager.Or(result, child);
+                  break;
+
+               case OperationType::Implication:
+                  result = manager.Implication(result, child);
+                  break;
+
+               case OperationType::Equality:
+                  result = AigManager::Not(manager.Xor(result, child));
+                  break;
+
+               case OperationType::Plus:
+                  result = manager.Xor(result, child);
+                  break;
+
+               default:
+                  assert(!"Unknown operation type");
+            }
+         }
+
+         built.emplace(expr.get(), result);
+         return result;
+      }
+
+      default:
+         assert(!"Unknown expression type");
+         return g_aig_false;
+   }
+}
+
+// Node !(p0 & p1) & !(!p0 & !p1) is the exclusive or of p0 and p1.
+bool GetXorOperands(const AigManager& manager, std::uint32_t node, TAigLiteral& left, TAigLiteral& right)
+{
+   const auto fanin0 = manager.GetFanin0(node);
+   const auto fanin1 = manager.GetFanin1(node);
+   if (!AigManager::IsComplemented(fanin0) || !AigManager::IsComplemented(fanin1) ||
+       !manager.IsAnd(AigManager::GetNode(fanin0)) || !manager.IsAnd(AigManager::GetNode(fanin1)))
+   {
+      return false;
+   }
+
+   const auto node0 = AigManager::GetNode(fanin0);
+   const auto node1 = AigManager::GetNode(fanin1);
+   const auto p0 = manager.GetFanin0(node0);
+   const auto p1 = manager.GetFanin1(node0);
+   const auto q0 = manager.GetFanin0(node1);
+   const auto q1 = manager.GetFanin1(node1);
+   if ((q0 == AigManager::Not(p0) && q1 == AigManager::Not(p1)) ||
+       (q0 == AigManager::Not(p1) && q1 == AigManager::Not(p0)))
+   {
+      left = p0;
+      right = p1;
+      return true;
+   }
+   return false;
+}
+
+TUniqueExpressionPtr BuildAigExpressionImpl(const AigManager& manager, TAigLiteral literal, TBuiltExpressionMap& built)
+{
+   auto& table = UniqueExpressionTable::GetInstance();
+
+   const auto node = AigManager::GetNode(literal);
+   const auto is_complemented = AigManager::IsComplemented(literal);
+   if (manager.IsConstant(node))
+   {
+      return table.MakeLiteral(is_complemented ? LiteralType::True : LiteralType::False);
+   }
+
+   if (manager.IsInput(node))
+   {
+      auto param_ref = table.MakeParamRef(manager.GetInputIndex(node));
+      if (!is_complemented)
+      {
+         return param_ref;
+      }
+      TUniqueExpressionPtrVector children(1, std::move(param_ref));
+      return table.MakeOperation(OperationType::Negation, std::move(children));
+   }
+
+   const auto iter = built.find(literal);
+   if (iter != built.end())
+   {
+      return iter->second;
+   }
+
+   // Complements of operands of exclusive or are moved to the operation.
+   TAigLiteral left;
+   TAigLiteral right;
+   auto operation = OperationType::None;
+   if (GetXorOperands(manager, node, left, right))
+   {
+      auto is_equality = is_complemented;
+      if (AigManager::IsComplemented(left))
+      {
+         left = AigManager::Not(left);
+         is_equality = !is_equality;
+      }
+      if (AigManager::IsComplemented(right))
+      {
+         right = AigManager::Not(right);
+         is_equality = !is_equality;
+      }
+      operation = is_equality ? OperationType::Equality : OperationType::Plus;
+   }
+   else if (is_complemented)
+   {
+      left = AigManager::Not(manager.GetFanin0(node));
+      right = AigManager::Not(manager.GetFanin1(node));
+      operation = OperationType::Disjunction;
+   }
+   else
+   {
+      left = manager.GetFanin0(node);
+      right = manager.GetFanin1(node);
+      operation = OperationType::Conjunction;
+   }
+
+   TUniqueExpressionPtrVector children;
+   children.push_back(BuildAigExpressionImpl(manager, left, built));
+   children.push_back(BuildAigExpressionImpl(manager, right, built));
+   auto result = table.MakeOperation(operation, std::move(children));
+
+   built.emplace(literal, result);
+   return result;
+}
+
+} // namespace
+
+TAigLiteral BuildAig(AigManager& manager, const TUniqueExpressionPtr& expr)
+{
+   assert(expr.get() != nullptr);
+
+   TBuiltAigMap built;
+   return BuildAigImpl(manager, expr, built);
+}
+
+TUniqueExpressionPtr BuildAigExpression(const AigManager& manager, TAigLiteral root)
+{
+   TBuiltExpressionMap built;
+   return BuildAigExpressionImpl(manager, root, built);
+}
+
+} // namespace dm
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "aig_manager.h"
+#include "../expressions/expression_unique_table.h"
+
+namespace dm
+{
+
+// Builds the graph of the hash-consed expression. Parameter with index i is
+// represented by the input i of the manager. Each distinct node is built once.
+TAigLiteral BuildAig(AigManager& manager, const TUniqueExpressionPtr& expr);
+
+// Builds the hash-consed expression of the graph, keeping its structure: AND nodes become
+// conjunctions, complemented ones become disjunctions of complemented fanins, and
+// exclusive or patterns, built by AigManager::Xor, become plus or equality.
+TUniqueExpressionPtr BuildAigExpression(const AigManager& manager, TAigLiteral root);
+
+} // namespace dm
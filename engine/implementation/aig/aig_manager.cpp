@@ -0,0 +1,177 @@
+#include "aig_manager.h"
+
+#include <algorithm>
+#include <utility>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+inline std::uint64_t MakeStrashKey(TAigLiteral fanin0, TAigLiteral fanin1)
+{
+   return (std::uint64_t(fanin0) << 32) | fanin1;
+}
+
+} // namespace
+
+AigManager::AigManager(long input_count) :
+   m_input_count(input_count), m_nodes(), m_strash_table()
+{
+   assert(input_count >= 0);
+
+   // Constant and inputs have no fanins.
+   m_nodes.resize(input_count + 1, Node{ g_aig_false, g_aig_false, 0 });
+}
+
+long AigManager::GetInputCount() const
+{
+   return m_input_count;
+}
+
+TAigLiteral AigManager::GetInput(long index) const
+{
+   assert(index >= 0 && index < m_input_count);
+   return MakeLiteral(static_cast<std::uint32_t>(index + 1), false);
+}
+
+TAigLiteral AigManager::And(TAigLiteral left, TAigLiteral right)
+{
+   if (left > right)
+   {
+      std::swap(left, right);
+   }
+
+   // Constant is the node 0, so it goes first.
+   if (g_aig_false == left || Not(left) == right)
+   {
+      return g_aig_false;
+   }
+   if (g_aig_true == left || left == right)
+   {
+      return right;
+   }
+
+   const auto key = MakeStrashKey(left, right);
+   const auto iter = m_strash_table.find(key);
+   if (iter != m_strash_table.end())
+   {
+      return MakeLiteral(iter->second, false);
+   }
+
+   const auto node = static_cast<std::uint32_t>(m_nodes.size());
+   const auto level = 1 + std::max(GetLevel(GetNode(left)), GetLevel(GetNode(right)));
+   m_nodes.push_back(Node{ left, right, level });
+   m_strash_table.emplace(key, node);
+   return MakeLiteral(node, false);
+}
+
+TAigLiteral AigManager::Or(TAigLiteral left, TAigLiteral right)
+{
+   return Not(And(Not(left), Not(right)));
+}
+
+TAigLiteral AigManager::Implication(TAigLiteral left, TAigLiteral right)
+{
+   return Not(And(left, Not(right)));
+}
+
+TAigLiteral AigManager::Xor(TAigLiteral left, TAigLiteral right)
+{
+   return Or(And(left, Not(right)), And(Not(left), right));
+}
+
+TAigLiteral AigManager::Not(TAigLiteral literal)
+{
+   return literal ^ 1;
+}
+
+bool AigManager::IsComplemented(TAigLiteral literal)
+{
+   return 0 != (literal & 1);
+}
+
+TAigLiteral AigManager::GetRegular(TAigLiteral literal)
+{
+   return literal & ~TAigLiteral(1);
+}
+
+std::uint32_t AigManager::GetNode(TAigLiteral literal)
+{
+   return literal >> 1;
+}
+
+TAigLiteral AigManager::MakeLiteral(std::uint32_t node, bool is_complemented)
+{
+   return (node << 1) | (is_complemented ? 1 : 0);
+}
+
+bool AigManager::IsConstant(std::uint32_t node) const
+{
+   return 0 == node;
+}
+
+bool AigManager::IsInput(std::uint32_t node) const
+{
+   return node > 0 && node <= static_cast<std::uint32_t>(m_input_count);
+}
+
+bool AigManager::IsAnd(std::uint32_t node) const
+{
+   return node > static_cast<std::uint32_t>(m_input_count);
+}
+
+long AigManager::GetInputIndex(std::uint32_t node) const
+{
+   assert(IsInput(node));
+   return static_cast<long>(node) - 1;
+}
+
+TAigLiteral AigManager::GetFanin0(std::uint32_t node) const
+{
+   assert(IsAnd(node));
+   return m_nodes[node].fanin0;
+}
+
+TAigLiteral AigManager::GetFanin1(std::uint32_t node) const
+{
+   assert(IsAnd(node));
+   return m_nodes[node].fanin1;
+}
+
+long AigManager::GetLevel(std::uint32_t node) const
+{
+   return m_nodes[node].level;
+}
+
+long AigManager::GetAndCount() const
+{
+   return static_cast<long>(m_nodes.size()) - m_input_count - 1;
+}
+
+long AigManager::GetAndCount(TAigLiteral root) const
+{
+   std::vector<bool> visited(m_nodes.size(), false);
+   std::vector<std::uint32_t> stack(1, GetNode(root));
+
+   auto count = 0L;
+   while (!stack.empty())
+   {
+      const auto node = stack.back();
+      stack.pop_back();
+      if (visited[node] || !IsAnd(node))
+      {
+         continue;
+      }
+
+      visited[node] = true;
+      ++count;
+      stack.push_back(GetNode(m_nodes[node].fanin0));
+      stack.push_back(GetNode(m_nodes[node].fanin1));
+   }
+   return count;
+}
+
+} // namespace dm
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "../common/noncopyable.h"
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace dm
+{
+
+// Literal of an and-inverter graph: index of the node, shifted left by one bit,
+// with the complement flag in the lowest bit.
+using TAigLiteral = std::uint32_t;
+
+const TAigLiteral g_aig_false = 0;
+const TAigLiteral g_aig_true = 1;
+
+// Manager of an and-inverter graph: node 0 is constant 0, nodes from 1 to input_count
+// are inputs, and the rest are two-input AND nodes, which are structurally hashed,
+// so there are no two nodes with the same fanins. Nodes are never removed.
+class AigManager : public NonCopyable
+{
+public:
+   AigManager(long input_count);
+
+   long GetInputCount() const;
+   TAigLiteral GetInput(long index) const;
+
+   // Constant and trivial operands are simplified: (x & 1) = x, (x & x) = x, (x & !x) = 0.
+   TAigLiteral And(TAigLiteral left, TAigLiteral right);
+   TAigLiteral Or(TAigLiteral left, TAigLiteral right);
+   TAigLiteral Implication(TAigLiteral left, TAigLiteral right);
+   // Exclusive or is built by three nodes: !(!(x & !y) & !(!x & y)).
+   TAigLiteral Xor(TAigLiteral left, TAigLiteral right);
+
+   static TAigLiteral Not(TAigLiteral literal);
+   static bool IsComplemented(TAigLiteral literal);
+   static TAigLiteral GetRegular(TAigLiteral literal);
+   static std::uint32_t GetNode(TAigLiteral literal);
+   static TAigLiteral MakeLiteral(std::uint32_t node, bool is_complemented);
+
+   bool IsConstant(std::uint32_t node) const;
+   bool IsInput(std::uint32_t node) const;
+   bool IsAnd(std::uint32_t node) const;
+   long GetInputIndex(std::uint32_t node) const;
+   TAigLiteral GetFanin0(std::uint32_t node) const;
+   TAigLiteral GetFanin1(std::uint32_t node) const;
+   // Length of the longest path from inputs to the node in AND nodes.
+   long GetLevel(std::uint32_t node) const;
+
+   // Amount of all AND nodes in the manager.
+   long GetAndCount() const;
+   // Amount of AND nodes, reachable from the root.
+   long GetAndCount(TAigLiteral root) const;
+
+private:
+   struct Node
+   {
+      TAigLiteral fanin0;
+      TAigLiteral fanin1;
+      long level;
+   };
+
+   using TStrashTable = std::unordered_map<std::uint64_t, std::uint32_t>;
+
+private:
+   long m_input_count;
+   std::vector<Node> m_nodes;
+   TStrashTable m_strash_table;
+};
+
+} // namespace dm
@@ -0,0 +1,430 @@
+#include "aig_rewriter.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+// Functions of cuts are truth tables of 4 variables.
+using TTruthTable = std::uint16_t;
+
+const long g_max_cut_size = 4;
+// Amount of cuts, kept for a node, except the trivial one.
+const size_t g_max_cut_count = 8;
+
+const long g_truth_table_size = 1 << g_max_cut_size;
+const TTruthTable g_truth_table_mask = 0xFFFF;
+const TTruthTable g_variable_truth_tables[g_max_cut_size] = { 0xAAAA, 0xCCCC, 0xF0F0, 0xFF00 };
+
+// Formulas of the library are searched up to this amount of AND nodes.
+const long g_max_formula_size = 10;
+const unsigned char g_unknown_formula_size = 0xFF;
+
+// Smallest AND-inverter formulas of all functions of 4 variables up to g_max_formula_size
+// nodes, built once on the first request. Formulas of each size are combined
+// from pairs of smaller ones, and inverters are free. Formulas of the largest sizes
+// are combined from millions of pairs, so the library is built in tens of milliseconds.
+class FormulaLibrary
+{
+public:
+   static const FormulaLibrary& GetInstance();
+
+   // Returns g_unknown_formula_size, if the formula is larger, than g_max_formula_size.
+   long GetSize(TTruthTable function) const;
+
+   // Builds the formula with the given literals of variables.
+   TAigLiteral Build(TTruthTable function, const TAigLiteral variables[], AigManager& manager) const;
+
+private:
+   FormulaLibrary();
+
+   // Function is (left & right) or its complement.
+   struct Formula
+   {
+      unsigned char size;
+      bool is_complemented;
+      TTruthTable left;
+      TTruthTable right;
+   };
+
+   void AddFormula(TTruthTable function, unsigned char size, TTruthTable left, TTruthTable right,
+                   std::vector<TTruthTable>& functions);
+
+private:
+   std::vector<Formula> m_formulas;
+};
+
+const FormulaLibrary& FormulaLibrary::GetInstance()
+{
+   static const FormulaLibrary library;
+   return library;
+}
+
+FormulaLibrary::FormulaLibrary() :
+   m_formulas(g_truth_table_mask + 1, Formula{ g_unknown_formula_size, false, 0, 0 })
+{
+   // functions_by_size[s] are functions with formulas of s nodes.
+   std::vector<std::vector<TTruthTable>> functions_by_size(g_max_formula_size + 1);
+
+   AddFormula(0, 0, 0, 0, functions_by_size[0]);
+   for (auto variable = 0L; variable < g_max_cut_size; ++variable)
+   {
+      const auto function = g_variable_truth_tables[variable];
+      AddFormula(function, 0, function, function, functions_by_size[0]);
+   }
+
+   for (auto size = 1L; size <= g_max_formula_size; ++size)
+   {
+      auto& functions = functions_by_size[size];
+      for (auto left_size = 0L; 2 * left_size <= size - 1; ++left_size)
+      {
+         const auto& left_functions = functions_by_size[left_size];
+         const auto& right_functions = functions_by_size[size - 1 - left_size];
+         for (auto left_index = size_t(0); left_index < left_functions.size(); ++left_index)
+         {
+            // Pairs of formulas of the same size are taken once.
+            const auto left = left_functions[left_index];
+            const auto first_right_index = (&left_functions == &right_functions) ? left_index : 0;
+            for (auto right_index = first_right_index; right_index < right_functions.size(); ++right_index)
+            {
+               const auto right = right_functions[right_index];
+               const auto function = static_cast<TTruthTable>(left & right);
+               if (g_unknown_formula_size == m_formulas[function].size)
+               {
+                  AddFormula(function, static_cast<unsigned char>(size), left, right, functions);
+               }
+            }
+         }
+      }
+   }
+}
+
+void FormulaLibrary::AddFormula(TTruthTable function, unsigned char size, TTruthTable left, TTruthTable right,
+                                std::vector<TTruthTable>& functions)
+{
+   const auto complement = static_cast<TTruthTable>(~function);
+   m_formulas[function] = Formula{ size, false, left, right };
+   m_formulas[complement] = Formula{ size, true, left, right };
+   functions.push_back(function);
+   functions.push_back(complement);
+}
+
+long FormulaLibrary::GetSize(TTruthTable function) const
+{
+   return m_formulas[function].size;
+}
+
+TAigLiteral FormulaLibrary::Build(TTruthTable function, const TAigLiteral variables[], AigManager& manager) const
+{
+   const auto& formula = m_formulas[function];
+   assert(formula.size != g_unknown_formula_size);
+
+   TAigLiteral result = g_aig_false;
+   if (0 == formula.size)
+   {
+      // Formulas of size 0 are constant 0 and variables, or their complements.
+      for (auto variable = 0L; variable < g_max_cut_size; ++variable)
+      {
+         if (formula.left == g_variable_truth_tables[variable])
+         {
+            result = variables[variable];
+         }
+      }
+   }
+   else
+   {
+      result = manager.And(Build(formula.left, variables, manager), Build(formula.right, variables, manager));
+   }
+   return formula.is_complemented ? AigManager::Not(result) : result;
+}
+
+// Leaves are sorted by nodes.
+struct Cut
+{
+   std::array<std::uint32_t, g_max_cut_size> leaves;
+   long size;
+   TTruthTable function;
+};
+
+// Merges leaves of cuts, returns false, if there are too many of them.
+bool MergeCutLeaves(const Cut& left, const Cut& right, Cut& result)
+{
+   auto left_index = 0L;
+   auto right_index = 0L;
+   result.size = 0;
+   while (left_index < left.size || right_index < right.size)
+   {
+      if (g_max_cut_size == result.size)
+      {
+         return false;
+      }
+
+      std::uint32_t leaf;
+      if (right_index == right.size ||
+          (left_index < left.size && left.leaves[left_index] < right.leaves[right_index]))
+      {
+         leaf = left.leaves[left_index++];
+      }
+      else if (left_index == left.size || right.leaves[right_index] < left.leaves[left_index])
+      {
+         leaf = right.leaves[right_index++];
+      }
+      else
+      {
+         leaf = left.leaves[left_index++];
+         ++right_index;
+      }
+      result.leaves[result.size++] = leaf;
+   }
+   return true;
+}
+
+// Returns the function of the cut over leaves of the larger cut, which contains them.
+TTruthTable ExpandFunction(const Cut& cut, const Cut& larger_cut)
+{
+   long positions[g_max_cut_size] = {};
+   for (auto index = 0L, larger_index = 0L; index < cut.size; ++index)
+   {
+      while (larger_cut.leaves[larger_index] != cut.leaves[index])
+      {
+         ++larger_index;
+      }
+      positions[index] = larger_index;
+   }
+
+   TTruthTable function = 0;
+   for (auto combination = 0L; combination < g_truth_table_size; ++combination)
+   {
+      auto cut_combination = 0L;
+      for (auto index = 0L; index < cut.size; ++index)
+      {
+         cut_combination |= ((combination >> positions[index]) & 1) << index;
+      }
+      if ((cut.function >> cut_combination) & 1)
+      {
+         function |= TTruthTable(1) << combination;
+      }
+   }
+   return function;
+}
+
+class Rewriter
+{
+public:
+   Rewriter(const AigManager& source, AigManager& target);
+
+   TAigLiteral Rewrite(TAigLiteral root);
+
+private:
+   void EnumerateCuts(std::uint32_t node);
+
+   // Amount of nodes, which are used only by the cone of the node over the cut.
+   // Reference counts are decremented in the cone and then restored.
+   long GetFreeConeSize(std::uint32_t node, const Cut& cut);
+   long Dereference(std::uint32_t node, const Cut& cut);
+   void Reference(std::uint32_t node, const Cut& cut);
+
+   TAigLiteral MapLiteral(TAigLiteral literal) const;
+
+private:
+   const AigManager& m_source;
+   AigManager& m_target;
+   const FormulaLibrary& m_library;
+   std::vector<long> m_reference_counts;
+   std::vector<std::vector<Cut>> m_cuts;
+   std::vector<TAigLiteral> m_mapped_literals;
+};
+
+Rewriter::Rewriter(const AigManager& source, AigManager& target) :
+   m_source(source), m_target(target), m_library(FormulaLibrary::GetInstance()),
+   m_reference_counts(), m_cuts(), m_mapped_literals()
+{
+   assert(source.GetInputCount() == target.GetInputCount());
+}
+
+TAigLiteral Rewriter::Rewrite(TAigLiteral root)
+{
+   const auto root_node = AigManager::GetNode(root);
+   const auto node_count = root_node + 1;
+   m_reference_counts.resize(node_count, 0);
+   m_cuts.resize(node_count);
+   m_mapped_literals.resize(node_count, g_aig_false);
+
+   // Nodes, which are not reachable from the root, have no references.
+   std::vector<bool> visited(node_count, false);
+   std::vector<std::uint32_t> stack(1, root_node);
+   ++m_reference_counts[root_node];
+   while (!stack.empty())
+   {
+      const auto node = stack.back();
+      stack.pop_back();
+      if (visited[node] || !m_source.IsAnd(node))
+      {
+         continue;
+      }
+
+      visited[node] = true;
+      for (const auto fanin : { m_source.GetFanin0(node), m_source.GetFanin1(node) })
+      {
+         ++m_reference_counts[AigManager::GetNode(fanin)];
+         stack.push_back(AigManager::GetNode(fanin));
+      }
+   }
+
+   // Fanins of AND nodes are created before them, so nodes go in topological order.
+   for (auto node = std::uint32_t(1); node < node_count; ++node)
+   {
+      if (m_source.IsInput(node))
+      {
+         m_mapped_literals[node] = m_target.GetInput(m_source.GetInputIndex(node));
+         m_cuts[node].push_back(Cut{ { node }, 1, g_variable_truth_tables[0] });
+         continue;
+      }
+      if (0 == m_reference_counts[node])
+      {
+         continue;
+      }
+
+      EnumerateCuts(node);
+
+      // The cut with the largest gain is chosen.
+      const Cut* best_cut = nullptr;
+      auto best_gain = 0L;
+      for (const auto& cut : m_cuts[node])
+      {
+         const auto formula_size = m_library.GetSize(cut.function);
+         if (g_unknown_formula_size == formula_size)
+         {
+            continue;
+         }
+
+         const auto gain = GetFreeConeSize(node, cut) - formula_size;
+         if (gain > best_gain)
+         {
+            best_gain = gain;
+            best_cut = &cut;
+         }
+      }
+
+      if (best_cut != nullptr)
+      {
+         // Variables, missing in the cut, don't affect its function.
+         TAigLiteral variables[g_max_cut_size] = { g_aig_false, g_aig_false, g_aig_false, g_aig_false };
+         for (auto index = 0L; index < best_cut->size; ++index)
+         {
+            variables[index] = m_mapped_literals[best_cut->leaves[index]];
+         }
+         m_mapped_literals[node] = m_library.Build(best_cut->function, variables, m_target);
+      }
+      else
+      {
+         m_mapped_literals[node] = m_target.And(MapLiteral(m_source.GetFanin0(node)),
+                                                MapLiteral(m_source.GetFanin1(node)));
+      }
+
+      // Trivial cut is added after rewriting, since it is used by fanouts only.
+      m_cuts[node].push_back(Cut{ { node }, 1, g_variable_truth_tables[0] });
+   }
+
+   return MapLiteral(root);
+}
+
+void Rewriter::EnumerateCuts(std::uint32_t node)
+{
+   const auto fanin0 = m_source.GetFanin0(node);
+   const auto fanin1 = m_source.GetFanin1(node);
+   const auto mask0 = AigManager::IsComplemented(fanin0) ? g_truth_table_mask : TTruthTable(0);
+   const auto mask1 = AigManager::IsComplemented(fanin1) ? g_truth_table_mask : TTruthTable(0);
+
+   auto& cuts = m_cuts[node];
+   for (const auto& cut0 : m_cuts[AigManager::GetNode(fanin0)])
+   {
+      for (const auto& cut1 : m_cuts[AigManager::GetNode(fanin1)])
+      {
+         Cut cut;
+         if (!MergeCutLeaves(cut0, cut1, cut))
+         {
+            continue;
+         }
+
+         const auto is_duplicate = std::any_of(cuts.begin(), cuts.end(), [&cut](const Cut& other)
+         {
+            return other.size == cut.size && std::equal(cut.leaves.begin(), cut.leaves.begin() + cut.size,
+                                                        other.leaves.begin());
+         });
+         if (!is_duplicate)
+         {
+            cut.function = static_cast<TTruthTable>((ExpandFunction(cut0, cut) ^ mask0) &
+                                                    (ExpandFunction(cut1, cut) ^ mask1));
+            cuts.push_back(cut);
+         }
+      }
+   }
+
+   // Cuts with less leaves are kept.
+   std::stable_sort(cuts.begin(), cuts.end(), [](const Cut& left, const Cut& right)
+   {
+      return left.size < right.size;
+   });
+   if (cuts.size() > g_max_cut_count)
+   {
+      cuts.resize(g_max_cut_count);
+   }
+}
+
+long Rewriter::GetFreeConeSize(std::uint32_t node, const Cut& cut)
+{
+   const auto size = Dereference(node, cut);
+   Reference(node, cut);
+   return size;
+}
+
+long Rewriter::Dereference(std::uint32_t node, const Cut& cut)
+{
+   auto size = 1L;
+   for (const auto fanin : { m_source.GetFanin0(node), m_source.GetFanin1(node) })
+   {
+      const auto fanin_node = AigManager::GetNode(fanin);
+      const auto is_leaf = std::find(cut.leaves.begin(), cut.leaves.begin() + cut.size, fanin_node) !=
+                           cut.leaves.begin() + cut.size;
+      if (!is_leaf && m_source.IsAnd(fanin_node) && 0 == --m_reference_counts[fanin_node])
+      {
+         size += Dereference(fanin_node, cut);
+      }
+   }
+   return size;
+}
+
+void Rewriter::Reference(std::uint32_t node, const Cut& cut)
+{
+   for (const auto fanin : { m_source.GetFanin0(node), m_source.GetFanin1(node) })
+   {
+      const auto fanin_node = AigManager::GetNode(fanin);
+      const auto is_leaf = std::find(cut.leaves.begin(), cut.leaves.begin() + cut.size, fanin_node) !=
+                           cut.leaves.begin() + cut.size;
+      if (!is_leaf && m_source.IsAnd(fanin_node) && 0 == m_reference_counts[fanin_node]++)
+      {
+         Reference(fanin_node, cut);
+      }
+   }
+}
+
+TAigLiteral Rewriter::MapLiteral(TAigLiteral literal) const
+{
+   const auto mapped = m_mapped_literals[AigManager::GetNode(literal)];
+   return AigManager::IsComplemented(literal) ? AigManager::Not(mapped) : mapped;
+}
+
+} // namespace
+
+TAigLiteral RewriteAig(const AigManager& source, TAigLiteral root, AigManager& target)
+{
+   return Rewriter(source, target).Rewrite(root);
+}
+
+} // namespace dm
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "aig_manager.h"
+
+namespace dm
+{
+
+// Rebuilds the graph of the root in the target manager with the same amount of inputs,
+// replacing cones of nodes by smaller implementations. For each AND node cuts with up
+// to 4 leaves are enumerated, and if the cone of the node over a cut, which isn't shared
+// with other nodes, has more nodes than the smallest AND-inverter formula of the cut
+// function, the formula is used instead of the cone.
+TAigLiteral RewriteAig(const AigManager& source, TAigLiteral root, AigManager& target);
+
+} // namespace dm
@@ -0,0 +1,96 @@
+#include "bdd_builder.h"
+
+#include <unordered_map>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+using TBuiltBddMap = std::unordered_map<const UniqueExpression*, Bdd>;
+
+Bdd BuildBddImpl(BddManager& manager, const TUniqueExpressionPtr& expr, TBuiltBddMap& built)
+{
+   switch (expr->GetType())
+   {
+      case ExpressionType::Literal:
+         return LiteralType::True == expr->GetLiteral() ?
+            manager.GetTrue() : manager.GetFalse();
+
+      case ExpressionType::ParamRef:
+         return manager.GetVariable(expr->GetParamIndex());
+
+      case ExpressionType::Operation:
+      {
+         const auto iter = built.find(expr.get());
+         if (iter != built.end())
+         {
+            return iter->second;
+         }
+
+         const auto operation = expr->GetOperation();
+         const auto child_count = expr->GetChildCount();
+
+         auto result = BuildBddImpl(manager, expr->GetChild(0), built);
+         if (OperationType::Negation == operation)
+         {
+            assert(1 == child_count);
+            result = manager.Not(result);
+            built.emplace(expr.get(), result);
+            return result;
+         }
+
+         // Operations are folded from left to right, like PerformOperation does.
+         for (auto index = 1L; index < child_count; ++index)
+         {
+            const auto child = BuildBddImpl(manager, expr->GetChild(index), built);
+            switch (operation)
+            {
+               case OperationType::Conjunction:
+                  result = manager.And(result, child);
+                  break;
+
+               case OperationType::Disjunction:
+                  result = manager.Or(result, child);
+                  break;
+
+               case OperationType::Implication:
+                  result = manager.Implication(result, child);
+                  break;
+
+               case OperationType::Equality:
+                  result = manager.Not(manager.Xor(result, child));
+                  break;
+
+               case OperationType::Plus:
+                  result = manager.Xor(result, child);
+                  break;
+
+               default:
+                  assert(!"Unknown operation type");
+            }
+         }
+
+         built.emplace(expr.get(), result);
+         return result;
+      }
+
+      default:
+         assert(!"Unknown expression type");
+         return manager.GetFalse();
+   }
+}
+
+} // namespace
+
+Bdd BuildBdd(BddManager& manager, const TUniqueExpressionPtr& expr)
+{
+   assert(expr.get() != nullptr);
+
+   TBuiltBddMap built;
+   return BuildBddImpl(manager, expr, built);
+}
+
+} // namespace dm
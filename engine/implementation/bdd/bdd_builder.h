@@ -0,0 +1,13 @@
+#pragma once
+
+#include "bdd_manager.h"
+#include "../expressions/expression_unique_table.h"
+
+namespace dm
+{
+
+// Builds the diagram of the hash-consed expression. Parameter with index i is
+// represented by the variable i of the manager. Each distinct node is built once.
+Bdd BuildBdd(BddManager& manager, const TUniqueExpressionPtr& expr);
+
+} // namespace dm
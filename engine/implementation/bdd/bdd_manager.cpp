@@ -0,0 +1,691 @@
+#include "bdd_manager.h"
+
+#include <algorithm>
+#include <utility>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+const TBddEdge g_true_edge = 0;
+const TBddEdge g_false_edge = 1;
+
+// Amount of entries in the computed table, must be a power of 2.
+const long g_cache_size = 1L << 18;
+
+// Garbage is collected at safe points, when there are more dead nodes.
+const long g_gc_threshold = 1L << 16;
+
+// Initial amount of nodes, that triggers automatic reordering.
+const long g_reordering_threshold = 1L << 12;
+
+// Sifting of a variable in a direction is stopped, when the total amount
+// of nodes exceeds the best one by this factor.
+const double g_max_sifting_growth = 1.2;
+
+inline bool IsComplemented(TBddEdge edge)
+{
+   return 0 != (edge & 1);
+}
+
+inline TBddEdge GetRegular(TBddEdge edge)
+{
+   return edge & ~TBddEdge(1);
+}
+
+inline std::uint32_t GetNodeIndex(TBddEdge edge)
+{
+   return edge >> 1;
+}
+
+inline TBddEdge MakeEdge(std::uint32_t index, bool is_complemented)
+{
+   return (index << 1) | (is_complemented ? 1 : 0);
+}
+
+inline std::uint64_t MakeUniqueKey(TBddEdge low, TBddEdge high)
+{
+   return (std::uint64_t(low) << 32) | high;
+}
+
+} // namespace
+
+Bdd::Bdd() : m_manager(nullptr), m_edge(g_true_edge)
+{
+}
+
+Bdd::Bdd(BddManager& manager, TBddEdge edge) : m_manager(&manager), m_edge(edge)
+{
+   m_manager->Reference(m_edge);
+}
+
+Bdd::Bdd(const Bdd& rhs) : m_manager(rhs.m_manager), m_edge(rhs.m_edge)
+{
+   if (m_manager != nullptr)
+   {
+      m_manager->Reference(m_edge);
+   }
+}
+
+Bdd& Bdd::operator=(const Bdd& rhs)
+{
+   if (rhs.m_manager != nullptr)
+   {
+      rhs.m_manager->Reference(rhs.m_edge);
+   }
+   if (m_manager != nullptr)
+   {
+      m_manager->Dereference(m_edge);
+   }
+
+   m_manager = rhs.m_manager;
+   m_edge = rhs.m_edge;
+   return *this;
+}
+
+Bdd::~Bdd()
+{
+   if (m_manager != nullptr)
+   {
+      m_manager->Dereference(m_edge);
+   }
+}
+
+TBddEdge Bdd::GetEdge() const
+{
+   return m_edge;
+}
+
+bool Bdd::operator==(const Bdd& rhs) const
+{
+   assert(m_manager == rhs.m_manager);
+   return m_edge == rhs.m_edge;
+}
+
+bool Bdd::operator!=(const Bdd& rhs) const
+{
+   return !(*this == rhs);
+}
+
+BddManager::BddManager(long variable_count) :
+   m_variable_count(variable_count), m_nodes(), m_free_nodes(), m_unique_tables(variable_count),
+   m_cache(g_cache_size), m_variable_to_level(variable_count), m_level_to_variable(variable_count),
+   m_node_count(0), m_dead_node_count(0),
+   m_is_automatic_reordering(true), m_reordering_threshold(g_reordering_threshold)
+{
+   assert(variable_count >= 0);
+
+   // Terminal node is placed below all variables and is never freed.
+   m_nodes.push_back({ variable_count, g_true_edge, g_true_edge, 1 });
+
+   for (auto variable = 0L; variable < variable_count; ++variable)
+   {
+      m_variable_to_level[variable] = variable;
+      m_level_to_variable[variable] = variable;
+   }
+
+   ClearCache();
+}
+
+long BddManager::GetVariableCount() const
+{
+   return m_variable_count;
+}
+
+Bdd BddManager::GetTrue()
+{
+   return Bdd(*this, g_true_edge);
+}
+
+Bdd BddManager::GetFalse()
+{
+   return Bdd(*this, g_false_edge);
+}
+
+Bdd BddManager::GetVariable(long variable)
+{
+   assert(variable >= 0 && variable < m_variable_count);
+
+   OnSafePoint();
+   return Bdd(*this, MakeNode(variable, g_false_edge, g_true_edge));
+}
+
+Bdd BddManager::Not(const Bdd& f)
+{
+   return Bdd(*this, f.GetEdge() ^ 1);
+}
+
+Bdd BddManager::And(const Bdd& f, const Bdd& g)
+{
+   OnSafePoint();
+   return Bdd(*this, IteRecursive(f.GetEdge(), g.GetEdge(), g_false_edge));
+}
+
+Bdd BddManager::Or(const Bdd& f, const Bdd& g)
+{
+   OnSafePoint();
+   return Bdd(*this, IteRecursive(f.GetEdge(), g_true_edge, g.GetEdge()));
+}
+
+Bdd BddManager::Xor(const Bdd& f, const Bdd& g)
+{
+   OnSafePoint();
+   return Bdd(*this, IteRecursive(f.GetEdge(), g.GetEdge() ^ 1, g.GetEdge()));
+}
+
+Bdd BddManager::Implication(const Bdd& f, const Bdd& g)
+{
+   OnSafePoint();
+   return Bdd(*this, IteRecursive(f.GetEdge(), g.GetEdge(), g_true_edge));
+}
+
+Bdd BddManager::Ite(const Bdd& f, const Bdd& g, const Bdd& h)
+{
+   OnSafePoint();
+   return Bdd(*this, IteRecursive(f.GetEdge(), g.GetEdge(), h.GetEdge()));
+}
+
+Bdd BddManager::Cofactor(const Bdd& f, long variable, bool value)
+{
+   assert(variable >= 0 && variable < m_variable_count);
+
+   OnSafePoint();
+   return Bdd(*this, CofactorRecursive(f.GetEdge(), variable, value));
+}
+
+long BddManager::GetNodeCount(const Bdd& f) const
+{
+   std::vector<bool> visited(m_nodes.size(), false);
+   std::vector<std::uint32_t> stack(1, GetNodeIndex(f.GetEdge()));
+   auto count = 0L;
+
+   while (!stack.empty())
+   {
+      const auto index = stack.back();
+      stack.pop_back();
+
+      if (visited[index])
+      {
+         continue;
+      }
+      visited[index] = true;
+      ++count;
+
+      if (0 != index)
+      {
+         stack.push_back(GetNodeIndex(m_nodes[index].low));
+         stack.push_back(GetNodeIndex(m_nodes[index].high));
+      }
+   }
+
+   return count;
+}
+
+long BddManager::GetLiveNodeCount() const
+{
+   return m_node_count - m_dead_node_count;
+}
+
+std::vector<long> BddManager::GetVariableOrder() const
+{
+   return m_level_to_variable;
+}
+
+void BddManager::CollectGarbage()
+{
+   if (0 != m_dead_node_count)
+   {
+      const auto node_count = static_cast<std::uint32_t>(m_nodes.size());
+      for (auto index = std::uint32_t(1); index < node_count; ++index)
+      {
+         // Free nodes are marked by the negative reference counter.
+         if (0 == m_nodes[index].ref_count)
+         {
+            FreeNode(index);
+         }
+      }
+
+      assert(0 == m_dead_node_count);
+   }
+
+   // Results of freed nodes could be cached.
+   ClearCache();
+}
+
+void BddManager::ReorderVariables()
+{
+   CollectGarbage();
+
+   // Variables with more nodes are sifted first, since they affect the size most.
+   std::vector<long> variables(m_variable_count);
+   for (auto variable = 0L; variable < m_variable_count; ++variable)
+   {
+      variables[variable] = variable;
+   }
+   std::stable_sort(variables.begin(), variables.end(), [this](long variable1, long variable2)
+   {
+      return m_unique_tables[variable1].size() > m_unique_tables[variable2].size();
+   });
+
+   for (auto variable : variables)
+   {
+      SiftVariable(variable);
+   }
+
+   // Cached results are still correct, but they are expressed in terms of
+   // nodes, that could be freed during reordering.
+   ClearCache();
+}
+
+void BddManager::EnableAutomaticReordering(bool enable)
+{
+   m_is_automatic_reordering = enable;
+}
+
+void BddManager::OnSafePoint()
+{
+   if (m_dead_node_count > g_gc_threshold && m_dead_node_count * 2 > m_node_count)
+   {
+      CollectGarbage();
+   }
+
+   if (m_is_automatic_reordering && GetLiveNodeCount() > m_reordering_threshold)
+   {
+      ReorderVariables();
+      m_reordering_threshold = std::max(m_reordering_threshold, 2 * m_node_count);
+   }
+}
+
+TBddEdge BddManager::IteRecursive(TBddEdge f, TBddEdge g, TBddEdge h)
+{
+   // Standard triples: constant and repeated arguments are eliminated.
+   if (g_true_edge == f)
+   {
+      return g;
+   }
+   if (g_false_edge == f)
+   {
+      return h;
+   }
+   if (f == g)
+   {
+      g = g_true_edge;
+   }
+   else if (f == (g ^ 1))
+   {
+      g = g_false_edge;
+   }
+   if (f == h)
+   {
+      h = g_false_edge;
+   }
+   else if (f == (h ^ 1))
+   {
+      h = g_true_edge;
+   }
+   if (g == h)
+   {
+      return g;
+   }
+   if (g_true_edge == g && g_false_edge == h)
+   {
+      return f;
+   }
+   if (g_false_edge == g && g_true_edge == h)
+   {
+      return f ^ 1;
+   }
+
+   // Ite(!f, g, h) = Ite(f, h, g) and Ite(f, !g, !h) = !Ite(f, g, h),
+   // so only triples with regular f and g are cached.
+   if (IsComplemented(f))
+   {
+      f ^= 1;
+      std::swap(g, h);
+   }
+   TBddEdge complement = 0;
+   if (IsComplemented(g))
+   {
+      g ^= 1;
+      h ^= 1;
+      complement = 1;
+   }
+
+   TBddEdge result;
+   if (FindInCache(CacheOperation::Ite, f, g, h, result))
+   {
+      return result ^ complement;
+   }
+
+   const auto level = std::min(GetLevel(f), std::min(GetLevel(g), GetLevel(h)));
+   const auto variable = m_level_to_variable[level];
+
+   TBddEdge f0, f1, g0, g1, h0, h1;
+   GetCofactors(f, variable, f0, f1);
+   GetCofactors(g, variable, g0, g1);
+   GetCofactors(h, variable, h0, h1);
+
+   const auto high = IteRecursive(f1, g1, h1);
+   const auto low = IteRecursive(f0, g0, h0);
+   result = MakeNode(variable, low, high);
+
+   AddToCache(CacheOperation::Ite, f, g, h, result);
+   return result ^ complement;
+}
+
+TBddEdge BddManager::CofactorRecursive(TBddEdge f, long variable, bool value)
+{
+   if (GetLevel(f) > m_variable_to_level[variable])
+   {
+      return f;
+   }
+
+   TBddEdge f0, f1;
+   if (GetEdgeVariable(f) == variable)
+   {
+      GetCofactors(f, variable, f0, f1);
+      return value ? f1 : f0;
+   }
+
+   // Cofactor of the complement is the complement of the cofactor.
+   const auto complement = f & 1;
+   f ^= complement;
+
+   const auto argument = MakeEdge(variable, value);
+   TBddEdge result;
+   if (FindInCache(CacheOperation::Cofactor, f, argument, 0, result))
+   {
+      return result ^ complement;
+   }
+
+   const auto node_variable = GetEdgeVariable(f);
+   GetCofactors(f, node_variable, f0, f1);
+
+   const auto high = CofactorRecursive(f1, variable, value);
+   const auto low = CofactorRecursive(f0, variable, value);
+   result = MakeNode(node_variable, low, high);
+
+   AddToCache(CacheOperation::Cofactor, f, argument, 0, result);
+   return result ^ complement;
+}
+
+TBddEdge BddManager::MakeNode(long variable, TBddEdge low, TBddEdge high)
+{
+   if (low == high)
+   {
+      return low;
+   }
+
+   // High edge of the node must be regular, so the complement is moved
+   // to the incoming edge.
+   const auto is_complemented = IsComplemented(high);
+   if (is_complemented)
+   {
+      low ^= 1;
+      high ^= 1;
+   }
+
+   auto& unique_table = m_unique_tables[variable];
+   const auto key = MakeUniqueKey(low, high);
+   const auto iter = unique_table.find(key);
+   if (iter != unique_table.end())
+   {
+      return MakeEdge(iter->second, is_complemented);
+   }
+
+   std::uint32_t index;
+   if (m_free_nodes.empty())
+   {
+      index = static_cast<std::uint32_t>(m_nodes.size());
+      m_nodes.push_back({ variable, low, high, 0 });
+   }
+   else
+   {
+      index = m_free_nodes.back();
+      m_free_nodes.pop_back();
+      m_nodes[index] = { variable, low, high, 0 };
+   }
+
+   unique_table.emplace(key, index);
+   ++m_node_count;
+   ++m_dead_node_count;
+
+   Reference(low);
+   Reference(high);
+
+   return MakeEdge(index, is_complemented);
+}
+
+void BddManager::FreeNode(std::uint32_t index)
+{
+   std::vector<std::uint32_t> dead_nodes(1, index);
+
+   while (!dead_nodes.empty())
+   {
+      const auto dead_index = dead_nodes.back();
+      dead_nodes.pop_back();
+
+      auto& node = m_nodes[dead_index];
+      assert(0 == node.ref_count);
+
+      m_unique_tables[node.variable].erase(MakeUniqueKey(node.low, node.high));
+      node.ref_count = -1;
+      m_free_nodes.push_back(dead_index);
+      --m_node_count;
+      --m_dead_node_count;
+
+      for (auto child : { node.low, node.high })
+      {
+         const auto child_index = GetNodeIndex(child);
+         if (0 != child_index)
+         {
+            Dereference(child);
+            if (0 == m_nodes[child_index].ref_count)
+            {
+               dead_nodes.push_back(child_index);
+            }
+         }
+      }
+   }
+}
+
+void BddManager::Reference(TBddEdge edge)
+{
+   const auto index = GetNodeIndex(edge);
+   if (0 != index && 0 == m_nodes[index].ref_count++)
+   {
+      --m_dead_node_count;
+   }
+}
+
+void BddManager::Dereference(TBddEdge edge)
+{
+   const auto index = GetNodeIndex(edge);
+   if (0 != index)
+   {
+      assert(m_nodes[index].ref_count > 0);
+      if (0 == --m_nodes[index].ref_count)
+      {
+         ++m_dead_node_count;
+      }
+   }
+}
+
+void BddManager::DereferenceAndFree(TBddEdge edge)
+{
+   Dereference(edge);
+
+   const auto index = GetNodeIndex(edge);
+   if (0 != index && 0 == m_nodes[index].ref_count)
+   {
+      FreeNode(index);
+   }
+}
+
+long BddManager::GetLevel(TBddEdge edge) const
+{
+   const auto index = GetNodeIndex(edge);
+   return 0 == index ? m_variable_count : m_variable_to_level[m_nodes[index].variable];
+}
+
+long BddManager::GetEdgeVariable(TBddEdge edge) const
+{
+   return m_nodes[GetNodeIndex(edge)].variable;
+}
+
+void BddManager::GetCofactors(TBddEdge edge, long variable, TBddEdge& low, TBddEdge& high) const
+{
+   const auto& node = m_nodes[GetNodeIndex(edge)];
+   if (node.variable != variable || 0 == GetNodeIndex(edge))
+   {
+      low = edge;
+      high = edge;
+   }
+   else
+   {
+      const auto complement = edge & 1;
+      low = node.low ^ complement;
+      high = node.high ^ complement;
+   }
+}
+
+bool BddManager::FindInCache(CacheOperation operation, TBddEdge f, TBddEdge g, TBddEdge h,
+                             TBddEdge& result) const
+{
+   const auto hash = (f * 12582917u) ^ (g * 4256249u) ^ (h * 741457u) ^ static_cast<unsigned>(operation);
+   const auto& entry = m_cache[hash & (g_cache_size - 1)];
+
+   if (entry.operation == operation && entry.f == f && entry.g == g && entry.h == h)
+   {
+      result = entry.result;
+      return true;
+   }
+
+   return false;
+}
+
+void BddManager::AddToCache(CacheOperation operation, TBddEdge f, TBddEdge g, TBddEdge h, TBddEdge result)
+{
+   const auto hash = (f * 12582917u) ^ (g * 4256249u) ^ (h * 741457u) ^ static_cast<unsigned>(operation);
+   m_cache[hash & (g_cache_size - 1)] = { operation, f, g, h, result };
+}
+
+void BddManager::ClearCache()
+{
+   std::fill(m_cache.begin(), m_cache.end(), CacheEntry{ CacheOperation::None, 0, 0, 0, 0 });
+}
+
+void BddManager::SwapLevels(long level)
+{
+   assert(level >= 0 && level + 1 < m_variable_count);
+
+   const auto upper_variable = m_level_to_variable[level];
+   const auto lower_variable = m_level_to_variable[level + 1];
+
+   // Nodes of the upper variable may be added to its table, so it is copied.
+   std::vector<std::uint32_t> upper_nodes;
+   upper_nodes.reserve(m_unique_tables[upper_variable].size());
+   for (const auto& entry : m_unique_tables[upper_variable])
+   {
+      upper_nodes.push_back(entry.second);
+   }
+
+   for (auto index : upper_nodes)
+   {
+      const auto low = m_nodes[index].low;
+      const auto high = m_nodes[index].high;
+
+      // Nodes, that don't depend on the lower variable, just move down a level.
+      if (GetEdgeVariable(low) != lower_variable && GetEdgeVariable(high) != lower_variable)
+      {
+         continue;
+      }
+
+      TBddEdge f00, f01, f10, f11;
+      GetCofactors(low, lower_variable, f00, f01);
+      GetCofactors(high, lower_variable, f10, f11);
+
+      // The node keeps its index, so edges to it stay valid. Its high edge
+      // remains regular, since f11 is regular.
+      const auto new_high = MakeNode(upper_variable, f01, f11);
+      Reference(new_high);
+      const auto new_low = MakeNode(upper_variable, f00, f10);
+      Reference(new_low);
+
+      m_unique_tables[upper_variable].erase(MakeUniqueKey(low, high));
+      m_nodes[index].variable = lower_variable;
+      m_nodes[index].low = new_low;
+      m_nodes[index].high = new_high;
+      m_unique_tables[lower_variable].emplace(MakeUniqueKey(new_low, new_high), index);
+
+      DereferenceAndFree(low);
+      DereferenceAndFree(high);
+   }
+
+   m_level_to_variable[level] = lower_variable;
+   m_level_to_variable[level + 1] = upper_variable;
+   m_variable_to_level[lower_variable] = level;
+   m_variable_to_level[upper_variable] = level + 1;
+}
+
+void BddManager::SiftVariable(long variable)
+{
+   auto level = m_variable_to_level[variable];
+   auto best_level = level;
+   auto best_count = m_node_count;
+
+   // The variable is moved to the closer end first.
+   const auto is_down_first = (m_variable_count - 1 - level) < level;
+
+   for (auto pass = 0; pass < 2; ++pass)
+   {
+      if (is_down_first == (0 == pass))
+      {
+         while (level + 1 < m_variable_count)
+         {
+            SwapLevels(level++);
+            if (m_node_count < best_count)
+            {
+               best_count = m_node_count;
+               best_level = level;
+            }
+            else if (m_node_count > best_count * g_max_sifting_growth)
+            {
+               break;
+            }
+         }
+      }
+      else
+      {
+         while (level > 0)
+         {
+            SwapLevels(--level);
+            if (m_node_count < best_count)
+            {
+               best_count = m_node_count;
+               best_level = level;
+            }
+            else if (m_node_count > best_count * g_max_sifting_growth)
+            {
+               break;
+            }
+         }
+      }
+   }
+
+   while (level < best_level)
+   {
+      SwapLevels(level++);
+   }
+   while (level > best_level)
+   {
+      SwapLevels(--level);
+   }
+
+   assert(m_node_count == best_count);
+}
+
+} // namespace dm
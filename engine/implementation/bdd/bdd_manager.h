@@ -0,0 +1,150 @@
+#pragma once
+
+#include "../common/noncopyable.h"
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace dm
+{
+
+class BddManager;
+
+// Edge of a diagram: index of the target node, shifted left by one bit,
+// with the complement flag in the lowest bit.
+using TBddEdge = std::uint32_t;
+
+// Reference to a root of a diagram. Nodes, reachable from existing
+// references, survive garbage collections and variable reordering.
+class Bdd
+{
+public:
+   Bdd();
+   Bdd(BddManager& manager, TBddEdge edge);
+   Bdd(const Bdd& rhs);
+   Bdd& operator=(const Bdd& rhs);
+   ~Bdd();
+
+   TBddEdge GetEdge() const;
+
+   // As diagrams are canonical, equal functions are represented by equal edges.
+   bool operator==(const Bdd& rhs) const;
+   bool operator!=(const Bdd& rhs) const;
+
+private:
+   BddManager* m_manager;
+   TBddEdge m_edge;
+};
+
+// Manager of reduced ordered binary decision diagrams with complemented edges.
+// Terminal node represents constant 1, and constant 0 is its complement.
+// To keep representation canonical, high edges of nodes are never complemented.
+class BddManager : public NonCopyable
+{
+public:
+   BddManager(long variable_count);
+
+   long GetVariableCount() const;
+
+   Bdd GetTrue();
+   Bdd GetFalse();
+   Bdd GetVariable(long variable);
+
+   Bdd Not(const Bdd& f);
+   Bdd And(const Bdd& f, const Bdd& g);
+   Bdd Or(const Bdd& f, const Bdd& g);
+   Bdd Xor(const Bdd& f, const Bdd& g);
+   Bdd Implication(const Bdd& f, const Bdd& g);
+   // If-then-else: (f & g) | (!f & h).
+   Bdd Ite(const Bdd& f, const Bdd& g, const Bdd& h);
+   // Substitutes the variable with a constant value.
+   Bdd Cofactor(const Bdd& f, long variable, bool value);
+
+   // Amount of nodes, reachable from the root, including the terminal one.
+   long GetNodeCount(const Bdd& f) const;
+   // Amount of nodes that are referenced by other nodes or by roots.
+   long GetLiveNodeCount() const;
+
+   // Returns variables, ordered from the top level to the bottom one.
+   std::vector<long> GetVariableOrder() const;
+
+   // Frees all nodes that are not reachable from any root.
+   void CollectGarbage();
+   // Reorders variables by sifting to minimize the total amount of nodes.
+   void ReorderVariables();
+   // Reordering is performed automatically when the amount of nodes exceeds the threshold.
+   void EnableAutomaticReordering(bool enable);
+
+private:
+   friend class Bdd;
+
+   struct Node
+   {
+      long variable;
+      TBddEdge low;
+      TBddEdge high;
+      long ref_count;
+   };
+
+   enum class CacheOperation : unsigned char
+   {
+      None, Ite, Cofactor
+   };
+
+   struct CacheEntry
+   {
+      CacheOperation operation;
+      TBddEdge f;
+      TBddEdge g;
+      TBddEdge h;
+      TBddEdge result;
+   };
+
+   using TUniqueTable = std::unordered_map<std::uint64_t, std::uint32_t>;
+
+   // Safe point is the place where all alive nodes are reachable from roots.
+   void OnSafePoint();
+
+   TBddEdge IteRecursive(TBddEdge f, TBddEdge g, TBddEdge h);
+   TBddEdge CofactorRecursive(TBddEdge f, long variable, bool value);
+
+   TBddEdge MakeNode(long variable, TBddEdge low, TBddEdge high);
+   void FreeNode(std::uint32_t index);
+
+   void Reference(TBddEdge edge);
+   void Dereference(TBddEdge edge);
+   // Dereferences the edge and frees the node (with its descendants) if it becomes dead.
+   void DereferenceAndFree(TBddEdge edge);
+
+   long GetLevel(TBddEdge edge) const;
+   long GetEdgeVariable(TBddEdge edge) const;
+   void GetCofactors(TBddEdge edge, long variable, TBddEdge& low, TBddEdge& high) const;
+
+   bool FindInCache(CacheOperation operation, TBddEdge f, TBddEdge g, TBddEdge h, TBddEdge& result) const;
+   void AddToCache(CacheOperation operation, TBddEdge f, TBddEdge g, TBddEdge h, TBddEdge result);
+   void ClearCache();
+
+   // Swaps variables at levels level and level + 1.
+   void SwapLevels(long level);
+   void SiftVariable(long variable);
+
+private:
+   long m_variable_count;
+   std::vector<Node> m_nodes;
+   std::vector<std::uint32_t> m_free_nodes;
+   // Unique tables are separated by variables to make level swapping local.
+   std::vector<TUniqueTable> m_unique_tables;
+   std::vector<CacheEntry> m_cache;
+
+   std::vector<long> m_variable_to_level;
+   std::vector<long> m_level_to_variable;
+
+   long m_node_count;
+   long m_dead_node_count;
+
+   bool m_is_automatic_reordering;
+   long m_reordering_threshold;
+};
+
+} // namespace dm
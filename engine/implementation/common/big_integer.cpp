@@ -0,0 +1,172 @@
+#include "big_integer.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+const long g_digit_bit_count = 32;
+
+} // namespace
+
+BigInteger::BigInteger(std::uint64_t value) : m_digits()
+{
+   for (; value != 0; value >>= g_digit_bit_count)
+   {
+      m_digits.push_back(static_cast<std::uint32_t>(value));
+   }
+}
+
+bool BigInteger::IsZero() const
+{
+   return m_digits.empty();
+}
+
+BigInteger& BigInteger::operator+=(const BigInteger& rhs)
+{
+   if (m_digits.size() < rhs.m_digits.size())
+   {
+      m_digits.resize(rhs.m_digits.size(), 0);
+   }
+
+   std::uint64_t carry = 0;
+   for (auto index = 0U; index < m_digits.size(); ++index)
+   {
+      if (index >= rhs.m_digits.size() && 0 == carry)
+      {
+         break;
+      }
+      carry += m_digits[index];
+      if (index < rhs.m_digits.size())
+      {
+         carry += rhs.m_digits[index];
+      }
+      m_digits[index] = static_cast<std::uint32_t>(carry);
+      carry >>= g_digit_bit_count;
+   }
+
+   if (carry != 0)
+   {
+      m_digits.push_back(static_cast<std::uint32_t>(carry));
+   }
+
+   return *this;
+}
+
+BigInteger& BigInteger::operator*=(const BigInteger& rhs)
+{
+   if (IsZero() || rhs.IsZero())
+   {
+      m_digits.clear();
+      return *this;
+   }
+
+   std::vector<std::uint32_t> product(m_digits.size() + rhs.m_digits.size(), 0);
+   for (auto index1 = 0U; index1 < m_digits.size(); ++index1)
+   {
+      std::uint64_t carry = 0;
+      for (auto index2 = 0U; index2 < rhs.m_digits.size(); ++index2)
+      {
+         carry += static_cast<std::uint64_t>(m_digits[index1]) * rhs.m_digits[index2] + product[index1 + index2];
+         product[index1 + index2] = static_cast<std::uint32_t>(carry);
+         carry >>= g_digit_bit_count;
+      }
+      product[index1 + rhs.m_digits.size()] = static_cast<std::uint32_t>(carry);
+   }
+
+   m_digits = std::move(product);
+   RemoveLeadingZeros();
+   return *this;
+}
+
+BigInteger& BigInteger::ShiftLeft(long power)
+{
+   assert(power >= 0);
+   if (IsZero())
+   {
+      return *this;
+   }
+
+   const auto digit_shift = power / g_digit_bit_count;
+   const auto bit_shift = power % g_digit_bit_count;
+
+   if (bit_shift != 0)
+   {
+      std::uint32_t carry = 0;
+      for (auto& digit : m_digits)
+      {
+         const auto shifted_out = digit >> (g_digit_bit_count - bit_shift);
+         digit = (digit << bit_shift) | carry;
+         carry = shifted_out;
+      }
+      if (carry != 0)
+      {
+         m_digits.push_back(carry);
+      }
+   }
+
+   m_digits.insert(m_digits.begin(), digit_shift, 0);
+   return *this;
+}
+
+std::string BigInteger::ToString() const
+{
+   if (IsZero())
+   {
+      return "0";
+   }
+
+   // Digits are divided by 10^9, and remainders give decimal digits in groups of nine.
+   const std::uint32_t decimal_base = 1000000000;
+   const long decimal_group_size = 9;
+
+   auto digits = m_digits;
+   std::string result;
+   while (!digits.empty())
+   {
+      std::uint64_t remainder = 0;
+      for (auto index = digits.size(); index-- > 0;)
+      {
+         remainder = (remainder << g_digit_bit_count) | digits[index];
+         digits[index] = static_cast<std::uint32_t>(remainder / decimal_base);
+         remainder %= decimal_base;
+      }
+      while (!digits.empty() && 0 == digits.back())
+      {
+         digits.pop_back();
+      }
+
+      for (auto index = 0L; index < decimal_group_size && (remainder != 0 || !digits.empty()); ++index)
+      {
+         result += static_cast<char>('0' + remainder % 10);
+         remainder /= 10;
+      }
+   }
+
+   std::reverse(result.begin(), result.end());
+   return result;
+}
+
+void BigInteger::RemoveLeadingZeros()
+{
+   while (!m_digits.empty() && 0 == m_digits.back())
+   {
+      m_digits.pop_back();
+   }
+}
+
+BigInteger operator+(BigInteger lhs, const BigInteger& rhs)
+{
+   return lhs += rhs;
+}
+
+BigInteger operator*(BigInteger lhs, const BigInteger& rhs)
+{
+   return lhs *= rhs;
+}
+
+} // namespace dm
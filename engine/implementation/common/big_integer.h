@@ -0,0 +1,37 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace dm
+{
+
+// Non-negative integer of arbitrary size. It's enough to hold amounts
+// of parameter combinations for any number of parameters.
+class BigInteger
+{
+public:
+   BigInteger(std::uint64_t value = 0);
+
+   bool IsZero() const;
+
+   BigInteger& operator+=(const BigInteger& rhs);
+   BigInteger& operator*=(const BigInteger& rhs);
+   // Multiplies by 2 raised to the power.
+   BigInteger& ShiftLeft(long power);
+
+   std::string ToString() const;
+
+private:
+   void RemoveLeadingZeros();
+
+private:
+   // Digits in base 2^32, starting from the lowest one. Zero has no digits.
+   std::vector<std::uint32_t> m_digits;
+};
+
+BigInteger operator+(BigInteger lhs, const BigInteger& rhs);
+BigInteger operator*(BigInteger lhs, const BigInteger& rhs);
+
+} // namespace dm
@@ -1,10 +1,40 @@
 #include "combinations.h"
 
 #include <algorithm>
+#include <cassert>
 
 namespace dm
 {
 
+namespace
+{
+
+// Amount of parameters that vary inside a single block.
+const long g_block_dimension = g_bit_block_dimension;
+
+static_assert((1L << g_block_dimension) == g_bit_block_size,
+              "Block dimension doesn't correspond to the bit block size.");
+
+// Values of parameters that vary inside a block. Element with index p describes the
+// parameter that is p-th bit (counting from the lowest one) of a combination number.
+const TBitBlock g_low_parameter_patterns[g_block_dimension] =
+{
+   0xAAAAAAAAAAAAAAAAull,
+   0xCCCCCCCCCCCCCCCCull,
+   0xF0F0F0F0F0F0F0F0ull,
+   0xFF00FF00FF00FF00ull,
+   0xFFFF0000FFFF0000ull,
+   0xFFFFFFFF00000000ull
+};
+
+} // namespace
+
+TBitBlock GetBitBlockPattern(long bit)
+{
+   assert(bit >= 0 && bit < g_block_dimension);
+   return g_low_parameter_patterns[bit];
+}
+
 CombinationGenerator::CombinationGenerator(long dimension) :
    m_dimension(dimension), m_combination()
 {
@@ -44,4 +74,125 @@ const LiteralType* CombinationGenerator::GenerateNext()
    return m_combination.get() + 1;
 }
 
-} // namespace dm
+BitCombinationGenerator::BitCombinationGenerator(long dimension, bool is_gray_code) :
+   m_dimension(dimension), m_is_gray_code(is_gray_code), m_block_index(0), m_block_count(1),
+   m_block_from(0), m_block_to(0), m_step(0), m_changed_index(-1), m_combination()
+{
+   assert(dimension >= 0);
+
+   if (m_dimension > g_block_dimension)
+   {
+      m_block_count <<= (m_dimension - g_block_dimension);
+   }
+
+   m_block_to = m_block_count;
+}
+
+long BitCombinationGenerator::GetBlockCombinationCount() const
+{
+   return (m_dimension < g_block_dimension) ? (1L << m_dimension) : g_bit_block_size;
+}
+
+TBitBlock BitCombinationGenerator::GetBlockMask() const
+{
+   const auto count = GetBlockCombinationCount();
+   return (count == g_bit_block_size) ?
+      g_bit_block_true : ((TBitBlock(1) << count) - 1);
+}
+
+long long BitCombinationGenerator::GetBlockCount() const
+{
+   return m_block_count;
+}
+
+void BitCombinationGenerator::SetBlockRange(long long block_from, long long block_to)
+{
+   assert(block_from >= 0 && block_from <= block_to && block_to <= m_block_count);
+   assert(!m_is_gray_code ||
+          (0 == ((block_to - block_from) & (block_to - block_from - 1)) &&
+           0 == (block_from & (block_to - block_from - 1))));
+   m_block_from = block_from;
+   m_block_to = block_to;
+}
+
+long long BitCombinationGenerator::GetBlockIndex() const
+{
+   return m_block_index;
+}
+
+long BitCombinationGenerator::GetChangedIndex() const
+{
+   return m_changed_index;
+}
+
+const TBitBlock* BitCombinationGenerator::GenerateFirst()
+{
+   if (m_block_from == m_block_to)
+   {
+      return nullptr;
+   }
+
+   if (m_combination.get() == nullptr)
+   {
+      // Additional element allows to return valid pointer for zero dimension.
+      m_combination = std::make_unique<TBitBlock[]>(m_dimension + 1);
+   }
+
+   // Combination number is treated as binary number where 0-th parameter is
+   // the highest bit, so the last parameters vary inside the block.
+   for (auto bit = 0L; bit < g_block_dimension && bit < m_dimension; ++bit)
+   {
+      m_combination[m_dimension - 1 - bit] = g_low_parameter_patterns[bit];
+   }
+
+   m_block_index = m_block_from;
+   m_step = 0;
+   m_changed_index = -1;
+   FillHighParameters();
+
+   return m_combination.get();
+}
+
+const TBitBlock* BitCombinationGenerator::GenerateNext()
+{
+   if (!m_is_gray_code)
+   {
+      if (++m_block_index >= m_block_to)
+      {
+         return nullptr;
+      }
+
+      FillHighParameters();
+
+      return m_combination.get();
+   }
+
+   if (++m_step >= m_block_to - m_block_from)
+   {
+      return nullptr;
+   }
+
+   // Reflected binary code: the next code differs from the previous one
+   // by the bit, that is the lowest set bit of the step number.
+   auto bit = 0L;
+   for (auto step = m_step; 0 == (step & 1); step >>= 1, ++bit);
+
+   m_block_index ^= (1LL << bit);
+   m_changed_index = m_dimension - 1 - (g_block_dimension + bit);
+   m_combination[m_changed_index] = ~m_combination[m_changed_index];
+
+   return m_combination.get();
+}
+
+void BitCombinationGenerator::FillHighParameters()
+{
+   // Parameters that don't vary inside the block are constant, and they
+   // represent bits of the block number.
+   for (auto bit = g_block_dimension; bit < m_dimension; ++bit)
+   {
+      m_combination[m_dimension - 1 - bit] =
+         ((m_block_index >> (bit - g_block_dimension)) & 1) ? g_bit_block_true : g_bit_block_false;
+   }
+}
+
+} // namespace dm
\ No newline at end of file
@@ -8,6 +8,14 @@
 namespace dm
 {
 
+// Amount of the lowest bits of a combination number, that vary inside a single block.
+const long g_bit_block_dimension = 6;
+
+// Values of the parameter, that is the given bit (counting from the lowest one, less
+// than g_bit_block_dimension) of a combination number, inside a block: bit j of
+// the pattern is the given bit of j.
+TBitBlock GetBitBlockPattern(long bit);
+
 class CombinationGenerator : public NonCopyable
 {
 public:
@@ -21,4 +29,50 @@ private:
    std::unique_ptr<LiteralType[]> m_combination;
 };
 
+// Generates the same sequence of combinations as CombinationGenerator does, but
+// packs up to g_bit_block_size sequential combinations into a single block of
+// bit-sliced parameter values: bit j of i-th block holds value of i-th parameter
+// in j-th combination of the block.
+// In Gray code mode blocks of the range are visited in such an order, that each next
+// block differs from the previous one by value of a single parameter. It allows
+// to recalculate only the part of an expression, which depends on this parameter.
+class BitCombinationGenerator : public NonCopyable
+{
+public:
+   BitCombinationGenerator(long dimension, bool is_gray_code = false);
+
+   // Amount of actual combinations in each generated block. It's less than
+   // g_bit_block_size only if the whole combination space fits into one block.
+   long GetBlockCombinationCount() const;
+   // Mask of bits that hold actual combinations.
+   TBitBlock GetBlockMask() const;
+
+   long long GetBlockCount() const;
+   // Restricts generation to blocks with indexes in range [block_from, block_to),
+   // so separate parts of the combination space can be processed independently.
+   // In Gray code mode the range must be aligned to its size, that is a power of two.
+   void SetBlockRange(long long block_from, long long block_to);
+   long long GetBlockIndex() const;
+   // Returns index of the only parameter, changed by the last GenerateNext call
+   // in Gray code mode, or -1 otherwise.
+   long GetChangedIndex() const;
+
+   const TBitBlock* GenerateFirst();
+   const TBitBlock* GenerateNext();
+
+private:
+   void FillHighParameters();
+
+private:
+   long m_dimension;
+   bool m_is_gray_code;
+   long long m_block_index;
+   long long m_block_count;
+   long long m_block_from;
+   long long m_block_to;
+   long long m_step;
+   long m_changed_index;
+   std::unique_ptr<TBitBlock[]> m_combination;
+};
+
 } // namespace dm
@@ -36,4 +36,35 @@ const char* LiteralTypeToString(LiteralType literal)
    return (literal == LiteralType::True ? g_token_1 : g_token_0);
 }
 
+TBitBlock LiteralTypeToBitBlock(LiteralType literal)
+{
+   assert(literal != LiteralType::None);
+   return (literal == LiteralType::True ? g_bit_block_true : g_bit_block_false);
+}
+
+LiteralType GetBitBlockLiteral(TBitBlock block, long bit)
+{
+   assert(bit >= 0 && bit < g_bit_block_size);
+   return ((block >> bit) & 1) ? LiteralType::True : LiteralType::False;
+}
+
+long FindFirstSetBit(TBitBlock block)
+{
+   if (g_bit_block_false == block)
+   {
+      return -1;
+   }
+
+   auto bit = 0L;
+   for (; 0 == (block & 1); block >>= 1, ++bit);
+   return bit;
+}
+
+long CountSetBits(TBitBlock block)
+{
+   auto count = 0L;
+   for (; block != g_bit_block_false; block &= block - 1, ++count);
+   return count;
+}
+
 } // namespace dm
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "string_utils.h"
 
+#include <cstdint>
+
 namespace dm
 {
 
@@ -17,4 +19,18 @@ bool IsLiteralToken(const StringPtrLen& str);
 LiteralType StringToLiteralType(const StringPtrLen& str);
 const char* LiteralTypeToString(LiteralType literal);
 
+// Block of bit-sliced literals. Each bit holds a literal value that belongs to
+// a separate parameter combination, so operations over blocks are bit-parallel.
+using TBitBlock = std::uint64_t;
+
+const long g_bit_block_size = 64;
+const TBitBlock g_bit_block_false = 0;
+const TBitBlock g_bit_block_true = ~TBitBlock(0);
+
+TBitBlock LiteralTypeToBitBlock(LiteralType literal);
+LiteralType GetBitBlockLiteral(TBitBlock block, long bit);
+// Returns index of the lowest set bit or -1 if the block is zero.
+long FindFirstSetBit(TBitBlock block);
+long CountSetBits(TBitBlock block);
+
 } // namespace dm
\ No newline at end of file
@@ -68,6 +68,36 @@ LiteralType Plus(LiteralType value1, LiteralType value2)
       LiteralType::True : LiteralType::False;
 }
 
+TBitBlock BitNegation(TBitBlock value)
+{
+   return ~value;
+}
+
+TBitBlock BitConjunction(TBitBlock value1, TBitBlock value2)
+{
+   return value1 & value2;
+}
+
+TBitBlock BitDisjunction(TBitBlock value1, TBitBlock value2)
+{
+   return value1 | value2;
+}
+
+TBitBlock BitImplication(TBitBlock value1, TBitBlock value2)
+{
+   return ~value1 | value2;
+}
+
+TBitBlock BitEquality(TBitBlock value1, TBitBlock value2)
+{
+   return ~(value1 ^ value2);
+}
+
+TBitBlock BitPlus(TBitBlock value1, TBitBlock value2)
+{
+   return value1 ^ value2;
+}
+
 } // namespace
 
 LiteralType PerformOperation(OperationType operation, const LiteralType values[], long amount)
@@ -108,6 +138,40 @@ LiteralType PerformOperation(OperationType operation, const LiteralType values[]
    return result;
 }
 
+TBitBlock PerformOperation(OperationType operation, const TBitBlock values[], long amount)
+{
+   assert(OperationType::None != operation);
+
+   if (OperationType::Negation == operation)
+   {
+      assert(1 == amount);
+      return BitNegation(values[0]);
+   }
+
+   assert(amount > 1);
+
+   using TBitOperationFunctionPtr = TBitBlock(*)(TBitBlock, TBitBlock);
+
+   static TBitOperationFunctionPtr functions[] =
+   {
+      nullptr,        // OperationType::Negation
+      BitConjunction, // OperationType::Conjunction
+      BitDisjunction, // OperationType::Disjunction
+      BitImplication, // OperationType::Implication
+      BitEquality,    // OperationType::Equality
+      BitPlus         // OperationType::Plus
+   };
+
+   auto func = functions[static_cast<int>(operation)];
+   auto result = values[0];
+   for (auto i = 1L; i < amount; ++i)
+   {
+      result = func(result, values[i]);
+   }
+
+   return result;
+}
+
 bool AreOperandsMovable(OperationType operation)
 {
    assert(OperationType::None != operation);
@@ -19,6 +19,8 @@ enum class OperationType
 };
 
 LiteralType PerformOperation(OperationType operation, const LiteralType values[], long amount);
+// Bit-parallel version, that performs operation over all bits of blocks at once.
+TBitBlock PerformOperation(OperationType operation, const TBitBlock values[], long amount);
 
 // Actually it means that operation is commutative and associative.
 bool AreOperandsMovable(OperationType operation);
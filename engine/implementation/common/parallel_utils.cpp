@@ -0,0 +1,67 @@
+#include "parallel_utils.h"
+
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <cassert>
+
+namespace dm
+{
+
+void ProcessInParallel(long long count, long long chunk_size, const TRangeProcessor& processor)
+{
+   assert(count >= 0);
+   assert(chunk_size > 0);
+
+   const auto chunk_count = (count + chunk_size - 1) / chunk_size;
+
+   std::atomic<long long> next_chunk(0);
+   std::atomic<bool> is_stopped(false);
+
+   auto worker = [&]()
+   {
+      while (!is_stopped)
+      {
+         const auto chunk = next_chunk++;
+         if (chunk >= chunk_count)
+         {
+            break;
+         }
+
+         const auto from = chunk * chunk_size;
+         const auto to = std::min(from + chunk_size, count);
+         if (!processor(from, to))
+         {
+            is_stopped = true;
+         }
+      }
+   };
+
+   const auto thread_count = std::min<long long>(
+      std::max(std::thread::hardware_concurrency(), 1u), chunk_count);
+
+   if (thread_count <= 1)
+   {
+      // Don't spawn threads for a single chunk.
+      worker();
+      return;
+   }
+
+   std::vector<std::thread> threads;
+   threads.reserve(thread_count - 1);
+   for (auto index = 1LL; index < thread_count; ++index)
+   {
+      threads.emplace_back(worker);
+   }
+
+   // The calling thread is a worker too.
+   worker();
+
+   for (auto& thread : threads)
+   {
+      thread.join();
+   }
+}
+
+} // namespace dm
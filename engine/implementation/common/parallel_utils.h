@@ -0,0 +1,17 @@
+#pragma once
+
+#include <functional>
+
+namespace dm
+{
+
+// Processor of range [from, to). If it returns false, no more ranges are passed to processors.
+using TRangeProcessor = std::function<bool(long long from, long long to)>;
+
+// Splits range [0, count) into chunks of chunk_size elements and processes them by a pool of
+// worker threads. Chunks are handed out in ascending order, so when processing is stopped,
+// all chunks preceding the stopping one have been (or are being) processed.
+// Processor must be thread-safe.
+void ProcessInParallel(long long count, long long chunk_size, const TRangeProcessor& processor);
+
+} // namespace dm
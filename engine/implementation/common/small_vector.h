@@ -0,0 +1,181 @@
+#pragma once
+
+#include "noncopyable.h"
+
+#include <vector>
+#include <algorithm>
+#include <new>
+#include <utility>
+#include <iterator>
+#include <stdexcept>
+#include <cstddef>
+#include <cassert>
+
+namespace dm
+{
+
+// Vector, which keeps up to inline_capacity elements inside itself,
+// so small vectors don't need a separate heap allocation.
+template <class T, std::size_t inline_capacity>
+class SmallVector : public NonCopyable
+{
+public:
+   using iterator = T*;
+   using const_iterator = const T*;
+
+   SmallVector() :
+      m_data(GetInlineData()), m_size(0), m_capacity(inline_capacity)
+   {
+   }
+
+   explicit SmallVector(std::vector<T>&& rhs) : SmallVector()
+   {
+      reserve(rhs.size());
+      for (auto& value : rhs)
+      {
+         new (m_data + m_size) T(std::move(value));
+         ++m_size;
+      }
+      rhs.clear();
+   }
+
+   ~SmallVector()
+   {
+      clear();
+      if (!IsInline())
+      {
+         ::operator delete(m_data);
+      }
+   }
+
+   std::size_t size() const { return m_size; }
+   bool empty() const { return 0 == m_size; }
+
+   iterator begin() { return m_data; }
+   iterator end() { return m_data + m_size; }
+   const_iterator begin() const { return m_data; }
+   const_iterator end() const { return m_data + m_size; }
+   const_iterator cbegin() const { return m_data; }
+   const_iterator cend() const { return m_data + m_size; }
+
+   T& operator[](std::size_t index) { assert(index < m_size); return m_data[index]; }
+   const T& operator[](std::size_t index) const { assert(index < m_size); return m_data[index]; }
+
+   const T& at(std::size_t index) const
+   {
+      if (index >= m_size)
+      {
+         throw std::out_of_range("SmallVector index is out of range");
+      }
+      return m_data[index];
+   }
+
+   void reserve(std::size_t capacity)
+   {
+      if (capacity <= m_capacity)
+      {
+         return;
+      }
+
+      auto data = static_cast<T*>(::operator new(capacity * sizeof(T)));
+      for (std::size_t index = 0; index < m_size; ++index)
+      {
+         new (data + index) T(std::move(m_data[index]));
+         m_data[index].~T();
+      }
+
+      if (!IsInline())
+      {
+         ::operator delete(m_data);
+      }
+
+      m_data = data;
+      m_capacity = capacity;
+   }
+
+   void push_back(T&& value)
+   {
+      Grow(m_size + 1);
+      new (m_data + m_size) T(std::move(value));
+      ++m_size;
+   }
+
+   iterator insert(const_iterator position, T&& value)
+   {
+      const auto index = static_cast<std::size_t>(position - m_data);
+      assert(index <= m_size);
+
+      Grow(m_size + 1);
+      if (index == m_size)
+      {
+         new (m_data + m_size) T(std::move(value));
+      }
+      else
+      {
+         new (m_data + m_size) T(std::move(m_data[m_size - 1]));
+         std::move_backward(m_data + index, m_data + m_size - 1, m_data + m_size);
+         m_data[index] = std::move(value);
+      }
+      ++m_size;
+
+      return m_data + index;
+   }
+
+   iterator erase(const_iterator position)
+   {
+      return erase(position, position + 1);
+   }
+
+   iterator erase(const_iterator first, const_iterator last)
+   {
+      const auto from = static_cast<std::size_t>(first - m_data);
+      const auto to = static_cast<std::size_t>(last - m_data);
+      assert(from <= to && to <= m_size);
+
+      std::move(m_data + to, m_data + m_size, m_data + from);
+      const auto new_size = m_size - (to - from);
+      for (auto index = new_size; index < m_size; ++index)
+      {
+         m_data[index].~T();
+      }
+      m_size = new_size;
+
+      return m_data + from;
+   }
+
+   void clear()
+   {
+      for (std::size_t index = 0; index < m_size; ++index)
+      {
+         m_data[index].~T();
+      }
+      m_size = 0;
+   }
+
+private:
+   T* GetInlineData()
+   {
+      return reinterpret_cast<T*>(m_inline_data);
+   }
+
+   bool IsInline() const
+   {
+      return m_data == reinterpret_cast<const T*>(m_inline_data);
+   }
+
+   void Grow(std::size_t size)
+   {
+      if (size > m_capacity)
+      {
+         reserve(std::max(size, m_capacity * 2));
+      }
+   }
+
+private:
+   T* m_data;
+   std::size_t m_size;
+   std::size_t m_capacity;
+   alignas(T) unsigned char m_inline_data[inline_capacity * sizeof(T)];
+};
+
+} // namespace dm
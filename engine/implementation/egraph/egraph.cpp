@@ -0,0 +1,245 @@
+#include "egraph.h"
+
+#include <algorithm>
+#include <tuple>
+#include <cassert>
+
+namespace dm
+{
+
+long ENode::GetChildCount() const
+{
+   if (ExpressionType::Operation != type)
+   {
+      return 0;
+   }
+   return OperationType::Negation == operation ? 1 : 2;
+}
+
+bool ENode::operator==(const ENode& rhs) const
+{
+   return type == rhs.type && literal == rhs.literal && param_index == rhs.param_index &&
+          operation == rhs.operation && children[0] == rhs.children[0] && children[1] == rhs.children[1];
+}
+
+bool ENode::operator<(const ENode& rhs) const
+{
+   return std::tie(type, literal, param_index, operation, children[0], children[1]) <
+          std::tie(rhs.type, rhs.literal, rhs.param_index, rhs.operation, rhs.children[0], rhs.children[1]);
+}
+
+ENode MakeLiteralENode(LiteralType literal)
+{
+   return ENode{ ExpressionType::Literal, literal, -1, OperationType::None, { g_no_eclass, g_no_eclass } };
+}
+
+ENode MakeParamRefENode(long param_index)
+{
+   return ENode{ ExpressionType::ParamRef, LiteralType::None, param_index, OperationType::None,
+                 { g_no_eclass, g_no_eclass } };
+}
+
+ENode MakeNegationENode(TEClassId child)
+{
+   return ENode{ ExpressionType::Operation, LiteralType::None, -1, OperationType::Negation, { child, g_no_eclass } };
+}
+
+ENode MakeOperationENode(OperationType operation, TEClassId left, TEClassId right)
+{
+   assert(OperationType::None != operation && OperationType::Negation != operation);
+   return ENode{ ExpressionType::Operation, LiteralType::None, -1, operation, { left, right } };
+}
+
+std::size_t ENodeHash::operator()(const ENode& node) const
+{
+   auto hash = std::size_t(node.type) * 31 + std::size_t(node.literal) + 1;
+   hash = hash * 31 + std::size_t(node.param_index) + 1;
+   hash = hash * 31 + std::size_t(node.operation) + 1;
+   hash = hash * 1000003 + node.children[0];
+   hash = hash * 1000003 + node.children[1];
+   return hash;
+}
+
+EGraph::EGraph() :
+   m_union_find(), m_classes(), m_nodes(), m_pending_classes(), m_class_count(0)
+{
+}
+
+TEClassId EGraph::Add(const ENode& node)
+{
+   const auto canonical_node = Canonicalize(node);
+   const auto iter = m_nodes.find(canonical_node);
+   if (iter != m_nodes.end())
+   {
+      return Find(iter->second);
+   }
+
+   const auto id = static_cast<TEClassId>(m_classes.size());
+   m_union_find.push_back(id);
+   m_classes.push_back(EClass{ { canonical_node }, {} });
+   for (auto index = 0L; index < canonical_node.GetChildCount(); ++index)
+   {
+      m_classes[canonical_node.children[index]].parents.emplace_back(canonical_node, id);
+   }
+   m_nodes.emplace(canonical_node, id);
+   ++m_class_count;
+   return id;
+}
+
+bool EGraph::Merge(TEClassId left, TEClassId right)
+{
+   auto root = Find(left);
+   auto other = Find(right);
+   if (root == other)
+   {
+      return false;
+   }
+
+   // Smaller class is moved into the larger one.
+   if (m_classes[root].nodes.size() + m_classes[root].parents.size() <
+       m_classes[other].nodes.size() + m_classes[other].parents.size())
+   {
+      std::swap(root, other);
+   }
+
+   m_union_find[other] = root;
+   auto& root_class = m_classes[root];
+   auto& other_class = m_classes[other];
+   root_class.nodes.insert(root_class.nodes.end(), other_class.nodes.begin(), other_class.nodes.end());
+   root_class.parents.insert(root_class.parents.end(), other_class.parents.begin(), other_class.parents.end());
+   other_class = EClass();
+
+   m_pending_classes.push_back(root);
+   --m_class_count;
+   return true;
+}
+
+void EGraph::Rebuild()
+{
+   while (!m_pending_classes.empty())
+   {
+      std::vector<TEClassId> classes;
+      classes.swap(m_pending_classes);
+      for (auto& id : classes)
+      {
+         id = Find(id);
+      }
+      std::sort(classes.begin(), classes.end());
+      classes.erase(std::unique(classes.begin(), classes.end()), classes.end());
+
+      for (const auto id : classes)
+      {
+         Repair(id);
+      }
+   }
+
+   // Nodes of classes are kept canonical and unique for searches.
+   for (const auto id : GetClassIds())
+   {
+      auto& nodes = m_classes[id].nodes;
+      for (auto& node : nodes)
+      {
+         node = Canonicalize(node);
+      }
+      std::sort(nodes.begin(), nodes.end());
+      nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+   }
+}
+
+TEClassId EGraph::Find(TEClassId id) const
+{
+   assert(id < m_union_find.size());
+   while (m_union_find[id] != id)
+   {
+      m_union_find[id] = m_union_find[m_union_find[id]];
+      id = m_union_find[id];
+   }
+   return id;
+}
+
+std::vector<TEClassId> EGraph::GetClassIds() const
+{
+   std::vector<TEClassId> ids;
+   ids.reserve(m_class_count);
+   for (auto id = TEClassId(0); id < m_union_find.size(); ++id)
+   {
+      if (m_union_find[id] == id)
+      {
+         ids.push_back(id);
+      }
+   }
+   return ids;
+}
+
+const std::vector<ENode>& EGraph::GetNodes(TEClassId id) const
+{
+   assert(Find(id) == id);
+   return m_classes[id].nodes;
+}
+
+long EGraph::GetClassCount() const
+{
+   return m_class_count;
+}
+
+long EGraph::GetNodeCount() const
+{
+   return m_nodes.size();
+}
+
+ENode EGraph::Canonicalize(const ENode& node) const
+{
+   auto result = node;
+   const auto child_count = node.GetChildCount();
+   for (auto index = 0L; index < child_count; ++index)
+   {
+      result.children[index] = Find(node.children[index]);
+   }
+   if (2 == child_count && AreOperandsMovable(node.operation) && result.children[1] < result.children[0])
+   {
+      std::swap(result.children[0], result.children[1]);
+   }
+   return result;
+}
+
+void EGraph::Repair(TEClassId id)
+{
+   // Parents are taken out, since merges below can change the class.
+   std::vector<std::pair<ENode, TEClassId>> parents;
+   parents.swap(m_classes[id].parents);
+
+   for (const auto& parent : parents)
+   {
+      m_nodes.erase(parent.first);
+   }
+
+   // Parents, which became equal, are congruent, so their classes are merged.
+   TNodeMap unique_parents;
+   for (const auto& parent : parents)
+   {
+      const auto node = Canonicalize(parent.first);
+      const auto parent_id = Find(parent.second);
+
+      const auto iter = m_nodes.find(node);
+      if (iter != m_nodes.end())
+      {
+         Merge(iter->second, parent_id);
+      }
+      m_nodes[node] = Find(parent_id);
+
+      const auto unique_iter = unique_parents.find(node);
+      if (unique_iter != unique_parents.end())
+      {
+         Merge(unique_iter->second, parent_id);
+      }
+      unique_parents[node] = Find(parent_id);
+   }
+
+   auto& root_parents = m_classes[Find(id)].parents;
+   for (const auto& parent : unique_parents)
+   {
+      root_parents.emplace_back(parent.first, Find(parent.second));
+   }
+}
+
+} // namespace dm
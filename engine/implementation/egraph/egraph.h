@@ -0,0 +1,92 @@
+#pragma once
+
+#include "../common/literals.h"
+#include "../common/operations.h"
+#include "../common/noncopyable.h"
+#include "../expressions/expression_base.h"
+
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <cstdint>
+
+namespace dm
+{
+
+using TEClassId = std::uint32_t;
+
+const TEClassId g_no_eclass = ~TEClassId(0);
+
+// Node of an e-graph: a literal, a parameter, a negation or a binary operation,
+// which children are e-classes.
+struct ENode
+{
+   ExpressionType type;
+   LiteralType literal;
+   long param_index;
+   OperationType operation;
+   TEClassId children[2];
+
+   long GetChildCount() const;
+
+   bool operator==(const ENode& rhs) const;
+   bool operator<(const ENode& rhs) const;
+};
+
+ENode MakeLiteralENode(LiteralType literal);
+ENode MakeParamRefENode(long param_index);
+ENode MakeNegationENode(TEClassId child);
+ENode MakeOperationENode(OperationType operation, TEClassId left, TEClassId right);
+
+struct ENodeHash
+{
+   std::size_t operator()(const ENode& node) const;
+};
+
+// E-graph keeps classes of equal expressions. Nodes are hash-consed over canonical
+// ids of classes, and operands of commutative operations are sorted, so commutativity
+// needs no rules. Classes are merged by union-find, and the congruence (equal nodes
+// are in the same class) is restored by Rebuild, which must be called after merges
+// and before the next search over the graph.
+class EGraph : public NonCopyable
+{
+public:
+   EGraph();
+
+   TEClassId Add(const ENode& node);
+   // Returns false, if classes are already the same.
+   bool Merge(TEClassId left, TEClassId right);
+   void Rebuild();
+
+   TEClassId Find(TEClassId id) const;
+
+   // Canonical ids of all classes.
+   std::vector<TEClassId> GetClassIds() const;
+   // Nodes of the canonical class.
+   const std::vector<ENode>& GetNodes(TEClassId id) const;
+
+   long GetClassCount() const;
+   long GetNodeCount() const;
+
+private:
+   ENode Canonicalize(const ENode& node) const;
+   void Repair(TEClassId id);
+
+   struct EClass
+   {
+      std::vector<ENode> nodes;
+      // Nodes, which use the class, with their classes.
+      std::vector<std::pair<ENode, TEClassId>> parents;
+   };
+
+   using TNodeMap = std::unordered_map<ENode, TEClassId, ENodeHash>;
+
+private:
+   mutable std::vector<TEClassId> m_union_find;
+   std::vector<EClass> m_classes;
+   TNodeMap m_nodes;
+   std::vector<TEClassId> m_pending_classes;
+   long m_class_count;
+};
+
+} // namespace dm
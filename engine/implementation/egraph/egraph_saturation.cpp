@@ -0,0 +1,495 @@
+#include "egraph_saturation.h"
+
+#include <array>
+#include <chrono>
+#include <limits>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+const long g_max_pattern_variable_count = 3;
+
+using TSubstitution = std::array<TEClassId, g_max_pattern_variable_count>;
+using TSubstitutionVector = std::vector<TSubstitution>;
+
+// Pattern is a tree of nodes, which leaves can be variables, matching any class.
+struct Pattern
+{
+   ExpressionType type;
+   LiteralType literal;
+   long variable;
+   OperationType operation;
+   std::vector<Pattern> children;
+};
+
+Pattern Var(long variable)
+{
+   assert(variable >= 0 && variable < g_max_pattern_variable_count);
+   return Pattern{ ExpressionType::ParamRef, LiteralType::None, variable, OperationType::None, {} };
+}
+
+Pattern Lit(LiteralType literal)
+{
+   return Pattern{ ExpressionType::Literal, literal, -1, OperationType::None, {} };
+}
+
+Pattern Op(OperationType operation, std::vector<Pattern>&& children)
+{
+   return Pattern{ ExpressionType::Operation, LiteralType::None, -1, operation, std::move(children) };
+}
+
+Pattern Not(Pattern child)
+{
+   return Op(OperationType::Negation, { std::move(child) });
+}
+
+Pattern And(Pattern left, Pattern right)
+{
+   return Op(OperationType::Conjunction, { std::move(left), std::move(right) });
+}
+
+Pattern Or(Pattern left, Pattern right)
+{
+   return Op(OperationType::Disjunction, { std::move(left), std::move(right) });
+}
+
+Pattern Imp(Pattern left, Pattern right)
+{
+   return Op(OperationType::Implication, { std::move(left), std::move(right) });
+}
+
+Pattern Eq(Pattern left, Pattern right)
+{
+   return Op(OperationType::Equality, { std::move(left), std::move(right) });
+}
+
+Pattern Plus(Pattern left, Pattern right)
+{
+   return Op(OperationType::Plus, { std::move(left), std::move(right) });
+}
+
+// Left side is replaced by the right one. Variables of the right side must be bound by the left one.
+struct Rule
+{
+   Pattern left;
+   Pattern right;
+};
+
+struct RuleMatch
+{
+   size_t rule_index;
+   TEClassId id;
+   TSubstitution substitution;
+};
+
+std::vector<Rule> CreateRules()
+{
+   const auto x = Var(0);
+   const auto y = Var(1);
+   const auto z = Var(2);
+   const auto f = Lit(LiteralType::False);
+   const auto t = Lit(LiteralType::True);
+
+   std::vector<Rule> rules;
+
+   // Double negation and negation of literals.
+   rules.push_back(Rule{ Not(Not(x)), x });
+   rules.push_back(Rule{ Not(f), t });
+   rules.push_back(Rule{ Not(t), f });
+
+   // Identities of conjunction and disjunction.
+   rules.push_back(Rule{ And(x, t), x });
+   rules.push_back(Rule{ And(x, f), f });
+   rules.push_back(Rule{ Or(x, f), x });
+   rules.push_back(Rule{ Or(x, t), t });
+   rules.push_back(Rule{ And(x, x), x });
+   rules.push_back(Rule{ Or(x, x), x });
+   rules.push_back(Rule{ And(x, Not(x)), f });
+   rules.push_back(Rule{ Or(x, Not(x)), t });
+
+   // Associativity, commutativity is kept by the graph itself.
+   rules.push_back(Rule{ And(And(x, y), z), And(x, And(y, z)) });
+   rules.push_back(Rule{ Or(Or(x, y), z), Or(x, Or(y, z)) });
+   rules.push_back(Rule{ Plus(Plus(x, y), z), Plus(x, Plus(y, z)) });
+
+   // De Morgan's laws in both directions.
+   rules.push_back(Rule{ Not(And(x, y)), Or(Not(x), Not(y)) });
+   rules.push_back(Rule{ Not(Or(x, y)), And(Not(x), Not(y)) });
+   rules.push_back(Rule{ Or(Not(x), Not(y)), Not(And(x, y)) });
+   rules.push_back(Rule{ And(Not(x), Not(y)), Not(Or(x, y)) });
+
+   // Absorption and gluing.
+   rules.push_back(Rule{ And(x, Or(x, y)), x });
+   rules.push_back(Rule{ Or(x, And(x, y)), x });
+   rules.push_back(Rule{ And(x, Or(Not(x), y)), And(x, y) });
+   rules.push_back(Rule{ Or(x, And(Not(x), y)), Or(x, y) });
+   rules.push_back(Rule{ Or(And(x, y), And(x, Not(y))), x });
+   rules.push_back(Rule{ And(Or(x, y), Or(x, Not(y))), x });
+
+   // Implication.
+   rules.push_back(Rule{ Imp(x, y), Or(Not(x), y) });
+   rules.push_back(Rule{ Or(Not(x), y), Imp(x, y) });
+
+   // Equality and plus.
+   rules.push_back(Rule{ Eq(x, y), Not(Plus(x, y)) });
+   rules.push_back(Rule{ Not(Plus(x, y)), Eq(x, y) });
+   rules.push_back(Rule{ Plus(Not(x), y), Eq(x, y) });
+   rules.push_back(Rule{ And(Imp(x, y), Imp(y, x)), Eq(x, y) });
+   rules.push_back(Rule{ Or(And(x, y), And(Not(x), Not(y))), Eq(x, y) });
+   rules.push_back(Rule{ Or(And(x, Not(y)), And(Not(x), y)), Plus(x, y) });
+   rules.push_back(Rule{ Plus(x, x), f });
+   rules.push_back(Rule{ Plus(x, f), x });
+   rules.push_back(Rule{ Plus(x, t), Not(x) });
+
+   return rules;
+}
+
+const std::vector<Rule>& GetRules()
+{
+   static const std::vector<Rule> rules = CreateRules();
+   return rules;
+}
+
+class Saturator
+{
+public:
+   Saturator(EGraph& egraph, const SaturationLimits& limits);
+
+   SaturationStats Saturate();
+
+private:
+   void Match(const Pattern& pattern, TEClassId id, const TSubstitution& substitution,
+              TSubstitutionVector& substitutions) const;
+   void MatchChildren(const Pattern& pattern, const TEClassId children[], const TSubstitution& substitution,
+                      TSubstitutionVector& substitutions) const;
+   TEClassId Instantiate(const Pattern& pattern, const TSubstitution& substitution);
+
+private:
+   EGraph& m_egraph;
+   const SaturationLimits& m_limits;
+};
+
+Saturator::Saturator(EGraph& egraph, const SaturationLimits& limits) :
+   m_egraph(egraph), m_limits(limits)
+{
+}
+
+SaturationStats Saturator::Saturate()
+{
+   using TClock = std::chrono::steady_clock;
+   const auto deadline = TClock::now() + std::chrono::milliseconds(m_limits.max_milliseconds);
+
+   const auto& rules = GetRules();
+   TSubstitution empty_substitution;
+   empty_substitution.fill(g_no_eclass);
+
+   m_egraph.Rebuild();
+   for (auto iteration = 0L; iteration < m_limits.max_iteration_count; ++iteration)
+   {
+      // All matches are searched in the same graph, and only then rules are applied.
+      std::vector<RuleMatch> matches;
+      const auto ids = m_egraph.GetClassIds();
+      for (auto rule_index = size_t(0); rule_index < rules.size(); ++rule_index)
+      {
+         for (const auto id : ids)
+         {
+            TSubstitutionVector substitutions;
+            Match(rules[rule_index].left, id, empty_substitution, substitutions);
+            for (const auto& substitution : substitutions)
+            {
+               matches.push_back(RuleMatch{ rule_index, id, substitution });
+            }
+         }
+         if (TClock::now() > deadline)
+         {
+            return SaturationStats{ SaturationResult::TimeLimit, iteration };
+         }
+      }
+
+      // Graph is changed, if a rule adds a new node or merges classes.
+      const auto node_count = m_egraph.GetNodeCount();
+      auto is_changed = false;
+      for (const auto& match : matches)
+      {
+         const auto id = Instantiate(rules[match.rule_index].right, match.substitution);
+         is_changed = m_egraph.Merge(match.id, id) || is_changed;
+         if (m_egraph.GetNodeCount() > m_limits.max_node_count)
+         {
+            m_egraph.Rebuild();
+            return SaturationStats{ SaturationResult::NodeLimit, iteration + 1 };
+         }
+      }
+      is_changed = is_changed || m_egraph.GetNodeCount() != node_count;
+      m_egraph.Rebuild();
+
+      if (!is_changed)
+      {
+         return SaturationStats{ SaturationResult::Saturated, iteration + 1 };
+      }
+      if (TClock::now() > deadline)
+      {
+         return SaturationStats{ SaturationResult::TimeLimit, iteration + 1 };
+      }
+   }
+   return SaturationStats{ SaturationResult::IterationLimit, m_limits.max_iteration_count };
+}
+
+void Saturator::Match(const Pattern& pattern, TEClassId id, const TSubstitution& substitution,
+                      TSubstitutionVector& substitutions) const
+{
+   switch (pattern.type)
+   {
+      case ExpressionType::ParamRef:
+      {
+         const auto bound_id = substitution[pattern.variable];
+         if (g_no_eclass == bound_id)
+         {
+            substitutions.push_back(substitution);
+            substitutions.back()[pattern.variable] = id;
+         }
+         else if (m_egraph.Find(bound_id) == id)
+         {
+            substitutions.push_back(substitution);
+         }
+         return;
+      }
+
+      case ExpressionType::Literal:
+         for (const auto& node : m_egraph.GetNodes(id))
+         {
+            if (ExpressionType::Literal == node.type && pattern.literal == node.literal)
+            {
+               substitutions.push_back(substitution);
+               return;
+            }
+         }
+         return;
+
+      case ExpressionType::Operation:
+         for (const auto& node : m_egraph.GetNodes(id))
+         {
+            if (ExpressionType::Operation != node.type || pattern.operation != node.operation)
+            {
+               continue;
+            }
+
+            MatchChildren(pattern, node.children, substitution, substitutions);
+
+            // Operands of commutative operations are sorted in the graph, so both orders are tried.
+            if (2 == node.GetChildCount() && AreOperandsMovable(node.operation) &&
+                node.children[0] != node.children[1])
+            {
+               const TEClassId swapped_children[] = { node.children[1], node.children[0] };
+               MatchChildren(pattern, swapped_children, substitution, substitutions);
+            }
+         }
+         return;
+
+      default:
+         assert(!"Unknown pattern type");
+   }
+}
+
+void Saturator::MatchChildren(const Pattern& pattern, const TEClassId children[], const TSubstitution& substitution,
+                              TSubstitutionVector& substitutions) const
+{
+   TSubstitutionVector partial_substitutions(1, substitution);
+   for (auto index = size_t(0); index < pattern.children.size() && !partial_substitutions.empty(); ++index)
+   {
+      TSubstitutionVector next_substitutions;
+      for (const auto& partial_substitution : partial_substitutions)
+      {
+         Match(pattern.children[index], children[index], partial_substitution, next_substitutions);
+      }
+      partial_substitutions.swap(next_substitutions);
+   }
+   substitutions.insert(substitutions.end(), partial_substitutions.begin(), partial_substitutions.end());
+}
+
+TEClassId Saturator::Instantiate(const Pattern& pattern, const TSubstitution& substitution)
+{
+   switch (pattern.type)
+   {
+      case ExpressionType::ParamRef:
+         assert(substitution[pattern.variable] != g_no_eclass);
+         return substitution[pattern.variable];
+
+      case ExpressionType::Literal:
+         return m_egraph.Add(MakeLiteralENode(pattern.literal));
+
+      case ExpressionType::Operation:
+      {
+         const auto left = Instantiate(pattern.children[0], substitution);
+         if (OperationType::Negation == pattern.operation)
+         {
+            return m_egraph.Add(MakeNegationENode(left));
+         }
+         const auto right = Instantiate(pattern.children[1], substitution);
+         return m_egraph.Add(MakeOperationENode(pattern.operation, left, right));
+      }
+
+      default:
+         assert(!"Unknown pattern type");
+         return g_no_eclass;
+   }
+}
+
+using TAddedClassMap = std::unordered_map<const UniqueExpression*, TEClassId>;
+
+TEClassId AddExpressionImpl(EGraph& egraph, const TUniqueExpressionPtr& expr, TAddedClassMap& added)
+{
+   switch (expr->GetType())
+   {
+      case ExpressionType::Literal:
+         return egraph.Add(MakeLiteralENode(expr->GetLiteral()));
+
+      case ExpressionType::ParamRef:
+         return egraph.Add(MakeParamRefENode(expr->GetParamIndex()));
+
+      case ExpressionType::Operation:
+      {
+         const auto iter = added.find(expr.get());
+         if (iter != added.end())
+         {
+            return iter->second;
+         }
+
+         const auto operation = expr->GetOperation();
+         auto result = AddExpressionImpl(egraph, expr->GetChild(0), added);
+         if (OperationType::Negation == operation)
+         {
+            result = egraph.Add(MakeNegationENode(result));
+         }
+         for (auto index = 1L; index < expr->GetChildCount(); ++index)
+         {
+            const auto child = AddExpressionImpl(egraph, expr->GetChild(index), added);
+            result = egraph.Add(MakeOperationENode(operation, result, child));
+         }
+
+         added.emplace(expr.get(), result);
+         return result;
+      }
+
+      default:
+         assert(!"Unknown expression type");
+         return g_no_eclass;
+   }
+}
+
+class Extractor
+{
+public:
+   Extractor(const EGraph& egraph);
+
+   TUniqueExpressionPtr Extract(TEClassId id);
+
+private:
+   struct Choice
+   {
+      long cost;
+      ENode node;
+   };
+
+private:
+   const EGraph& m_egraph;
+   std::unordered_map<TEClassId, Choice> m_choices;
+   std::unordered_map<TEClassId, TUniqueExpressionPtr> m_expressions;
+};
+
+Extractor::Extractor(const EGraph& egraph) :
+   m_egraph(egraph), m_choices(), m_expressions()
+{
+   // Costs are relaxed, until they are not reduced. Each node costs more, than its children,
+   // so the chosen nodes don't form cycles.
+   const auto ids = m_egraph.GetClassIds();
+   for (auto is_changed = true; is_changed; )
+   {
+      is_changed = false;
+      for (const auto id : ids)
+      {
+         for (const auto& node : m_egraph.GetNodes(id))
+         {
+            auto cost = 1L;
+            for (auto index = 0L; index < node.GetChildCount() && cost != std::numeric_limits<long>::max(); ++index)
+            {
+               const auto iter = m_choices.find(m_egraph.Find(node.children[index]));
+               cost = (iter != m_choices.end()) ? cost + iter->second.cost : std::numeric_limits<long>::max();
+            }
+
+            const auto iter = m_choices.find(id);
+            if (cost != std::numeric_limits<long>::max() && (iter == m_choices.end() || cost < iter->second.cost))
+            {
+               m_choices[id] = Choice{ cost, node };
+               is_changed = true;
+            }
+         }
+      }
+   }
+}
+
+TUniqueExpressionPtr Extractor::Extract(TEClassId id)
+{
+   id = m_egraph.Find(id);
+   const auto iter = m_expressions.find(id);
+   if (iter != m_expressions.end())
+   {
+      return iter->second;
+   }
+
+   assert(m_choices.count(id) != 0);
+   const auto& node = m_choices.at(id).node;
+   auto& table = UniqueExpressionTable::GetInstance();
+
+   TUniqueExpressionPtr result;
+   switch (node.type)
+   {
+      case ExpressionType::Literal:
+         result = table.MakeLiteral(node.literal);
+         break;
+
+      case ExpressionType::ParamRef:
+         result = table.MakeParamRef(node.param_index);
+         break;
+
+      case ExpressionType::Operation:
+      {
+         TUniqueExpressionPtrVector children;
+         for (auto index = 0L; index < node.GetChildCount(); ++index)
+         {
+            children.push_back(Extract(node.children[index]));
+         }
+         result = table.MakeNormalizedOperation(node.operation, std::move(children));
+         break;
+      }
+
+      default:
+         assert(!"Unknown node type");
+   }
+
+   m_expressions.emplace(id, result);
+   return result;
+}
+
+} // namespace
+
+TEClassId AddExpression(EGraph& egraph, const TUniqueExpressionPtr& expr)
+{
+   TAddedClassMap added;
+   return AddExpressionImpl(egraph, expr, added);
+}
+
+SaturationStats SaturateEGraph(EGraph& egraph, const SaturationLimits& limits)
+{
+   return Saturator(egraph, limits).Saturate();
+}
+
+TUniqueExpressionPtr ExtractExpression(const EGraph& egraph, TEClassId id)
+{
+   return Extractor(egraph).Extract(id);
+}
+
+} // namespace dm
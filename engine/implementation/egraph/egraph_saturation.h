@@ -0,0 +1,45 @@
+#pragma once
+
+#include "egraph.h"
+#include "../expressions/expression_unique_table.h"
+
+namespace dm
+{
+
+struct SaturationLimits
+{
+   long max_node_count;
+   long max_iteration_count;
+   long max_milliseconds;
+};
+
+enum class SaturationResult
+{
+   Saturated,
+   NodeLimit,
+   IterationLimit,
+   TimeLimit
+};
+
+struct SaturationStats
+{
+   SaturationResult result;
+   long iteration_count;
+};
+
+// Adds the hash-consed expression to the graph, operations with more than two children
+// are folded from left to right. Returns the class of the expression.
+TEClassId AddExpression(EGraph& egraph, const TUniqueExpressionPtr& expr);
+
+// Applies laws of the boolean algebra (double negation, De Morgan's laws, absorption,
+// gluing, identities of implication, equality and plus, etc.) to all classes at once,
+// until nothing new is added or a limit is reached. Rules only add nodes and merge
+// classes, so no form of the expression, which was found, is lost.
+SaturationStats SaturateEGraph(EGraph& egraph, const SaturationLimits& limits);
+
+// Builds the expression of the class with the least amount of nodes of its tree, where
+// each negation, binary operation, parameter and literal counts as a node. Chains of
+// the same operation are merged, like MakeNormalizedOperation does it.
+TUniqueExpressionPtr ExtractExpression(const EGraph& egraph, TEClassId id);
+
+} // namespace dm
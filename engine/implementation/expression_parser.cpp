@@ -23,7 +23,7 @@ const char g_token_assignment[] = ":=";
 } // namespace
 
 ExpressionParser::ExpressionParser(const VariableManager& variable_mgr) :
-   m_variable_mgr(variable_mgr), m_curr_variable(nullptr)
+   m_variable_mgr(variable_mgr), m_curr_variable(nullptr), m_shared_params()
 {
 }
 
@@ -46,11 +46,46 @@ TVariablePtr ExpressionParser::Parse(StringPtrLen str)
    }
     
    m_curr_variable = variable.get();
+
+   // Parameters of the previous variable could be left, if its parsing failed.
+   m_shared_params.clear();
+   if (m_variable_mgr.IsHashConsing())
+   {
+      auto& table = UniqueExpressionTable::GetInstance();
+      for (auto index = 0L; index < variable->GetParameterCount(); ++index)
+      {
+         m_shared_params.push_back(table.MakeParamRef(index));
+      }
+   }
+
    auto expression = ParseExpression(str);
    m_curr_variable = nullptr;
 
+   if (m_variable_mgr.IsHashConsing())
+   {
+      // Placeholders are opaque for the tree algorithms, so the hash-consed expression
+      // is normalized and simplified together with expressions of usages.
+      variable->SetSharedExpression(
+         SimplifyUniqueExpression(NormalizeUniqueExpression(InternWithPlaceholders(expression))));
+      m_shared_params.clear();
+      return variable;
+   }
+
+   // Expression with applications refers to other variables, so it's kept as a tree.
+   // Operands are sorted in trees only, so canonical order disables flat store.
+   if (m_variable_mgr.IsFlatStore() && !m_variable_mgr.IsCanonicalOrder() && !ContainsApplications(expression))
+   {
+      auto flat_expression = std::make_unique<FlatExpression>(expression);
+      NormalizeExpression(*flat_expression);
+      SimplifyExpression(*flat_expression);
+
+      variable->SetFlatExpression(std::move(flat_expression));
+      return variable;
+   }
+
    NormalizeExpression(expression);
    SimplifyExpression(expression);
+   SortOperandsIfCanonical(expression);
    
    variable->SetExpression(std::move(expression));
 
@@ -247,7 +282,29 @@ TExpressionPtr ExpressionParser::ParseParameterizedVariableExpression(StringPtrL
          "'. Expected amount - ", variable->GetParameterCount(), ", actual amount - ", actual_params.size(), ".");
    }
 
-   return variable->GetExpression()->CloneWithSubstitution(actual_params);
+   if (m_variable_mgr.IsHashConsing())
+   {
+      TUniqueExpressionPtrVector shared_actual_params;
+      shared_actual_params.reserve(actual_params.size());
+      for (auto& actual_param : actual_params)
+      {
+         shared_actual_params.push_back(InternWithPlaceholders(actual_param));
+      }
+      return CreateSharedPlaceholder(SubstituteParams(variable->GetSharedExpression(), shared_actual_params));
+   }
+
+   if (m_variable_mgr.IsLazyApplication())
+   {
+      return CreateApplication(*variable, std::move(actual_params));
+   }
+
+   // Tree of the variable, declared in flat store mode, is not built.
+   auto expression = (variable->GetFlatExpression() != nullptr) ?
+      variable->GetFlatExpression()->ToTreeWithSubstitution(actual_params) :
+      variable->GetExpression()->CloneWithSubstitution(actual_params);
+   // Applications, declared in lazy application mode, are expanded too.
+   ExpandApplications(expression);
+   return expression;
 }
 
 TExpressionPtr ExpressionParser::ParseParameterExpression(StringPtrLen str) const
@@ -273,7 +330,46 @@ TExpressionPtr ExpressionParser::ParseNotParameterizedVariableExpression(StringP
       Error("Parameters are missing during usage of variable '", variable->GetName(), "'.");
    }
 
-   return variable->GetExpression()->Clone();
+   if (m_variable_mgr.IsHashConsing())
+   {
+      return CreateSharedPlaceholder(TUniqueExpressionPtr(variable->GetSharedExpression()));
+   }
+
+   if (m_variable_mgr.IsLazyApplication())
+   {
+      return CreateApplication(*variable, TExpressionPtrVector());
+   }
+
+   auto expression = variable->GetExpression()->Clone();
+   ExpandApplications(expression);
+   return expression;
+}
+
+TExpressionPtr ExpressionParser::CreateApplication(const Variable& variable, TExpressionPtrVector&& actual_params) const
+{
+   // Tree of the variable is built by the application, as applications
+   // are calculated from concurrent threads.
+   return std::make_unique<ApplicationExpression>(variable.shared_from_this(), std::move(actual_params));
+}
+
+TExpressionPtr ExpressionParser::CreateSharedPlaceholder(TUniqueExpressionPtr&& expr) const
+{
+   m_shared_params.push_back(std::move(expr));
+   return std::make_unique<ParamRefExpression>(*m_curr_variable, m_shared_params.size() - 1);
+}
+
+TUniqueExpressionPtr ExpressionParser::InternWithPlaceholders(const TExpressionPtr& expr) const
+{
+   return InternExpression(expr, m_shared_params);
+}
+
+void ExpressionParser::SortOperandsIfCanonical(TExpressionPtr& expr) const
+{
+   // Simplification moves literals and removes operands, so operands are sorted after it.
+   if (m_variable_mgr.IsCanonicalOrder())
+   {
+      NormalizeExpression(expr, true);
+   }
 }
 
 } // namespace dm
@@ -3,6 +3,7 @@
 #include "variables/variable.h"
 #include "variables/variable_manager.h"
 #include "expressions/expression_base.h"
+#include "expressions/expression_unique_table.h"
 #include "common/string_utils.h"
 
 namespace dm
@@ -25,9 +26,23 @@ private:
    TExpressionPtr ParseParameterExpression(StringPtrLen str) const;
    TExpressionPtr ParseNotParameterizedVariableExpression(StringPtrLen str) const;
 
+   // In hash-consing mode usage of a variable is parsed into a reference to an extra
+   // parameter with index beyond parameters of the current variable, which stands
+   // for the hash-consed expression of the usage.
+   TExpressionPtr CreateSharedPlaceholder(TUniqueExpressionPtr&& expr) const;
+   TUniqueExpressionPtr InternWithPlaceholders(const TExpressionPtr& expr) const;
+
+   // In lazy application mode usage of a variable is parsed into its application.
+   TExpressionPtr CreateApplication(const Variable& variable, TExpressionPtrVector&& actual_params) const;
+
+   // In canonical order mode operands of the normalized and simplified expression are sorted.
+   void SortOperandsIfCanonical(TExpressionPtr& expr) const;
+
 private:
    const VariableManager& m_variable_mgr;
    const VariableDeclaration* m_curr_variable;
+   // Hash-consed values of parameters and placeholders of the current variable.
+   mutable TUniqueExpressionPtrVector m_shared_params;
 };
 
 } // namespace dm
\ No newline at end of file
@@ -0,0 +1,238 @@
+#include "expression_application.h"
+#include "expression_normalizer.h"
+#include "expression_simplifier.h"
+#include "expression_utils.h"
+#include "expressions.h"
+#include "../variables/variable.h"
+
+#include <unordered_set>
+#include <cassert>
+
+namespace dm
+{
+
+ApplicationExpression::ApplicationExpression(
+   const TConstVariableSharedPtr& variable, TExpressionPtrVector&& actual_params) :
+      Base(),
+      m_variable(variable),
+      m_children(std::move(actual_params))
+{
+   assert(m_variable.get() != nullptr);
+   assert(m_variable->GetParameterCount() == (long)m_children.size());
+   m_variable->PrepareApplication();
+}
+
+ApplicationExpression::ApplicationExpression(const ApplicationExpression& rhs) :
+   Base(),
+   m_variable(rhs.m_variable),
+   m_children()
+{
+   m_children.reserve(rhs.m_children.size());
+   for (const auto& child : rhs.m_children)
+   {
+      m_children.push_back(child->Clone());
+   }
+}
+
+ApplicationExpression::ApplicationExpression(
+   const ApplicationExpression& rhs, const TExpressionPtrVector& actual_params) :
+      Base(),
+      m_variable(rhs.m_variable),
+      m_children()
+{
+   m_children.reserve(rhs.m_children.size());
+   for (const auto& child : rhs.m_children)
+   {
+      m_children.push_back(child->CloneWithSubstitution(actual_params));
+   }
+}
+
+const Variable& ApplicationExpression::GetVariable() const
+{
+   return *m_variable;
+}
+
+long ApplicationExpression::GetChildCount() const
+{
+   return m_children.size();
+}
+
+const TExpressionPtr& ApplicationExpression::GetChild(long index) const
+{
+   assert(index >= 0 && index < (long)m_children.size());
+   return m_children[index];
+}
+
+TExpressionPtr& ApplicationExpression::GetChild(long index)
+{
+   assert(index >= 0 && index < (long)m_children.size());
+   return m_children[index];
+}
+
+const TExpressionPtrVector& ApplicationExpression::GetChildren() const
+{
+   return m_children;
+}
+
+std::string ApplicationExpression::ToString() const
+{
+   std::string ret = m_variable->GetName();
+
+   if (m_children.empty())
+   {
+      return ret;
+   }
+
+   ret += "(";
+   for (auto it = m_children.cbegin(); it != m_children.cend(); ++it)
+   {
+      if (it != m_children.cbegin())
+      {
+         ret += ", ";
+      }
+      ret += (*it)->ToString();
+   }
+   ret += ")";
+
+   return ret;
+}
+
+TExpressionPtr ApplicationExpression::Clone() const
+{
+   return TExpressionPtr(new ApplicationExpression(*this));
+}
+
+TExpressionPtr ApplicationExpression::CloneWithSubstitution(
+   const TExpressionPtrVector& actual_params) const
+{
+   return TExpressionPtr(new ApplicationExpression(*this, actual_params));
+}
+
+namespace
+{
+
+void ExpandApplicationsImpl(TExpressionPtr& expr)
+{
+   switch (expr->GetType())
+   {
+      case ExpressionType::Operation:
+      {
+         auto& expression = CastToOperation(expr);
+         for (auto index = 0L; index < expression.GetChildCount(); ++index)
+         {
+            ExpandApplicationsImpl(expression.GetChild(index));
+         }
+         break;
+      }
+
+      case ExpressionType::Application:
+      {
+         auto& expression = CastToApplication(expr);
+         for (auto index = 0L; index < expression.GetChildCount(); ++index)
+         {
+            ExpandApplicationsImpl(expression.GetChild(index));
+         }
+
+         // Expression of the applied variable can contain applications too,
+         // which get already expanded actual parameters.
+         auto expanded = expression.GetVariable().GetExpression()->CloneWithSubstitution(expression.GetChildren());
+         ExpandApplicationsImpl(expanded);
+         expr = std::move(expanded);
+         break;
+      }
+
+      default:
+         break;
+   }
+}
+
+using TVariableSet = std::unordered_set<const Variable*>;
+
+void PrepareApplicationsImpl(const TExpressionPtr& expr, TVariableSet& prepared_variables)
+{
+   switch (expr->GetType())
+   {
+      case ExpressionType::Operation:
+      {
+         const auto& expression = CastToOperation(expr);
+         for (auto index = 0L; index < expression.GetChildCount(); ++index)
+         {
+            PrepareApplicationsImpl(expression.GetChild(index), prepared_variables);
+         }
+         break;
+      }
+
+      case ExpressionType::Application:
+      {
+         const auto& expression = CastToApplication(expr);
+         for (auto index = 0L; index < expression.GetChildCount(); ++index)
+         {
+            PrepareApplicationsImpl(expression.GetChild(index), prepared_variables);
+         }
+
+         // Expression of each applied variable is visited once.
+         const auto& variable = expression.GetVariable();
+         if (prepared_variables.insert(&variable).second)
+         {
+            variable.PrepareApplication();
+            PrepareApplicationsImpl(variable.GetExpression(), prepared_variables);
+         }
+         break;
+      }
+
+      default:
+         break;
+   }
+}
+
+} // namespace
+
+bool ContainsApplications(const TExpressionPtr& expr)
+{
+   assert(expr.get() != nullptr);
+
+   switch (expr->GetType())
+   {
+      case ExpressionType::Operation:
+      {
+         const auto& expression = CastToOperation(expr);
+         for (auto index = 0L; index < expression.GetChildCount(); ++index)
+         {
+            if (ContainsApplications(expression.GetChild(index)))
+            {
+               return true;
+            }
+         }
+         return false;
+      }
+
+      case ExpressionType::Application:
+         return true;
+
+      default:
+         return false;
+   }
+}
+
+void PrepareApplications(const TExpressionPtr& expr)
+{
+   assert(expr.get() != nullptr);
+
+   TVariableSet prepared_variables;
+   PrepareApplicationsImpl(expr, prepared_variables);
+}
+
+void ExpandApplications(TExpressionPtr& expr)
+{
+   if (!ContainsApplications(expr))
+   {
+      return;
+   }
+
+   ExpandApplicationsImpl(expr);
+
+   NormalizeExpression(expr);
+   SimplifyExpression(expr);
+}
+
+} // namespace dm
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "expression_base.h"
+
+#include <memory>
+
+namespace dm
+{
+
+class Variable;
+using TConstVariableSharedPtr = std::shared_ptr<const Variable>;
+
+// Application of a declared variable to actual parameters, that is expanded on demand
+// instead of copying the expression of the variable. The applied variable is kept alive
+// by the application, even if it's removed from the variable manager.
+class ApplicationExpression : public TypedExpression<ExpressionType::Application>
+{
+   using Base = TypedExpression<ExpressionType::Application>;
+
+public:
+   ApplicationExpression(const TConstVariableSharedPtr& variable, TExpressionPtrVector&& actual_params);
+
+   const Variable& GetVariable() const;
+
+   long GetChildCount() const;
+   const TExpressionPtr& GetChild(long index) const;
+   TExpressionPtr& GetChild(long index);
+   const TExpressionPtrVector& GetChildren() const;
+
+   // IStringable
+   virtual std::string ToString() const override;
+
+   // Expression
+   virtual TExpressionPtr Clone() const override;
+   virtual TExpressionPtr CloneWithSubstitution(const TExpressionPtrVector& actual_params) const override;
+
+private:
+   ApplicationExpression(const ApplicationExpression& rhs);
+   ApplicationExpression(const ApplicationExpression& rhs, const TExpressionPtrVector& actual_params);
+   ApplicationExpression& operator=(const ApplicationExpression& rhs) = delete;
+
+private:
+   TConstVariableSharedPtr m_variable;
+   TExpressionPtrVector m_children;
+};
+
+// Returns true if the expression tree contains applications. Expressions
+// of applied variables are not checked.
+bool ContainsApplications(const TExpressionPtr& expr);
+
+// Prepares applied variables of all applications, including applications in expressions
+// of applied variables, so the expression can be calculated from concurrent threads.
+void PrepareApplications(const TExpressionPtr& expr);
+
+// Replaces all applications by expressions of applied variables with substituted
+// actual parameters, then normalizes and simplifies the expression as the parser does.
+void ExpandApplications(TExpressionPtr& expr);
+
+} // namespace dm
@@ -12,7 +12,8 @@ enum class ExpressionType
 {
    Literal,
    ParamRef,
-   Operation
+   Operation,
+   Application
 };
 
 class Expression;
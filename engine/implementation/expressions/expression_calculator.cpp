@@ -3,7 +3,9 @@
 #include "expressions.h"
 
 #include "../common/local_array.h"
+#include "../variables/variable.h"
 
+#include <vector>
 #include <cassert>
 
 namespace dm
@@ -44,6 +46,86 @@ LiteralType CalculateExpression(const TExpressionPtr& expr, const LiteralType pa
          break;
       }
 
+      case ExpressionType::Application:
+      {
+         // Actual parameters are calculated once and bound as parameters
+         // of the applied variable, so its expression is not copied.
+         auto& expression = CastToApplication(expr);
+         const auto child_count = expression.GetChildCount();
+
+         LOCAL_ARRAY(LiteralType, frame, child_count);
+         for (auto index = 0L; index < child_count; ++index)
+         {
+            frame[index] = CalculateExpression(expression.GetChild(index), param_values);
+         }
+
+         value = CalculateExpression(expression.GetVariable().GetExpression(), frame);
+
+         break;
+      }
+
+      default:
+      {
+         assert(!"Unknown type of expression");
+      }
+   }
+
+   return value;
+}
+
+TBitBlock CalculateExpression(const TExpressionPtr& expr, const TBitBlock param_values[])
+{
+   assert(expr.get() != nullptr);
+
+   TBitBlock value = g_bit_block_false;
+   switch (expr->GetType())
+   {
+      case ExpressionType::Literal:
+      {
+         value = LiteralTypeToBitBlock(CastToLiteral(expr).GetLiteral());
+         break;
+      }
+
+      case ExpressionType::ParamRef:
+      {
+         value = param_values[CastToParamRef(expr).GetParamIndex()];
+         break;
+      }
+
+      case ExpressionType::Operation:
+      {
+         auto& expression = CastToOperation(expr);
+         const auto child_count = expression.GetChildCount();
+
+         LOCAL_ARRAY(TBitBlock, child_values, child_count);
+         for (auto index = child_count - 1; index >= 0; --index)
+         {
+            child_values[index] = CalculateExpression(expression.GetChild(index), param_values);
+         }
+
+         value = PerformOperation(expression.GetOperation(), child_values, child_count);
+
+         break;
+      }
+
+      case ExpressionType::Application:
+      {
+         // Actual parameters are calculated once and bound as parameters
+         // of the applied variable, so its expression is not copied.
+         auto& expression = CastToApplication(expr);
+         const auto child_count = expression.GetChildCount();
+
+         LOCAL_ARRAY(TBitBlock, frame, child_count);
+         for (auto index = 0L; index < child_count; ++index)
+         {
+            frame[index] = CalculateExpression(expression.GetChild(index), param_values);
+         }
+
+         value = CalculateExpression(expression.GetVariable().GetExpression(), frame);
+
+         break;
+      }
+
       default:
       {
          assert(!"Unknown type of expression");
@@ -53,4 +135,43 @@ LiteralType CalculateExpression(const TExpressionPtr& expr, const LiteralType pa
    return value;
 }
 
+TBitBlock CalculateExpression(const FlatExpression& expr, const TBitBlock param_values[])
+{
+   const auto node_count = expr.GetNodeCount();
+   assert(node_count > 0);
+
+   std::vector<TBitBlock> values(node_count);
+   std::vector<TBitBlock> child_values;
+
+   for (auto node = 0L; node < node_count; ++node)
+   {
+      switch (expr.GetType(node))
+      {
+         case ExpressionType::Literal:
+            values[node] = LiteralTypeToBitBlock(expr.GetLiteral(node));
+            break;
+
+         case ExpressionType::ParamRef:
+            values[node] = param_values[expr.GetParamIndex(node)];
+            break;
+
+         default:
+         {
+            const auto child_count = expr.GetChildCount(node);
+
+            child_values.resize(child_count);
+            for (auto index = 0L; index < child_count; ++index)
+            {
+               child_values[index] = values[expr.GetChild(node, index)];
+            }
+
+            values[node] = PerformOperation(expr.GetOperation(node), child_values.data(), child_count);
+            break;
+         }
+      }
+   }
+
+   return values.back();
+}
+
 } // namespace dm
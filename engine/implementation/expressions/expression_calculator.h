@@ -1,6 +1,7 @@
 #pragma once
 
 #include "expression_base.h"
+#include "expression_flat.h"
 #include "../common/literals.h"
 
 namespace dm
@@ -8,4 +9,11 @@ namespace dm
 
 LiteralType CalculateExpression(const TExpressionPtr& expr, const LiteralType param_values[]);
 
+// Calculates expression for a block of combinations at once, using bit-sliced
+// parameter values (see BitCombinationGenerator).
+TBitBlock CalculateExpression(const TExpressionPtr& expr, const TBitBlock param_values[]);
+
+// Calculates nodes of the flat expression by a single scan in their order.
+TBitBlock CalculateExpression(const FlatExpression& expr, const TBitBlock param_values[]);
+
 } // namespace dm
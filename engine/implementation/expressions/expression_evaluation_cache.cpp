@@ -0,0 +1,105 @@
+#include "expression_evaluation_cache.h"
+
+#include <iterator>
+#include <cassert>
+
+namespace dm
+{
+
+EvaluationCache& EvaluationCache::GetInstance()
+{
+   static EvaluationCache cache;
+   return cache;
+}
+
+EvaluationCache::EvaluationCache() :
+   m_mutex(), m_size_limit(0), m_hit_count(0), m_miss_count(0), m_entries(), m_entry_map()
+{
+   // Cached nodes are removed from the unique table on release,
+   // so the table must be destroyed after the cache.
+   UniqueExpressionTable::GetInstance();
+}
+
+void EvaluationCache::SetSizeLimit(long size_limit)
+{
+   assert(size_limit >= 0);
+
+   TEntryList dropped_entries;
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_size_limit = size_limit;
+      m_hit_count = 0;
+      m_miss_count = 0;
+      DropExcessEntries(dropped_entries);
+   }
+}
+
+long EvaluationCache::GetSizeLimit() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_size_limit;
+}
+
+TUniqueExpressionPtr EvaluationCache::Find(const TUniqueExpressionPtr& expr)
+{
+   assert(expr.get() != nullptr);
+   std::lock_guard<std::mutex> lock(m_mutex);
+
+   const auto iter = m_entry_map.find(expr.get());
+   if (iter == m_entry_map.end())
+   {
+      ++m_miss_count;
+      return TUniqueExpressionPtr();
+   }
+
+   ++m_hit_count;
+   m_entries.splice(m_entries.begin(), m_entries, iter->second);
+   return iter->second->evaluated_expr;
+}
+
+void EvaluationCache::Add(const TUniqueExpressionPtr& expr, const TUniqueExpressionPtr& evaluated_expr)
+{
+   assert(expr.get() != nullptr && evaluated_expr.get() != nullptr);
+
+   TEntryList dropped_entries;
+   {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      if (0 == m_size_limit || m_entry_map.count(expr.get()) > 0)
+      {
+         return;
+      }
+
+      m_entries.push_front(Entry{ expr, evaluated_expr });
+      m_entry_map.emplace(expr.get(), m_entries.begin());
+      DropExcessEntries(dropped_entries);
+   }
+}
+
+void EvaluationCache::DropExcessEntries(TEntryList& dropped_entries)
+{
+   while (static_cast<long>(m_entries.size()) > m_size_limit)
+   {
+      m_entry_map.erase(m_entries.back().expr.get());
+      dropped_entries.splice(dropped_entries.end(), m_entries, std::prev(m_entries.end()));
+   }
+}
+
+long EvaluationCache::GetSize() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_entries.size();
+}
+
+long EvaluationCache::GetHitCount() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_hit_count;
+}
+
+long EvaluationCache::GetMissCount() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_miss_count;
+}
+
+} // namespace dm
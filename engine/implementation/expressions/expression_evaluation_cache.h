@@ -0,0 +1,61 @@
+#pragma once
+
+#include "expression_unique_table.h"
+#include "../common/noncopyable.h"
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace dm
+{
+
+// Engine-wide cache of evaluated subexpressions, that is shared by all variables.
+// Subexpressions are hash-consed, so structurally identical ones are the same node,
+// and parameters are represented by indexes, as evaluation doesn't depend on names.
+// Least recently used entries are dropped, when the size limit is exceeded.
+// The cache is disabled by the zero size limit (default).
+class EvaluationCache : public NonCopyable
+{
+public:
+   static EvaluationCache& GetInstance();
+
+   // Entries over the new limit are dropped, counters are reset.
+   void SetSizeLimit(long size_limit);
+   long GetSizeLimit() const;
+
+   // Returns evaluated expression or nullptr, if the expression isn't cached.
+   TUniqueExpressionPtr Find(const TUniqueExpressionPtr& expr);
+   void Add(const TUniqueExpressionPtr& expr, const TUniqueExpressionPtr& evaluated_expr);
+
+   long GetSize() const;
+   long GetHitCount() const;
+   long GetMissCount() const;
+
+private:
+   EvaluationCache();
+
+   struct Entry
+   {
+      TUniqueExpressionPtr expr;
+      TUniqueExpressionPtr evaluated_expr;
+   };
+
+   // The most recently used entry is the first one.
+   using TEntryList = std::list<Entry>;
+   using TEntryMap = std::unordered_map<const UniqueExpression*, TEntryList::iterator>;
+
+   // Moves the least recently used entries over the limit to dropped_entries,
+   // so their nodes are released after the lock is freed.
+   void DropExcessEntries(TEntryList& dropped_entries);
+
+private:
+   mutable std::mutex m_mutex;
+   long m_size_limit;
+   long m_hit_count;
+   long m_miss_count;
+   TEntryList m_entries;
+   TEntryMap m_entry_map;
+};
+
+} // namespace dm
@@ -1,17 +1,118 @@
 #include "expression_evaluator.h"
+#include "expression_evaluation_cache.h"
+#include "expression_unique_table.h"
 #include "expression_utils.h"
 #include "expressions.h"
 
 #include "../common/local_array.h"
+#include "../common/small_vector.h"
+#include "../forms/consensus.h"
 
 #include <algorithm>
 #include <cassert>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 namespace dm
 {
 
 namespace
 {
+
+// Literals and parameters are always evaluated.
+bool IsEvaluated(const TExpressionPtr& expr)
+{
+   return (expr->GetType() != ExpressionType::Operation) || CastToOperation(expr).IsEvaluated();
+}
+
+void MarkEvaluated(TExpressionPtr& expr)
+{
+   if (expr->GetType() == ExpressionType::Operation)
+   {
+      auto& expression = CastToOperation(expr);
+      for (auto index = expression.GetChildCount() - 1; index >= 0; --index)
+      {
+         MarkEvaluated(expression.GetChild(index));
+      }
+      expression.SetEvaluated(true);
+   }
+}
+
+// Mark of an operation is reset by any access to its non-constant operand, so changes,
+// made by the evaluation of the operation, are found by comparison of its operands.
+// Literals and parameter references are immutable, so they are changed by replacement
+// only, and a replacing operand can take the memory of the replaced one, so their
+// values are compared too. Changed operations reset their own marks.
+struct OperandState
+{
+   const Expression* expr;
+   LiteralType literal;
+   long param_index;
+};
+
+using TOperandStates = SmallVector<OperandState, 4>;
+
+void GetOperandStates(const OperationExpression& expression, TOperandStates& states)
+{
+   for (auto index = 0L; index < expression.GetChildCount(); ++index)
+   {
+      const auto& child = expression.GetChild(index);
+      states.push_back(OperandState{ child.get(), GetLiteral(child), GetParamIndex(child) });
+   }
+}
+
+bool AreOperandStatesEqual(const OperationExpression& expression, const TOperandStates& states)
+{
+   if (expression.GetChildCount() != static_cast<long>(states.size()))
+   {
+      return false;
+   }
+
+   for (auto index = 0L; index < expression.GetChildCount(); ++index)
+   {
+      const auto& child = expression.GetChild(index);
+      const auto& state = states[index];
+      if (child.get() != state.expr || GetLiteral(child) != state.literal || GetParamIndex(child) != state.param_index)
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+// Hash-consed operation before the evaluation and amount of operations in its subtree,
+// so keys of the subtree can be skipped, when the operation is taken from the cache.
+struct CacheKey
+{
+   TUniqueExpressionPtr expr;
+   long operation_count;
+};
+
+// Keys are made in the same order, as operations are evaluated: parent
+// operation goes before its operands, operands go from the last one.
+TUniqueExpressionPtr MakeCacheKeys(const TExpressionPtr& expr, std::vector<CacheKey>& keys)
+{
+   if (expr->GetType() != ExpressionType::Operation)
+   {
+      return InternExpression(expr);
+   }
+
+   const auto& expression = CastToOperation(expr);
+   const auto position = keys.size();
+   keys.emplace_back();
+
+   TUniqueExpressionPtrVector children(expression.GetChildCount());
+   for (auto index = expression.GetChildCount() - 1; index >= 0; --index)
+   {
+      children[index] = MakeCacheKeys(expression.GetChild(index), keys);
+   }
+
+   auto& key = keys[position];
+   key.expr = UniqueExpressionTable::GetInstance().MakeOperation(expression.GetOperation(), std::move(children));
+   key.operation_count = keys.size() - position;
+   return key.expr;
+}
    
 class ExpressionEvaluator
 {
@@ -21,8 +122,18 @@ public:
    // Returns information about whether current expression
    // has been fully evaluated to a certain other expression.
    bool Evaluate(TExpressionPtr& expr);
+
+   // Evaluates operands first and then the operation to the fixpoint, so results
+   // of all operations can be cached. Cached operations are replaced by their results
+   // without evaluation. key is moved through keys, made by MakeCacheKeys.
+   bool EvaluateWithCache(TExpressionPtr& expr, const VariableDeclaration& variable,
+                          EvaluationCache& cache, const CacheKey*& key);
    
 private:
+   // Merges the replaced operand with the operation, if they are the same,
+   // and moves the replacing literal to the end of the operation.
+   void NormalizeReplacedOperand(OperationExpression& expression, long child_index);
+
    void EvaluateOperation(OperationExpression& expression);
 
    // Following methods are called from EvaluateOperation, using pointer.
@@ -54,8 +165,6 @@ private:
 
    // Appies absorption/gluing laws while it is possible.
    void ApplyAbsorptionGluingLaws(OperationExpression& expression, LiteralType remaining_literal);
-   // Single absorption/gluing laws applying. If any rule was applied, true is returned.
-   bool ApplyAbsorptionGluingLawsOnce(OperationExpression& expression);
 
    static void InPlaceSimplification(OperationExpression& expression, long child_index);
 
@@ -70,6 +179,7 @@ private:
                                       bool negated_child = false);
 
    // Utility
+   static bool AreOperandsEvaluated(const OperationExpression& expression);
    static bool IsNegationEquivalent(const TExpressionPtr& expr);
    static bool IsNegationEquivalent(const OperationExpression& expression);
    static bool IsShortNegationEquivalent(const TExpressionPtr& expr);
@@ -79,6 +189,71 @@ private:
    static bool IsShortNegationEquivalentWithChildOperation(
       const OperationExpression& expression, OperationType operation);
 
+   // Structural hashes are consistent with comparisons below: equal expressions (IsEqual)
+   // have equal structural hashes, and expressions, which are negations of each other
+   // (CheckNegNotNeg, CheckNegNotNegDeMorgan), have equal parameter hashes.
+   // Parameters mask contains bit (i % 64) for each used parameter i, so the mask
+   // of an included operand is a subset of the mask of the including one.
+   struct ExpressionHash
+   {
+      std::size_t structural;
+      std::size_t params;
+      std::uint64_t params_mask;
+   };
+
+   struct HashedChild
+   {
+      std::size_t hash;
+      long index;
+   };
+
+   static ExpressionHash GetHash(const TExpressionPtr& expr);
+   static ExpressionHash GetHash(const OperationExpression& expression);
+   static std::size_t MixHash(std::size_t value);
+
+   // Fills hashed_children with first amount children of the expression, sorted by hash
+   // and index, so children, that can be equal (or reverse), form contiguous groups.
+   static void SortChildrenByHash(const OperationExpression& expression, long amount,
+                                  bool use_params_hash, HashedChild* hashed_children);
+   static long GetHashGroupEnd(const HashedChild* hashed_children, long count, long group_begin);
+   static void RemoveFlaggedChildren(OperationExpression& expression, const bool* flags);
+
+   // Removes pairs of children, satisfying to the comparator. Each child is paired with
+   // the nearest preceding unpaired one, as in the pairwise scan from the last child.
+   // Returns amount of removed pairs.
+   static long RemovePairs(OperationExpression& expression, bool use_params_hash,
+      bool (*Comparator)(const TExpressionPtr&, const TExpressionPtr&));
+
+   // Structural hash and parameters mask of the operand and,
+   // for the given operation, hashes of its children.
+   // changed_pass is the last pass of absorption/gluing, which has changed the operand.
+   struct OperandHashes
+   {
+      std::size_t hash;
+      std::uint64_t params_mask;
+      std::vector<HashedChild> hashed_children;
+      long changed_pass;
+   };
+
+   static OperandHashes GetOperandHashes(const TExpressionPtr& expr, OperationType operation);
+
+   // Single absorption/gluing laws applying. Only pairs with an operand, changed since
+   // the previous pass, are checked, since other pairs have been checked already.
+   // If any operand was changed by gluing, true is returned.
+   bool ApplyAbsorptionGluingLawsOnce(OperationExpression& expression,
+                                      std::vector<OperandHashes>& operand_hashes, long pass);
+
+   // Links children of "enclosing" to children of "enveloping" with the same hashes in the
+   // same order, as the pairwise scan from the last children does. As both arrays are sorted
+   // by hash, it is a merge of them. linked_flags are indexed by positions in enveloping_hashed.
+   // Returns false, if more than max_unlinked_count children of "enclosing" are not linked.
+   // Index of the last not linked child is stored to unlinked_index.
+   static bool LinkSortedChildren(
+      const OperationExpression& enclosing, const HashedChild* enclosing_hashed, long enclosing_amount,
+      const OperationExpression& enveloping, const HashedChild* enveloping_hashed, long enveloping_amount,
+      long skip_index, long max_unlinked_count, bool* linked_flags, long& unlinked_index,
+      bool (*Comparator)(const TExpressionPtr&, const TExpressionPtr&));
+
    static bool CheckNegNotNeg(const TExpressionPtr& expr1, const TExpressionPtr& expr2);
    static bool CheckNegNotNegCommon(const TExpressionPtr& neg_expr, const TExpressionPtr& expr);
    static bool CheckNegNotNegDeMorgan(const TExpressionPtr& expr1, const TExpressionPtr& expr2);
@@ -99,8 +274,11 @@ private:
 
    static bool IsEqual(const TExpressionPtr& left, const TExpressionPtr& right);
    static bool IsEqual(const OperationExpression& left, const OperationExpression& right);
-   static bool IsEqualToAnyChild(const TExpressionPtr& expr, 
-                                 const OperationExpression& expression);
+   // Children of the expression are compared only if their structural hashes
+   // are equal to expr_hash. hashed_children must be sorted by hash.
+   static bool IsEqualToAnyChild(const TExpressionPtr& expr, std::size_t expr_hash,
+                                 const OperationExpression& expression,
+                                 const std::vector<HashedChild>& hashed_children);
 
    static bool AreFirstChildrenEqual(const OperationExpression& left,
                                      const OperationExpression& right, long amount);
@@ -124,16 +302,56 @@ private:
    // in first enveloping_amount children of enveloping operation.
    // If skip_index is not -1, then skip_index-th child is to be skipped during
    // analyzing enveloping children.
+   // Children of movable operations are compared by hashes, that are consistent with the
+   // comparator: structural hashes for IsEqual or parameters hashes for CheckNegNotNeg.
    static bool AreFirstChildrenIncluded(
       const OperationExpression& enclosing, long enclosing_amount,
       const OperationExpression& enveloping, long enveloping_amount, long skip_index,
-      bool (*Comparator)(const TExpressionPtr&, const TExpressionPtr&));
+      bool use_params_hash, bool (*Comparator)(const TExpressionPtr&, const TExpressionPtr&));
+
+   // The same check for all children, sorted by structural hashes.
+   static bool AreChildrenIncludedByEquality(
+      const OperationExpression& enclosing, const std::vector<HashedChild>& enclosing_hashed,
+      const OperationExpression& enveloping, const std::vector<HashedChild>& enveloping_hashed);
 
    // Checks whether children of expression1 differ from children of expression2 by a single
    // item. If it is true, diff_index1 and diff_index2 are filled with differed indexes.
-   static bool DoChildrenDifferByOne(const OperationExpression& expression1,
-                                      const OperationExpression& expression2,
-                                      long& diff_index1, long& diff_index2);
+   // Children are sorted by structural hashes.
+   static bool DoChildrenDifferByOne(
+      const OperationExpression& expression1, const std::vector<HashedChild>& hashed_children1,
+      const OperationExpression& expression2, const std::vector<HashedChild>& hashed_children2,
+      long& diff_index1, long& diff_index2);
+
+   // Plus/equality chains are affine functions over GF(2): sums of atoms (operands, which
+   // are not chains, negations or literals) and a constant. Atoms are numbered in order
+   // of their first occurrence, equal atoms (IsEqual) share the same number.
+   struct AffineAtoms
+   {
+      std::vector<const TExpressionPtr*> exprs;
+      // Numbers of atoms by structural hashes.
+      std::unordered_multimap<std::size_t, long> numbers;
+   };
+
+   // Bit i of packed words is set, if i-th atom is in the sum.
+   struct AffineForm
+   {
+      std::vector<TBitBlock> words;
+      bool constant;
+   };
+
+   static bool IsParityChain(const TExpressionPtr& expr);
+   static long GetAtomNumber(const TExpressionPtr& expr, AffineAtoms& atoms);
+   // Adds the expression to the form, so the form is the sum of them.
+   static void AddToAffineForm(const TExpressionPtr& expr, AffineAtoms& atoms, AffineForm& form);
+
+   // Cancels atoms of nested plus/equality chains and rebuilds the expression as
+   // a flat chain of remaining atoms. Returns true, if the expression is evaluated to a literal.
+   bool ApplyLinearLaws(OperationExpression& expression);
+
+   // Removes operands of conjunction/disjunction, which parity chains of other operands
+   // imply, by Gaussian elimination over GF(2), or evaluates the expression
+   // to contradiction_literal, if parity chains contradict each other.
+   bool EliminateLinearDependencies(OperationExpression& expression, LiteralType contradiction_literal);
 
 private:
    // Will be filled with new evaluated expression if the whole
@@ -153,30 +371,39 @@ bool ExpressionEvaluator::Evaluate(TExpressionPtr& expr)
    }
 
    auto& expression = CastToOperation(expr);
-   const auto operation = expression.GetOperation();
-   const auto are_operands_movable = AreOperandsMovable(operation);
+   if (expression.IsEvaluated())
+   {
+      // Neither the operation, nor its operands were changed since the evaluation.
+      return false;
+   }
 
+   // Evaluation of an operation can change it to the operation of its parent in place,
+   // so such operands are merged with the parent too, as well as replaced ones.
+   const auto& const_expression = expression;
    for (auto index = expression.GetChildCount() - 1; index >= 0; --index)
    {
-      auto& child = expression.GetChild(index);
-
-      if (Evaluate(child) &&
-          OperationType::Negation != operation && GetOperation(child) == operation)
+      if (Evaluate(expression.GetChild(index)) ||
+          GetOperation(const_expression.GetChild(index)) == expression.GetOperation())
       {
-         // In-place simplification
-         if (are_operands_movable)
-         {
-            InPlaceSimplification(expression, index);
-         }
-
-         // In-place normalization
-         if ((are_operands_movable || 0 == index))
-         {
-            MoveChildExpressionsUp(expression, index);
-         }
+         NormalizeReplacedOperand(expression, index);
       }
    }
 
+   // Operation is left with the only operand, when replaced literals are combined.
+   if (expression.GetOperation() != OperationType::Negation && expression.GetChildCount() == 1)
+   {
+      expr = std::move(expression.GetChild(0));
+      return true;
+   }
+
+   const auto operation = expression.GetOperation();
+   const auto are_operands_evaluated = AreOperandsEvaluated(expression);
+   TOperandStates operand_states;
+   if (are_operands_evaluated)
+   {
+      GetOperandStates(expression, operand_states);
+   }
+
    EvaluateOperation(expression);
 
    if (m_evaluated_expression.get() != nullptr)
@@ -185,9 +412,133 @@ bool ExpressionEvaluator::Evaluate(TExpressionPtr& expr)
       return true;
    }
 
+   // Evaluation of the operation doesn't reach a fixpoint at once, so the operation
+   // is marked as evaluated only if the evaluation didn't change it. Otherwise it and
+   // its changed operands are to be evaluated again.
+   expression.SetEvaluated(are_operands_evaluated &&
+                           expression.GetOperation() == operation &&
+                           AreOperandStatesEqual(expression, operand_states) &&
+                           AreOperandsEvaluated(expression));
+
    return false;
 }
 
+bool ExpressionEvaluator::EvaluateWithCache(TExpressionPtr& expr, const VariableDeclaration& variable,
+                                            EvaluationCache& cache, const CacheKey*& key)
+{
+   if (expr->GetType() != ExpressionType::Operation)
+   {
+      return false;
+   }
+
+   const auto& cache_key = *key;
+   auto evaluated_expr = cache.Find(cache_key.expr);
+   if (evaluated_expr.get() != nullptr)
+   {
+      key += cache_key.operation_count;
+      expr = ExpandExpression(evaluated_expr, variable);
+      MarkEvaluated(expr);
+      return true;
+   }
+   ++key;
+
+   auto& expression = CastToOperation(expr);
+   for (auto index = expression.GetChildCount() - 1; index >= 0; --index)
+   {
+      if (EvaluateWithCache(expression.GetChild(index), variable, cache, key))
+      {
+         NormalizeReplacedOperand(expression, index);
+      }
+   }
+
+   // Operands are already evaluated, so only the operation itself and
+   // operands, changed by it, are evaluated here.
+   auto is_replaced = false;
+   while (true)
+   {
+      if (Evaluate(expr))
+      {
+         is_replaced = true;
+      }
+      else if (IsEvaluated(expr))
+      {
+         break;
+      }
+   }
+
+   cache.Add(cache_key.expr, InternExpression(expr));
+   return is_replaced;
+}
+
+void ExpressionEvaluator::NormalizeReplacedOperand(OperationExpression& expression, long child_index)
+{
+   const auto operation = expression.GetOperation();
+   if (OperationType::Negation == operation)
+   {
+      return;
+   }
+
+   const auto are_operands_movable = AreOperandsMovable(operation);
+
+   // Literal can be only the last operand of a simplified operation, so the replacing
+   // literal is moved to the end and is combined with the last literal, if it exists.
+   const auto& const_expression = expression;
+   const auto literal = GetLiteral(const_expression.GetChild(child_index));
+   if (are_operands_movable && LiteralType::None != literal)
+   {
+      const auto last_index = expression.GetChildCount() - 1;
+      if (child_index == last_index)
+      {
+         return;
+      }
+
+      const auto last_literal = GetLiteral(const_expression.GetChild(last_index));
+      if (LiteralType::None != last_literal)
+      {
+         const LiteralType literals[] = { literal, last_literal };
+         expression.GetChild(last_index) = std::make_unique<LiteralExpression>(
+            PerformOperation(operation, literals, 2));
+         expression.RemoveChild(child_index);
+      }
+      else
+      {
+         auto literal_expr = std::move(expression.GetChild(child_index));
+         expression.RemoveChild(child_index);
+         expression.AddChild(std::move(literal_expr));
+      }
+      return;
+   }
+
+   if (GetOperation(expression.GetChild(child_index)) != operation)
+   {
+      return;
+   }
+
+   // In-place simplification
+   if (are_operands_movable)
+   {
+      InPlaceSimplification(expression, child_index);
+   }
+
+   // In-place normalization
+   if ((are_operands_movable || 0 == child_index))
+   {
+      MoveChildExpressionsUp(expression, child_index);
+   }
+}
+
+bool ExpressionEvaluator::AreOperandsEvaluated(const OperationExpression& expression)
+{
+   for (auto index = expression.GetChildCount() - 1; index >= 0; --index)
+   {
+      if (!IsEvaluated(expression.GetChild(index)))
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
 void ExpressionEvaluator::EvaluateOperation(OperationExpression& expression)
 {
    using TEvaluateMetodPtr = void(ExpressionEvaluator::*)(OperationExpression& expression);
@@ -219,8 +570,19 @@ void ExpressionEvaluator::EvaluateNegation(OperationExpression& expression)
 {
    assert(expression.GetChildCount() == 1);
 
-   // We have the only rule:
+   // We have following rules:
    //    1. !!x  => x
+   //    2. !0   => 1, !1 => 0
+
+   // According to rule 2, evaluate negation of the literal, which replaced the operand.
+   const auto& const_expression = expression;
+   const auto literal = GetLiteral(const_expression.GetChild(0));
+   if (LiteralType::None != literal)
+   {
+      m_evaluated_expression = std::make_unique<LiteralExpression>(
+         PerformOperation(OperationType::Negation, &literal, 1));
+      return;
+   }
 
    // The nested negation can be treated as negation equivalent.
    auto& child = expression.GetChild(0);
@@ -265,6 +627,14 @@ void ExpressionEvaluator::EvaluateConjunction(OperationExpression& expression)
 
    // According to rule 3, remove all duplicates.
    RemoveDuplicates(expression);
+
+   // Parity chains are solved as linear equations: according to rule 2, remove operands,
+   // that are implied by other ones, and according to rule 4, evaluate expression
+   // to literal 0, if they contradict each other.
+   if (EliminateLinearDependencies(expression, LiteralType::False))
+   {
+      return;
+   }
    
    // According to rule 4, evaluate expression to literal 0
    // if there exists !x and grouped subset that equals to x.
@@ -306,6 +676,14 @@ void ExpressionEvaluator::EvaluateDisjunction(OperationExpression& expression)
 
    // According to rule 3, remove all duplicates.
    RemoveDuplicates(expression);
+
+   // Parity chains are solved as linear equations: according to rule 2, remove operands,
+   // that are implied by other ones, and according to rule 4, evaluate expression
+   // to literal 1, if they contradict each other.
+   if (EliminateLinearDependencies(expression, LiteralType::True))
+   {
+      return;
+   }
    
    // According to rule 4, evaluate expression to literal 1
    // if there exists !x and grouped subset that equals to x.
@@ -495,6 +873,13 @@ void ExpressionEvaluator::EvaluateEquality(OperationExpression& expression)
    // and reduce the only remaining negation (if exists) with literal 0.
    RemoveNegations(expression, LiteralType::False);
 
+   // Nested plus/equality chains are merged into the single sum modulo 2.
+   // The merged chain can be turned into plus, so it is evaluated again then.
+   if (ApplyLinearLaws(expression) || expression.GetOperation() != OperationType::Equality)
+   {
+      return;
+   }
+
    // According to rule 3 and 1, remove duplicates
    // and assign leteral 1 if all operands were removed.
    if (AbsorbDuplicates(expression, LiteralType::True))
@@ -530,6 +915,13 @@ void ExpressionEvaluator::EvaluatePlus(OperationExpression& expression)
    // and reduce the only remaining negation (if exists) with literal 1.
    RemoveNegations(expression, LiteralType::True);
 
+   // Nested plus/equality chains are merged into the single sum modulo 2.
+   // The merged chain can be turned into equality, so it is evaluated again then.
+   if (ApplyLinearLaws(expression) || expression.GetOperation() != OperationType::Plus)
+   {
+      return;
+   }
+
    // According to rule 3 and 1, remove duplicates
    // and assign leteral 0 if all operands were removed.
    if (AbsorbDuplicates(expression, LiteralType::False))
@@ -547,6 +939,219 @@ void ExpressionEvaluator::EvaluatePlus(OperationExpression& expression)
    MakeNegationRepresentative(expression);
 }
 
+bool ExpressionEvaluator::IsParityChain(const TExpressionPtr& expr)
+{
+   auto operation = GetOperation(expr);
+   if (OperationType::Negation == operation)
+   {
+      operation = GetOperation(CastToOperation(expr).GetChild(0));
+   }
+   return OperationType::Plus == operation || OperationType::Equality == operation;
+}
+
+long ExpressionEvaluator::GetAtomNumber(const TExpressionPtr& expr, AffineAtoms& atoms)
+{
+   const auto hash = GetHash(expr).structural;
+   const auto range = atoms.numbers.equal_range(hash);
+   for (auto it = range.first; it != range.second; ++it)
+   {
+      if (IsEqual(*atoms.exprs[it->second], expr))
+      {
+         return it->second;
+      }
+   }
+
+   const auto number = static_cast<long>(atoms.exprs.size());
+   atoms.exprs.push_back(&expr);
+   atoms.numbers.emplace(hash, number);
+   return number;
+}
+
+void ExpressionEvaluator::AddToAffineForm(const TExpressionPtr& expr, AffineAtoms& atoms, AffineForm& form)
+{
+   // We have following rules:
+   //    1. !x                 => x + 1
+   //    2. (x1 = ... = xn)    => x1 + ... + xn + (n - 1)
+   //    3. (x + x)            => 0
+
+   if (ExpressionType::Literal == expr->GetType())
+   {
+      form.constant = (form.constant != (LiteralType::True == GetLiteral(expr)));
+      return;
+   }
+
+   const auto operation = GetOperation(expr);
+   if (OperationType::Negation == operation ||
+       OperationType::Plus == operation ||
+       OperationType::Equality == operation)
+   {
+      const auto& expression = CastToOperation(expr);
+      const auto child_count = expression.GetChildCount();
+      if (OperationType::Negation == operation ||
+          (OperationType::Equality == operation && 0 == (child_count & 1)))
+      {
+         form.constant = !form.constant;
+      }
+      for (auto index = 0L; index < child_count; ++index)
+      {
+         AddToAffineForm(expression.GetChild(index), atoms, form);
+      }
+      return;
+   }
+
+   const auto number = GetAtomNumber(expr, atoms);
+   const auto word_index = static_cast<std::size_t>(number / g_bit_block_size);
+   if (word_index >= form.words.size())
+   {
+      form.words.resize(word_index + 1, 0);
+   }
+   form.words[word_index] ^= TBitBlock(1) << (number % g_bit_block_size);
+}
+
+bool ExpressionEvaluator::ApplyLinearLaws(OperationExpression& expression)
+{
+   // The single chain with literals is left to the rules below, which keep its form.
+   const auto& const_expression = expression;
+   auto has_nested_chains = false;
+   auto non_literal_count = 0L;
+   for (auto index = expression.GetChildCount() - 1; index >= 0; --index)
+   {
+      const auto& child = const_expression.GetChild(index);
+      has_nested_chains = has_nested_chains || IsParityChain(child);
+      non_literal_count += (ExpressionType::Literal != child->GetType()) ? 1 : 0;
+   }
+   if (!has_nested_chains || non_literal_count < 2)
+   {
+      return false;
+   }
+
+   // The expression is the sum of its operands with the constant of rule 2.
+   AffineAtoms atoms;
+   AffineForm form = { {}, false };
+   for (auto index = 0L; index < expression.GetChildCount(); ++index)
+   {
+      AddToAffineForm(const_expression.GetChild(index), atoms, form);
+   }
+   if (OperationType::Equality == expression.GetOperation() && 0 == (expression.GetChildCount() & 1))
+   {
+      form.constant = !form.constant;
+   }
+
+   // Atoms are moved from the operands, which are replaced then.
+   TExpressionPtrVector children;
+   for (auto number = 0L; number < static_cast<long>(atoms.exprs.size()); ++number)
+   {
+      if (form.words[number / g_bit_block_size] & (TBitBlock(1) << (number % g_bit_block_size)))
+      {
+         children.push_back(std::move(const_cast<TExpressionPtr&>(*atoms.exprs[number])));
+      }
+   }
+
+   const auto atom_count = static_cast<long>(children.size());
+   if (0 == atom_count)
+   {
+      m_evaluated_expression = std::make_unique<LiteralExpression>(
+         form.constant ? LiteralType::True : LiteralType::False);
+      return true;
+   }
+
+   // Chain with less operands is chosen: the plus needs literal 1 for the constant,
+   // and the equality needs literal 0, when the constant differs from the parity of atom_count - 1.
+   const auto plus_count = atom_count + (form.constant ? 1 : 0);
+   const auto is_equality_literal_needed = (form.constant != (0 == (atom_count & 1)));
+   const auto equality_count = atom_count + (is_equality_literal_needed ? 1 : 0);
+   if (plus_count != equality_count)
+   {
+      expression.SetOperation(plus_count < equality_count ? OperationType::Plus : OperationType::Equality);
+   }
+
+   if (OperationType::Plus == expression.GetOperation() ? form.constant : is_equality_literal_needed)
+   {
+      children.push_back(std::make_unique<LiteralExpression>(
+         OperationType::Plus == expression.GetOperation() ? LiteralType::True : LiteralType::False));
+   }
+
+   expression.RemoveChildren(0, expression.GetChildCount());
+   expression.InsertChildren(0, std::move(children));
+   return false;
+}
+
+bool ExpressionEvaluator::EliminateLinearDependencies(OperationExpression& expression,
+                                                      LiteralType contradiction_literal)
+{
+   const auto child_count = expression.GetChildCount();
+   const auto& const_expression = expression;
+
+   auto has_chains = false;
+   for (auto index = child_count - 1; index >= 0 && !has_chains; --index)
+   {
+      has_chains = IsParityChain(const_expression.GetChild(index));
+   }
+   if (!has_chains)
+   {
+      return false;
+   }
+
+   // Each operand is an equation: its sum is equal to 1 in the conjunction, while all operands
+   // of the disjunction are equal to 0 unless it is true. The constant is moved to the right side.
+   const auto right_side = (LiteralType::False == contradiction_literal);
+   AffineAtoms atoms;
+   std::vector<AffineForm> equations(child_count, AffineForm{ {}, false });
+   for (auto index = 0L; index < child_count; ++index)
+   {
+      AddToAffineForm(const_expression.GetChild(index), atoms, equations[index]);
+      equations[index].constant = (equations[index].constant != right_side);
+   }
+
+   const auto word_count = (atoms.exprs.size() + g_bit_block_size - 1) / g_bit_block_size;
+   for (auto& equation : equations)
+   {
+      equation.words.resize(word_count, 0);
+   }
+
+   // Equations are reduced by preceding independent ones, which are kept by their
+   // lowest atoms. An equation, reduced to (0 = 0), is implied by preceding ones.
+   std::vector<long> reducing_equations(atoms.exprs.size(), -1);
+   LOCAL_ARRAY(bool, implied_flags, child_count);
+   for (auto index = 0L; index < child_count; ++index)
+   {
+      auto& equation = equations[index];
+      auto is_reduced = true;
+      for (auto word_index = size_t(0); word_index < word_count && is_reduced; ++word_index)
+      {
+         while (equation.words[word_index] != 0)
+         {
+            const auto number = static_cast<long>(word_index * g_bit_block_size) +
+                                FindFirstSetBit(equation.words[word_index]);
+            const auto reducing_index = reducing_equations[number];
+            if (reducing_index < 0)
+            {
+               reducing_equations[number] = index;
+               is_reduced = false;
+               break;
+            }
+
+            const auto& reducing = equations[reducing_index];
+            for (auto word = word_index; word < word_count; ++word)
+            {
+               equation.words[word] ^= reducing.words[word];
+            }
+            equation.constant = (equation.constant != reducing.constant);
+         }
+      }
+
+      if (is_reduced && equation.constant)
+      {
+         m_evaluated_expression = std::make_unique<LiteralExpression>(contradiction_literal);
+         return true;
+      }
+      implied_flags[index] = is_reduced;
+   }
+
+   RemoveFlaggedChildren(expression, implied_flags);
+   return false;
+}
+
 bool ExpressionEvaluator::MakeNegationRepresentative(OperationExpression& expression)
 {
    if (IsShortNegationEquivalent(expression))
@@ -589,14 +1194,25 @@ bool ExpressionEvaluator::RemoveAllIfLiteralExists(
 bool ExpressionEvaluator::RemoveAllIfNegNotNegExists(
    OperationExpression& expression, LiteralType remaining_literal)
 {
-   for (int i = expression.GetChildCount() - 1; i > 0; --i)
+   const auto child_count = expression.GetChildCount();
+
+   LOCAL_ARRAY(HashedChild, hashed_children, child_count);
+   SortChildrenByHash(expression, child_count, true, hashed_children);
+
+   for (auto group_begin = 0L, group_end = 0L; group_begin < child_count; group_begin = group_end)
    {
-      for (int j = i - 1; j >= 0; --j)
+      group_end = GetHashGroupEnd(hashed_children, child_count, group_begin);
+
+      for (auto i = group_end - 1; i > group_begin; --i)
       {
-         if (CheckNegNotNeg(expression.GetChild(i), expression.GetChild(j)))
+         for (auto j = i - 1; j >= group_begin; --j)
          {
-            m_evaluated_expression = std::make_unique<LiteralExpression>(remaining_literal);
-            return true;
+            if (CheckNegNotNeg(expression.GetChild(hashed_children[i].index),
+                               expression.GetChild(hashed_children[j].index)))
+            {
+               m_evaluated_expression = std::make_unique<LiteralExpression>(remaining_literal);
+               return true;
+            }
          }
       }
    }
@@ -616,34 +1232,40 @@ void ExpressionEvaluator::RemoveLiteralIfExists(
 
 void ExpressionEvaluator::RemoveDuplicates(OperationExpression& expression)
 {
-   for (auto i = expression.GetChildCount() - 1; i > 0; --i)
+   const auto child_count = expression.GetChildCount();
+
+   LOCAL_ARRAY(HashedChild, hashed_children, child_count);
+   SortChildrenByHash(expression, child_count, false, hashed_children);
+
+   LOCAL_ARRAY(bool, duplicate_flags, child_count);
+   std::fill_n(duplicate_flags, child_count, false);
+
+   // A child is a duplicate, if any preceding child is equal to it.
+   for (auto group_begin = 0L, group_end = 0L; group_begin < child_count; group_begin = group_end)
    {
-      for (auto j = i - 1; j >= 0; --j)
+      group_end = GetHashGroupEnd(hashed_children, child_count, group_begin);
+
+      for (auto i = group_begin + 1; i < group_end; ++i)
       {
-         if (IsEqual(expression.GetChild(i), expression.GetChild(j)))
+         for (auto j = group_begin; j < i; ++j)
          {
-            expression.RemoveChild(i);
-            break;
+            if (IsEqual(expression.GetChild(hashed_children[i].index),
+                        expression.GetChild(hashed_children[j].index)))
+            {
+               duplicate_flags[hashed_children[i].index] = true;
+               break;
+            }
          }
       }
    }
+
+   RemoveFlaggedChildren(expression, duplicate_flags);
 }
 
 bool ExpressionEvaluator::AbsorbDuplicates(
    OperationExpression& expression, LiteralType remaining_literal)
 {
-   for (auto i = expression.GetChildCount() - 1; i > 0; --i)
-   {
-      for (auto j = i - 1; j >= 0; --j)
-      {
-         if (IsEqual(expression.GetChild(i), expression.GetChild(j)))
-         {
-            expression.RemoveChild(i--);
-            expression.RemoveChild(j);
-            break;
-         }
-      }
-   }
+   RemovePairs(expression, false, ExpressionEvaluator::IsEqual);
 
    if (0 == expression.GetChildCount())
    {
@@ -685,21 +1307,8 @@ void ExpressionEvaluator::RemoveNegations(OperationExpression& expression, Liter
 bool ExpressionEvaluator::AbsorbNegNotNegs(
    OperationExpression& expression, LiteralType eq_to_neg_literal, LiteralType remaining_literal)
 {
-   bool is_negation_lonely = false;
-
-   for (auto i = expression.GetChildCount() - 1; i > 0; --i)
-   {
-      for (auto j = i - 1; j >= 0; --j)
-      {
-         if (CheckNegNotNegDeMorgan(expression.GetChild(i), expression.GetChild(j)))
-         {
-            expression.RemoveChild(i--);
-            expression.RemoveChild(j);
-            is_negation_lonely = !is_negation_lonely;
-            break;
-         }
-      }
-   }
+   const auto is_negation_lonely =
+      (RemovePairs(expression, true, ExpressionEvaluator::CheckNegNotNegDeMorgan) & 1) != 0;
 
    if (is_negation_lonely)
    {
@@ -744,15 +1353,32 @@ bool ExpressionEvaluator::CanBeGroupedAsNegNotNeg(const OperationExpression& exp
    const auto opposite_operation = GetOppositeOperation(expression.GetOperation());
    assert(OperationType::None != opposite_operation);
 
+   // Children of the current operation are sorted once for all opposite children.
+   LOCAL_ARRAY(HashedChild, hashed_children, child_count);
+   SortChildrenByHash(expression, child_count, true, hashed_children);
+
+   LOCAL_ARRAY(bool, linked_flags, child_count);
+
    for (auto index = child_count - 1; index >= 0; --index)
    {
       const auto& child_expr = expression.GetChild(index);
       if (GetOperation(child_expr) == opposite_operation)
       {
          const auto& child_expression = CastToOperation(child_expr);
-         if (AreFirstChildrenIncludedByNegNotNeg(
-               child_expression, child_expression.GetChildCount(),
-               expression, expression.GetChildCount(), index))
+         const auto grandchild_count = child_expression.GetChildCount();
+         if (grandchild_count > child_count - 1)
+         {
+            continue;
+         }
+
+         std::vector<HashedChild> hashed_grandchildren(grandchild_count);
+         SortChildrenByHash(child_expression, grandchild_count, true, hashed_grandchildren.data());
+
+         std::fill_n(linked_flags, child_count, false);
+         auto unlinked_index = -1L;
+         if (LinkSortedChildren(child_expression, hashed_grandchildren.data(), grandchild_count,
+                                expression, hashed_children, child_count, index, 0,
+                                linked_flags, unlinked_index, ExpressionEvaluator::CheckNegNotNeg))
          {
             return true;
          }
@@ -765,10 +1391,24 @@ bool ExpressionEvaluator::CanBeGroupedAsNegNotNeg(const OperationExpression& exp
 void ExpressionEvaluator::ApplyAbsorptionGluingLaws(
    OperationExpression& expression, LiteralType remaining_literal)
 {
-   while (ApplyAbsorptionGluingLawsOnce(expression));
+   const auto opposite_operation = GetOppositeOperation(expression.GetOperation());
+   assert(OperationType::None != opposite_operation);
+
+   // Hashes are updated together with children, so indexes are the same.
+   std::vector<OperandHashes> operand_hashes;
+   operand_hashes.reserve(expression.GetChildCount());
+   for (auto index = 0L; index < expression.GetChildCount(); ++index)
+   {
+      operand_hashes.push_back(GetOperandHashes(expression.GetChild(index), opposite_operation));
+   }
+
+   // Removing of operands can't make other pairs applicable, so the next pass
+   // is necessary only after gluing, and only for pairs with glued operands.
+   for (auto pass = 0L; ApplyAbsorptionGluingLawsOnce(expression, operand_hashes, pass); ++pass);
 }
 
-bool ExpressionEvaluator::ApplyAbsorptionGluingLawsOnce(OperationExpression& expression)
+bool ExpressionEvaluator::ApplyAbsorptionGluingLawsOnce(
+   OperationExpression& expression, std::vector<OperandHashes>& operand_hashes, long pass)
 {
    // Absorptions laws are:
    //    1. x | (x & y) => x
@@ -781,55 +1421,73 @@ bool ExpressionEvaluator::ApplyAbsorptionGluingLawsOnce(OperationExpression& exp
    // In all these laws x can be conjunction/disjunction of x1 ... xn.
    // In absorption laws y can be conjunction/disjunction of y1 ... ym.
 
-   auto is_modified = false;
+   auto is_glued = false;
 
    const auto opposite_operation = GetOppositeOperation(expression.GetOperation());
-   assert(OperationType::None != opposite_operation);
 
    const auto last_index = expression.GetChildCount() - 1;
+
+   const auto remove_child = [&expression, &operand_hashes](long index)
+   {
+      expression.RemoveChild(index);
+      operand_hashes.erase(operand_hashes.begin() + index);
+   };
+
    for (auto index1 = last_index ; index1 > 0; --index1)
    {
-      auto& child1_expr = expression.GetChild(index1);
-      const auto is_opposite_operation1 = (GetOperation(child1_expr) == opposite_operation);
+      const auto is_opposite_operation1 = (GetOperation(expression.GetChild(index1)) == opposite_operation);
 
       for (auto index2 = index1 - 1; index2 >= 0; --index2)
       {
-         auto& child2_expr = expression.GetChild(index2);
+         if (operand_hashes[index1].changed_pass < pass - 1 &&
+             operand_hashes[index2].changed_pass < pass - 1)
+         {
+            continue;
+         }
+
+         // Child is taken by index on each step, because removing of preceding
+         // children shifts it. Children are read through constant references,
+         // so they are not marked as modified, until they are changed.
+         const TExpressionPtr& child1_expr = expression.GetChild(index1);
+         const TExpressionPtr& child2_expr = expression.GetChild(index2);
          const auto is_opposite_operation2 = (GetOperation(child2_expr) == opposite_operation);
 
          if (is_opposite_operation1)
          {
-            auto& child1_expression = CastToOperation(child1_expr);
+            const auto& child1_expression = CastToOperation(child1_expr);
 
             // Complex case for absorption and gluing.
             if (is_opposite_operation2)
             {
-               auto& child2_expression = CastToOperation(child2_expr);
+               const auto& child2_expression = CastToOperation(child2_expr);
 
                const auto child1_count = child1_expression.GetChildCount();
                const auto child2_count = child2_expression.GetChildCount();
 
+               const auto params_mask1 = operand_hashes[index1].params_mask;
+               const auto params_mask2 = operand_hashes[index2].params_mask;
+
                if (child1_count < child2_count)
                {
                   // Check of absorption: (x1 | .. | xn) & (x1 | .. | xn | y1 | .. | ym)
-                  if (AreFirstChildrenIncludedByEquality(
-                        child1_expression, child1_count,
-                        child2_expression, child2_count))
+                  if ((params_mask1 & ~params_mask2) == 0 &&
+                      AreChildrenIncludedByEquality(
+                        child1_expression, operand_hashes[index1].hashed_children,
+                        child2_expression, operand_hashes[index2].hashed_children))
                   {
-                     expression.RemoveChild(index2);
-                     is_modified = true;
+                     remove_child(index2);
                      --index1;
                   }
                }
                else if (child1_count > child2_count)
                {
                   // Check of absorption: (x1 | .. | xn | y1 | .. | ym) & (x1 | .. | xn)
-                  if (AreFirstChildrenIncludedByEquality(
-                        child2_expression, child2_count,
-                        child1_expression, child1_count))
+                  if ((params_mask2 & ~params_mask1) == 0 &&
+                      AreChildrenIncludedByEquality(
+                        child2_expression, operand_hashes[index2].hashed_children,
+                        child1_expression, operand_hashes[index1].hashed_children))
                   {
-                     expression.RemoveChild(index1);
-                     is_modified = true;
+                     remove_child(index1);
                      break;
                   }
                }
@@ -837,46 +1495,51 @@ bool ExpressionEvaluator::ApplyAbsorptionGluingLawsOnce(OperationExpression& exp
                {
                   // Check of gluing: (x1 | .. | xn | y) & (x1 | .. | xn | !y)
                   auto diff_index1 = -1L, diff_index2 = -1L;
-                  if (DoChildrenDifferByOne(child1_expression, child2_expression,
+                  if (params_mask1 == params_mask2 &&
+                      DoChildrenDifferByOne(child1_expression, operand_hashes[index1].hashed_children,
+                                            child2_expression, operand_hashes[index2].hashed_children,
                                             diff_index1, diff_index2))
                   {
-                     auto& diff1_expr = child1_expression.GetChild(diff_index1);
-                     auto& diff2_expr = child2_expression.GetChild(diff_index2);
-
-                     if (CheckNegNotNeg(diff1_expr, diff2_expr))
+                     if (CheckNegNotNeg(child1_expression.GetChild(diff_index1),
+                                        child2_expression.GetChild(diff_index2)))
                      {
-                        child2_expression.RemoveChild(diff_index2);
+                        auto& glued_expr = expression.GetChild(index2);
+                        auto& glued_expression = CastToOperation(glued_expr);
+                        glued_expression.RemoveChild(diff_index2);
                         if (2 == child2_count)
                         {
                            // In-place normalization
-                           child2_expr = std::move(child2_expression.GetChild(0));
+                           glued_expr = std::move(glued_expression.GetChild(0));
                         }
-                        expression.RemoveChild(index1);
-                        is_modified = true;
+                        operand_hashes[index2] = GetOperandHashes(glued_expr, opposite_operation);
+                        operand_hashes[index2].changed_pass = pass;
+                        remove_child(index1);
+                        is_glued = true;
                         break;
                      }
                   }
                }
             }
             // Simple case for absorption: (x | y1 | .. ym) & x
-            else if (IsEqualToAnyChild(child2_expr, child1_expression))
+            else if (IsEqualToAnyChild(child2_expr, operand_hashes[index2].hash, child1_expression,
+                                       operand_hashes[index1].hashed_children))
             {
-               expression.RemoveChild(index1);
-               is_modified = true;
+               remove_child(index1);
                break;
             }
          }
          // Simple case for absorption: x & (x | y1 | .. ym)
-         else if (is_opposite_operation2 && IsEqualToAnyChild(child1_expr, CastToOperation(child2_expr)))
+         else if (is_opposite_operation2 &&
+                  IsEqualToAnyChild(child1_expr, operand_hashes[index1].hash, CastToOperation(child2_expr),
+                                    operand_hashes[index2].hashed_children))
          {
-            expression.RemoveChild(index2);
-            is_modified = true;
+            remove_child(index2);
             --index1;
          }
       }
    }
 
-   return is_modified;
+   return is_glued;
 }
 
 void ExpressionEvaluator::InPlaceSimplification(OperationExpression& expression, long child_index)
@@ -1052,6 +1715,190 @@ bool ExpressionEvaluator::IsShortNegationEquivalentWithChildOperation(
           GetOperation(expression.GetChild(0)) == operation;
 }
 
+ExpressionEvaluator::ExpressionHash ExpressionEvaluator::GetHash(const TExpressionPtr& expr)
+{
+   switch (expr->GetType())
+   {
+      case ExpressionType::Literal:
+         return { MixHash(static_cast<std::size_t>(CastToLiteral(expr).GetLiteral())), 0, 0 };
+
+      case ExpressionType::ParamRef:
+      {
+         // Parameters are distinguished from literals by the highest bit.
+         const auto param_index = CastToParamRef(expr).GetParamIndex();
+         const auto hash = MixHash(~static_cast<std::size_t>(param_index));
+         return { hash, hash, std::uint64_t(1) << (param_index % 64) };
+      }
+
+      case ExpressionType::Operation:
+         return GetHash(CastToOperation(expr));
+
+      case ExpressionType::Application:
+         // Applications are expanded before evaluation.
+         assert(!"Application can't be evaluated.");
+         break;
+   }
+
+   assert(!"Unknown expression type.");
+
+   return { 0, 0, 0 };
+}
+
+ExpressionEvaluator::ExpressionHash ExpressionEvaluator::GetHash(const OperationExpression& expression)
+{
+   // Hashes of children are summed up, so the result doesn't depend on order of
+   // movable operands. Parameters hash is a hash of the multiset of parameters,
+   // which is kept by negation (including De Morgan's laws and reverse implications).
+
+   auto operation = expression.GetOperation();
+
+   // Equality and plus are mutually reverse, e.g. (x + y) is equal to (x = y = 0),
+   // so they share the same hash, and literal operands are not hashed.
+   const auto skip_literals = (OperationType::Equality == operation ||
+                               OperationType::Plus == operation);
+   if (skip_literals)
+   {
+      operation = OperationType::Equality;
+   }
+
+   ExpressionHash hash = { 0, 0, 0 };
+
+   for (auto index = expression.GetChildCount() - 1; index >= 0; --index)
+   {
+      const auto& child = expression.GetChild(index);
+      const auto child_hash = GetHash(child);
+
+      hash.params += child_hash.params;
+      hash.params_mask |= child_hash.params_mask;
+      if (!skip_literals || child->GetType() != ExpressionType::Literal)
+      {
+         hash.structural += child_hash.structural;
+      }
+   }
+
+   // Reverse implications are equal, e.g. (x -> !y) and (y -> !x), but their
+   // operands are only negations of each other.
+   if (OperationType::Implication == operation)
+   {
+      hash.structural = hash.params;
+   }
+
+   hash.structural = MixHash(hash.structural ^ MixHash(static_cast<std::size_t>(operation)));
+
+   return hash;
+}
+
+std::size_t ExpressionEvaluator::MixHash(std::size_t value)
+{
+   // Finalizer of SplitMix64.
+   std::uint64_t mixed = static_cast<std::uint64_t>(value) + 0x9e3779b97f4a7c15ULL;
+   mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9ULL;
+   mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebULL;
+   return static_cast<std::size_t>(mixed ^ (mixed >> 31));
+}
+
+void ExpressionEvaluator::SortChildrenByHash(const OperationExpression& expression, long amount,
+                                             bool use_params_hash, HashedChild* hashed_children)
+{
+   for (auto index = 0L; index < amount; ++index)
+   {
+      const auto hash = GetHash(expression.GetChild(index));
+      hashed_children[index].hash = (use_params_hash ? hash.params : hash.structural);
+      hashed_children[index].index = index;
+   }
+
+   std::sort(hashed_children, hashed_children + amount,
+      [](const HashedChild& left, const HashedChild& right)
+      {
+         return (left.hash < right.hash) || (left.hash == right.hash && left.index < right.index);
+      });
+}
+
+long ExpressionEvaluator::GetHashGroupEnd(const HashedChild* hashed_children, long count, long group_begin)
+{
+   auto group_end = group_begin + 1;
+   while (group_end < count && hashed_children[group_end].hash == hashed_children[group_begin].hash)
+   {
+      ++group_end;
+   }
+   return group_end;
+}
+
+ExpressionEvaluator::OperandHashes ExpressionEvaluator::GetOperandHashes(
+   const TExpressionPtr& expr, OperationType operation)
+{
+   const auto hash = GetHash(expr);
+   OperandHashes operand_hashes = { hash.structural, hash.params_mask, {}, 0 };
+
+   if (GetOperation(expr) == operation)
+   {
+      const auto& expression = CastToOperation(expr);
+      const auto child_count = expression.GetChildCount();
+      operand_hashes.hashed_children.resize(child_count);
+      SortChildrenByHash(expression, child_count, false, operand_hashes.hashed_children.data());
+   }
+
+   return operand_hashes;
+}
+
+void ExpressionEvaluator::RemoveFlaggedChildren(OperationExpression& expression, const bool* flags)
+{
+   for (auto index = expression.GetChildCount() - 1; index >= 0; --index)
+   {
+      if (flags[index])
+      {
+         expression.RemoveChild(index);
+      }
+   }
+}
+
+long ExpressionEvaluator::RemovePairs(OperationExpression& expression, bool use_params_hash,
+   bool (*Comparator)(const TExpressionPtr&, const TExpressionPtr&))
+{
+   const auto child_count = expression.GetChildCount();
+
+   LOCAL_ARRAY(HashedChild, hashed_children, child_count);
+   SortChildrenByHash(expression, child_count, use_params_hash, hashed_children);
+
+   LOCAL_ARRAY(bool, paired_flags, child_count);
+   std::fill_n(paired_flags, child_count, false);
+
+   // Paired children are in the same group, so groups are processed independently.
+   auto pair_count = 0L;
+   for (auto group_begin = 0L, group_end = 0L; group_begin < child_count; group_begin = group_end)
+   {
+      group_end = GetHashGroupEnd(hashed_children, child_count, group_begin);
+
+      for (auto i = group_end - 1; i > group_begin; --i)
+      {
+         const auto index1 = hashed_children[i].index;
+         if (paired_flags[index1])
+         {
+            continue;
+         }
+
+         for (auto j = i - 1; j >= group_begin; --j)
+         {
+            const auto index2 = hashed_children[j].index;
+            if (!paired_flags[index2] &&
+                Comparator(expression.GetChild(index1), expression.GetChild(index2)))
+            {
+               paired_flags[index1] = paired_flags[index2] = true;
+               ++pair_count;
+               break;
+            }
+         }
+      }
+   }
+
+   if (pair_count > 0)
+   {
+      RemoveFlaggedChildren(expression, paired_flags);
+   }
+
+   return pair_count;
+}
+
 bool ExpressionEvaluator::CheckNegNotNeg(
    const TExpressionPtr& expr1, const TExpressionPtr& expr2)
 {
@@ -1304,6 +2151,11 @@ bool ExpressionEvaluator::IsEqual(const TExpressionPtr& left, const TExpressionP
 
       case ExpressionType::Operation:
          return IsEqual(CastToOperation(left), CastToOperation(right));
+
+      case ExpressionType::Application:
+         // Applications are expanded before evaluation.
+         assert(!"Application can't be evaluated.");
+         break;
    }
 
    assert(!"Unknown expression type.");
@@ -1319,11 +2171,16 @@ bool ExpressionEvaluator::IsEqual(const OperationExpression& left, const Operati
 }
 
 bool ExpressionEvaluator::IsEqualToAnyChild(
-   const TExpressionPtr& expr, const OperationExpression& expression)
+   const TExpressionPtr& expr, std::size_t expr_hash, const OperationExpression& expression,
+   const std::vector<HashedChild>& hashed_children)
 {
-   for (auto index = expression.GetChildCount() - 1; index >= 0; --index)
+   const auto hashed_end = hashed_children.end();
+   auto hashed_iter = std::lower_bound(hashed_children.begin(), hashed_end, expr_hash,
+      [](const HashedChild& hashed_child, std::size_t hash) { return hashed_child.hash < hash; });
+
+   for (; hashed_iter != hashed_end && hashed_iter->hash == expr_hash; ++hashed_iter)
    {
-      if (IsEqual(expr, expression.GetChild(index)))
+      if (IsEqual(expr, expression.GetChild(hashed_iter->index)))
       {
          return true;
       }
@@ -1435,7 +2292,7 @@ bool ExpressionEvaluator::AreFirstChildrenIncludedByEquality(
    return AreFirstChildrenIncluded(
       enclosing, enclosing_amount,
       enveloping, enveloping_amount, skip_index,
-      ExpressionEvaluator::IsEqual);
+      false, ExpressionEvaluator::IsEqual);
 }
 
 bool ExpressionEvaluator::AreFirstChildrenIncludedByNegNotNeg(
@@ -1445,13 +2302,13 @@ bool ExpressionEvaluator::AreFirstChildrenIncludedByNegNotNeg(
    return AreFirstChildrenIncluded(
       enclosing, enclosing_amount,
       enveloping, enveloping_amount, skip_index,
-      ExpressionEvaluator::CheckNegNotNeg);
+      true, ExpressionEvaluator::CheckNegNotNeg);
 }
 
 bool ExpressionEvaluator::AreFirstChildrenIncluded(
    const OperationExpression& enclosing, long enclosing_amount,
    const OperationExpression& enveloping, long enveloping_amount, long skip_index,
-   bool (*Comparator)(const TExpressionPtr&, const TExpressionPtr&))
+   bool use_params_hash, bool (*Comparator)(const TExpressionPtr&, const TExpressionPtr&))
 {
    assert(enclosing_amount <= enveloping_amount);
    assert(enclosing_amount <= enclosing.GetChildCount());
@@ -1479,40 +2336,100 @@ bool ExpressionEvaluator::AreFirstChildrenIncluded(
 
    // If operands are movable, it's not enough just to use sequential pairwise comparison.
    // We need to check whether two sets of child operands contain the same operands up
-   // to a permutation.
+   // to a permutation. Operands, that can conform to each other, have the same hashes,
+   // so children are sorted by hashes and only operands with the same hashes are compared.
+
+   LOCAL_ARRAY(HashedChild, enclosing_hashed, enclosing_amount);
+   SortChildrenByHash(enclosing, enclosing_amount, use_params_hash, enclosing_hashed);
+
+   LOCAL_ARRAY(HashedChild, enveloping_hashed, enveloping_amount);
+   SortChildrenByHash(enveloping, enveloping_amount, use_params_hash, enveloping_hashed);
 
    // The array contains information about whether i-th operand of "enveloping" was linked
    // to some operand of "enclosing", during conformity detection.
    LOCAL_ARRAY(bool, child_linked_flags, enveloping_amount);
    std::fill_n(child_linked_flags, enveloping_amount, false);
 
-   // Let's establish one-to-one corresponce between elements of "enclosing" and "enveloping",
-   // using child_linked_flags to mark element of "enveloping" as linked.
-   for (auto index1 = enclosing_amount - 1, index2 = 0L; index1 >= 0; --index1)
+   auto unlinked_index = -1L;
+   return LinkSortedChildren(enclosing, enclosing_hashed, enclosing_amount,
+                             enveloping, enveloping_hashed, enveloping_amount,
+                             skip_index, 0, child_linked_flags, unlinked_index, Comparator);
+}
+
+bool ExpressionEvaluator::AreChildrenIncludedByEquality(
+   const OperationExpression& enclosing, const std::vector<HashedChild>& enclosing_hashed,
+   const OperationExpression& enveloping, const std::vector<HashedChild>& enveloping_hashed)
+{
+   const auto enveloping_amount = static_cast<long>(enveloping_hashed.size());
+
+   LOCAL_ARRAY(bool, child_linked_flags, enveloping_amount);
+   std::fill_n(child_linked_flags, enveloping_amount, false);
+
+   auto unlinked_index = -1L;
+   return LinkSortedChildren(enclosing, enclosing_hashed.data(), static_cast<long>(enclosing_hashed.size()),
+                             enveloping, enveloping_hashed.data(), enveloping_amount,
+                             -1, 0, child_linked_flags, unlinked_index, ExpressionEvaluator::IsEqual);
+}
+
+bool ExpressionEvaluator::LinkSortedChildren(
+   const OperationExpression& enclosing, const HashedChild* enclosing_hashed, long enclosing_amount,
+   const OperationExpression& enveloping, const HashedChild* enveloping_hashed, long enveloping_amount,
+   long skip_index, long max_unlinked_count, bool* linked_flags, long& unlinked_index,
+   bool (*Comparator)(const TExpressionPtr&, const TExpressionPtr&))
+{
+   auto unlinked_count = 0L;
+   auto group_begin2 = 0L;
+
+   for (auto group_begin1 = 0L, group_end1 = 0L; group_begin1 < enclosing_amount; group_begin1 = group_end1)
    {
-      for (index2 = enveloping_amount - 1; index2 >= 0; --index2)
+      group_end1 = GetHashGroupEnd(enclosing_hashed, enclosing_amount, group_begin1);
+
+      const auto hash = enclosing_hashed[group_begin1].hash;
+      while (group_begin2 < enveloping_amount && enveloping_hashed[group_begin2].hash < hash)
       {
-         if (!child_linked_flags[index2] && index2 != skip_index &&
-             Comparator(enclosing.GetChild(index1), enveloping.GetChild(index2)))
-         {
-            child_linked_flags[index2] = true;
-            break;
-         }
+         ++group_begin2;
       }
 
-      if (-1 == index2)
+      auto group_end2 = group_begin2;
+      while (group_end2 < enveloping_amount && enveloping_hashed[group_end2].hash == hash)
       {
-         // No pair for "enclosing" child.
-         return false;
+         ++group_end2;
       }
+
+      // Indexes grow within a group, so groups are scanned from the end.
+      for (auto index1 = group_end1 - 1, index2 = 0L; index1 >= group_begin1; --index1)
+      {
+         for (index2 = group_end2 - 1; index2 >= group_begin2; --index2)
+         {
+            if (!linked_flags[index2] && enveloping_hashed[index2].index != skip_index &&
+                Comparator(enclosing.GetChild(enclosing_hashed[index1].index),
+                           enveloping.GetChild(enveloping_hashed[index2].index)))
+            {
+               linked_flags[index2] = true;
+               break;
+            }
+         }
+
+         if (index2 < group_begin2)
+         {
+            // No pair for "enclosing" child.
+            unlinked_index = enclosing_hashed[index1].index;
+            if (++unlinked_count > max_unlinked_count)
+            {
+               return false;
+            }
+         }
+      }
+
+      group_begin2 = group_end2;
    }
 
-   // Full conformity is detected.
    return true;
 }
 
 bool ExpressionEvaluator::DoChildrenDifferByOne(
-   const OperationExpression& expression1, const OperationExpression& expression2,
+   const OperationExpression& expression1, const std::vector<HashedChild>& hashed_children1,
+   const OperationExpression& expression2, const std::vector<HashedChild>& hashed_children2,
    long& diff_index1, long& diff_index2)
 {
    assert(expression1.GetOperation() == expression2.GetOperation());
@@ -1527,30 +2444,11 @@ bool ExpressionEvaluator::DoChildrenDifferByOne(
    LOCAL_ARRAY(bool, child_linked_flags, child_count);
    std::fill_n(child_linked_flags, child_count, false);
 
-   for (auto index1 = child_count - 1, index2 = 0L; index1 >= 0; --index1)
+   if (!LinkSortedChildren(expression1, hashed_children1.data(), child_count,
+                           expression2, hashed_children2.data(), child_count,
+                           -1, 1, child_linked_flags, diff_index1, ExpressionEvaluator::IsEqual))
    {
-      for (index2 = child_count - 1; index2 >= 0; --index2)
-      {
-         if (!child_linked_flags[index2] &&
-             IsEqual(expression1.GetChild(index1), expression2.GetChild(index2)))
-         {
-            child_linked_flags[index2] = true;
-            break;
-         }
-      }
-
-      if (-1 == index2)
-      {
-         // No pair for "expression1" child.
-         if (-1 == diff_index1)
-         {
-            diff_index1 = index1;
-         }
-         else
-         {
-            return false;
-         }
-      }
+      return false;
    }
 
    if (-1 == diff_index1)
@@ -1562,18 +2460,40 @@ bool ExpressionEvaluator::DoChildrenDifferByOne(
    // Find unset element of child_linked_flags and set its index to diff_index2.
    auto it = std::find(child_linked_flags, child_linked_flags + child_count, false);
    assert(it != child_linked_flags + child_count);
-   diff_index2 = (it - child_linked_flags);
+   diff_index2 = hashed_children2[it - child_linked_flags].index;
 
    return true;
 }
 
 } // namespace
 
-void EvaluateExpression(TExpressionPtr& expr)
+void EvaluateExpression(TExpressionPtr& expr, const VariableDeclaration& variable)
 {
    assert(expr.get() != nullptr);
    ExpressionEvaluator evaluator;
-   evaluator.Evaluate(expr);
+
+   // Disjunctive forms are replaced by irredundant covers of prime implicants at once,
+   // instead of applying absorption and gluing laws to pairs of conjunctions.
+   if (!IsEvaluated(expr))
+   {
+      EvaluateDnfExpression(expr, variable);
+   }
+
+   auto& cache = EvaluationCache::GetInstance();
+   if (cache.GetSizeLimit() > 0 && !IsEvaluated(expr))
+   {
+      std::vector<CacheKey> keys;
+      MakeCacheKeys(expr, keys);
+
+      const CacheKey* key = keys.data();
+      evaluator.EvaluateWithCache(expr, variable, cache, key);
+      return;
+   }
+
+   // Evaluation of an operation can change its evaluated operands, e.g. by removing
+   // of negations, so evaluation is repeated for changed operations only until
+   // the whole expression is evaluated.
+   while (evaluator.Evaluate(expr) || !IsEvaluated(expr));
 }
 
 } // namespace dm
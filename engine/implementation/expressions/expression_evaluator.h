@@ -5,6 +5,10 @@
 namespace dm
 {
 
-void EvaluateExpression(TExpressionPtr& expr);
+class VariableDeclaration;
+
+// Parameters of the expression refer to the variable. If the evaluation cache is
+// enabled, evaluated subexpressions are shared with other variables through it.
+void EvaluateExpression(TExpressionPtr& expr, const VariableDeclaration& variable);
 
 } // namespace dm
@@ -0,0 +1,262 @@
+#include "expression_flat.h"
+#include "expression_utils.h"
+#include "expressions.h"
+
+#include "../variables/variable_declaration.h"
+#include "../common/local_array.h"
+
+#include <cassert>
+
+namespace dm
+{
+
+FlatExpression::FlatExpression() :
+   m_codes(), m_param_indexes(), m_children_from(), m_child_counts(), m_children()
+{
+}
+
+FlatExpression::FlatExpression(const TExpressionPtr& expr) : FlatExpression()
+{
+   assert(expr.get() != nullptr);
+   AddNode(expr);
+}
+
+long FlatExpression::GetNodeCount() const
+{
+   return m_codes.size();
+}
+
+long FlatExpression::GetRoot() const
+{
+   assert(!m_codes.empty());
+   return m_codes.size() - 1;
+}
+
+ExpressionType FlatExpression::GetType(long node) const
+{
+   const auto code = m_codes[node];
+   return (code < s_code_param_ref) ? ExpressionType::Literal :
+      (s_code_param_ref == code) ? ExpressionType::ParamRef : ExpressionType::Operation;
+}
+
+LiteralType FlatExpression::GetLiteral(long node) const
+{
+   const auto code = m_codes[node];
+   return (s_code_false == code) ? LiteralType::False :
+      (s_code_true == code) ? LiteralType::True : LiteralType::None;
+}
+
+long FlatExpression::GetParamIndex(long node) const
+{
+   return m_param_indexes[node];
+}
+
+OperationType FlatExpression::GetOperation(long node) const
+{
+   const auto code = m_codes[node];
+   return (code < s_code_negation) ?
+      OperationType::None : static_cast<OperationType>(code - s_code_negation);
+}
+
+long FlatExpression::GetChildCount(long node) const
+{
+   return m_child_counts[node];
+}
+
+long FlatExpression::GetChild(long node, long index) const
+{
+   assert(index >= 0 && index < m_child_counts[node]);
+   return m_children[m_children_from[node] + index];
+}
+
+long FlatExpression::AddLiteral(LiteralType literal)
+{
+   assert(LiteralType::None != literal);
+   return AddNode(LiteralType::True == literal ? s_code_true : s_code_false, -1, nullptr, 0);
+}
+
+long FlatExpression::AddParamRef(long param_index)
+{
+   assert(param_index >= 0);
+   return AddNode(s_code_param_ref, param_index, nullptr, 0);
+}
+
+long FlatExpression::AddOperation(OperationType operation, const long children[], long child_count)
+{
+   assert(OperationType::None != operation);
+   return AddNode(static_cast<std::uint8_t>(s_code_negation + static_cast<int>(operation)), -1, children, child_count);
+}
+
+void FlatExpression::RemoveUnreachableNodes()
+{
+   const auto node_count = GetNodeCount();
+   if (0 == node_count)
+   {
+      return;
+   }
+
+   // Parents precede their children in the reverse order, so a single pass marks all reachable nodes.
+   std::vector<bool> is_reachable(node_count, false);
+   is_reachable[node_count - 1] = true;
+   for (auto node = node_count - 1; node >= 0; --node)
+   {
+      if (is_reachable[node])
+      {
+         for (auto index = 0L; index < m_child_counts[node]; ++index)
+         {
+            is_reachable[GetChild(node, index)] = true;
+         }
+      }
+   }
+
+   FlatExpression result;
+   std::vector<long> new_indexes(node_count, -1);
+   std::vector<long> children;
+
+   for (auto node = 0L; node < node_count; ++node)
+   {
+      if (!is_reachable[node])
+      {
+         continue;
+      }
+
+      children.clear();
+      for (auto index = 0L; index < m_child_counts[node]; ++index)
+      {
+         children.push_back(new_indexes[GetChild(node, index)]);
+      }
+
+      new_indexes[node] = result.AddNode(m_codes[node], m_param_indexes[node], children.data(), children.size());
+   }
+
+   *this = std::move(result);
+}
+
+TExpressionPtr FlatExpression::ToTree(const VariableDeclaration& variable) const
+{
+   return ToTree(GetRoot(), &variable, nullptr);
+}
+
+TExpressionPtr FlatExpression::ToTreeWithSubstitution(const TExpressionPtrVector& actual_params) const
+{
+   return ToTree(GetRoot(), nullptr, &actual_params);
+}
+
+std::string FlatExpression::ToString(const VariableDeclaration& variable) const
+{
+   std::string result;
+   AppendToString(result, GetRoot(), variable);
+   return result;
+}
+
+long FlatExpression::AddNode(std::uint8_t code, long param_index, const long children[], long child_count)
+{
+   m_codes.push_back(code);
+   m_param_indexes.push_back(param_index);
+   m_children_from.push_back(m_children.size());
+   m_child_counts.push_back(child_count);
+   m_children.insert(m_children.end(), children, children + child_count);
+
+   return m_codes.size() - 1;
+}
+
+long FlatExpression::AddNode(const TExpressionPtr& expr)
+{
+   switch (expr->GetType())
+   {
+      case ExpressionType::Literal:
+         return AddLiteral(CastToLiteral(expr).GetLiteral());
+
+      case ExpressionType::ParamRef:
+         return AddParamRef(CastToParamRef(expr).GetParamIndex());
+
+      case ExpressionType::Operation:
+      {
+         const auto& expression = CastToOperation(expr);
+         const auto child_count = expression.GetChildCount();
+
+         LOCAL_ARRAY(long, children, child_count);
+         for (auto index = 0L; index < child_count; ++index)
+         {
+            children[index] = AddNode(expression.GetChild(index));
+         }
+
+         return AddOperation(expression.GetOperation(), children, child_count);
+      }
+
+      default:
+         assert(!"Unsupported type of expression");
+         return -1;
+   }
+}
+
+TExpressionPtr FlatExpression::ToTree(long node,
+   const VariableDeclaration* variable, const TExpressionPtrVector* actual_params) const
+{
+   switch (GetType(node))
+   {
+      case ExpressionType::Literal:
+         return std::make_unique<LiteralExpression>(GetLiteral(node));
+
+      case ExpressionType::ParamRef:
+         return (actual_params != nullptr) ?
+            actual_params->at(GetParamIndex(node))->Clone() :
+            std::make_unique<ParamRefExpression>(*variable, GetParamIndex(node));
+
+      default:
+      {
+         const auto child_count = GetChildCount(node);
+
+         TExpressionPtrVector children;
+         children.reserve(child_count);
+         for (auto index = 0L; index < child_count; ++index)
+         {
+            children.push_back(ToTree(GetChild(node, index), variable, actual_params));
+         }
+
+         return std::make_unique<OperationExpression>(GetOperation(node), std::move(children));
+      }
+   }
+}
+
+void FlatExpression::AppendToString(std::string& result, long node, const VariableDeclaration& variable) const
+{
+   switch (GetType(node))
+   {
+      case ExpressionType::Literal:
+         result += LiteralTypeToString(GetLiteral(node));
+         break;
+
+      case ExpressionType::ParamRef:
+         result += variable.GetParameter(GetParamIndex(node)).GetName();
+         break;
+
+      default:
+      {
+         const auto operation = GetOperation(node);
+         if (OperationType::Negation == operation)
+         {
+            result += OperationTypeToString(operation);
+            AppendToString(result, GetChild(node, 0), variable);
+            break;
+         }
+
+         const auto operation_str =
+            std::string(1, ' ') + OperationTypeToString(operation) + std::string(1, ' ');
+
+         result += "(";
+         for (auto index = 0L; index < GetChildCount(node); ++index)
+         {
+            if (index > 0)
+            {
+               result += operation_str;
+            }
+            AppendToString(result, GetChild(node, index), variable);
+         }
+         result += ")";
+         break;
+      }
+   }
+}
+
+} // namespace dm
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "expression_base.h"
+#include "../common/literals.h"
+#include "../common/operations.h"
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <cstdint>
+
+namespace dm
+{
+
+class VariableDeclaration;
+
+// Expression, stored in contiguous arrays instead of a tree of separately allocated nodes.
+// Each node has a code, a parameter index and a range in the shared array of child indexes.
+// Nodes are stored in post-order, so children precede their parent and the root is the last
+// node, which allows to process the whole expression by a single linear scan.
+class FlatExpression
+{
+public:
+   FlatExpression();
+   explicit FlatExpression(const TExpressionPtr& expr);
+
+   long GetNodeCount() const;
+   long GetRoot() const;
+
+   ExpressionType GetType(long node) const;
+   LiteralType GetLiteral(long node) const;
+   long GetParamIndex(long node) const;
+   OperationType GetOperation(long node) const;
+   long GetChildCount(long node) const;
+   long GetChild(long node, long index) const;
+
+   // Nodes must be added after their children.
+   long AddLiteral(LiteralType literal);
+   long AddParamRef(long param_index);
+   long AddOperation(OperationType operation, const long children[], long child_count);
+
+   // Removes nodes, that are not reachable from the root.
+   void RemoveUnreachableNodes();
+
+   // Builds the expression tree, which references parameters of the variable.
+   TExpressionPtr ToTree(const VariableDeclaration& variable) const;
+   // Builds the expression tree, substituting parameters with actual values.
+   TExpressionPtr ToTreeWithSubstitution(const TExpressionPtrVector& actual_params) const;
+   // The same string, as the tree has.
+   std::string ToString(const VariableDeclaration& variable) const;
+
+private:
+   // Literals, parameter references and operations (starting from s_code_negation
+   // in the same order, as in OperationType).
+   static const std::uint8_t s_code_false = 0;
+   static const std::uint8_t s_code_true = 1;
+   static const std::uint8_t s_code_param_ref = 2;
+   static const std::uint8_t s_code_negation = 3;
+
+   long AddNode(std::uint8_t code, long param_index, const long children[], long child_count);
+   long AddNode(const TExpressionPtr& expr);
+   TExpressionPtr ToTree(long node, const VariableDeclaration* variable, const TExpressionPtrVector* actual_params) const;
+   void AppendToString(std::string& result, long node, const VariableDeclaration& variable) const;
+
+private:
+   std::vector<std::uint8_t> m_codes;
+   std::vector<std::int32_t> m_param_indexes;
+   std::vector<std::int32_t> m_children_from;
+   std::vector<std::int32_t> m_child_counts;
+   std::vector<std::int32_t> m_children;
+};
+
+using TFlatExpressionPtr = std::unique_ptr<FlatExpression>;
+
+} // namespace dm
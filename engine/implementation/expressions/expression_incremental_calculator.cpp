@@ -0,0 +1,191 @@
+#include "expression_incremental_calculator.h"
+#include "expression_utils.h"
+#include "expressions.h"
+
+#include "../common/local_array.h"
+
+#include <cassert>
+
+namespace dm
+{
+
+IncrementalCalculator::IncrementalCalculator(const TExpressionPtr& expr, long param_count) :
+   m_nodes(), m_children(), m_param_nodes(param_count), m_dirty_nodes(), m_dirty_flags()
+{
+   assert(expr.get() != nullptr);
+
+   AddNode(expr);
+   m_dirty_flags.resize(m_nodes.size(), false);
+}
+
+IncrementalCalculator::IncrementalCalculator(const FlatExpression& expr, long param_count) :
+   m_nodes(), m_children(), m_param_nodes(param_count), m_dirty_nodes(), m_dirty_flags()
+{
+   assert(expr.GetNodeCount() > 0);
+
+   // Flat expression is already in post-order, so nodes are just converted.
+   m_nodes.reserve(expr.GetNodeCount());
+   for (auto index = 0L; index < expr.GetNodeCount(); ++index)
+   {
+      Node node = { expr.GetOperation(index), -1, -1, 0, 0, g_bit_block_false };
+
+      switch (expr.GetType(index))
+      {
+         case ExpressionType::Literal:
+            node.value = LiteralTypeToBitBlock(expr.GetLiteral(index));
+            break;
+
+         case ExpressionType::ParamRef:
+            node.param_index = expr.GetParamIndex(index);
+            break;
+
+         default:
+         {
+            node.children_from = m_children.size();
+            for (auto child_index = 0L; child_index < expr.GetChildCount(index); ++child_index)
+            {
+               m_children.push_back(expr.GetChild(index, child_index));
+            }
+            node.children_to = m_children.size();
+            break;
+         }
+      }
+
+      AddNode(node);
+   }
+
+   m_dirty_flags.resize(m_nodes.size(), false);
+}
+
+TBitBlock IncrementalCalculator::Calculate(const TBitBlock param_values[], long changed_index)
+{
+   if (-1 == changed_index)
+   {
+      // Post-order allows to calculate all nodes by a single pass.
+      for (auto& node : m_nodes)
+      {
+         if (-1 != node.param_index)
+         {
+            node.value = param_values[node.param_index];
+         }
+         else if (OperationType::None != node.operation)
+         {
+            CalculateNode(node);
+         }
+      }
+
+      return m_nodes.back().value;
+   }
+
+   assert(changed_index >= 0 && changed_index < (long)m_param_nodes.size());
+
+   for (auto index : m_param_nodes[changed_index])
+   {
+      auto& node = m_nodes[index];
+      node.value = param_values[changed_index];
+      if (-1 != node.parent && !m_dirty_flags[node.parent])
+      {
+         m_dirty_flags[node.parent] = true;
+         m_dirty_nodes.push(node.parent);
+      }
+   }
+
+   // Parents are always processed after all their dirty children.
+   while (!m_dirty_nodes.empty())
+   {
+      const auto index = m_dirty_nodes.top();
+      m_dirty_nodes.pop();
+      m_dirty_flags[index] = false;
+
+      auto& node = m_nodes[index];
+      const auto old_value = node.value;
+      CalculateNode(node);
+
+      if (node.value != old_value && -1 != node.parent && !m_dirty_flags[node.parent])
+      {
+         m_dirty_flags[node.parent] = true;
+         m_dirty_nodes.push(node.parent);
+      }
+   }
+
+   return m_nodes.back().value;
+}
+
+long IncrementalCalculator::AddNode(const TExpressionPtr& expr)
+{
+   Node node = { OperationType::None, -1, -1, 0, 0, g_bit_block_false };
+
+   switch (expr->GetType())
+   {
+      case ExpressionType::Literal:
+      {
+         node.value = LiteralTypeToBitBlock(CastToLiteral(expr).GetLiteral());
+         break;
+      }
+
+      case ExpressionType::ParamRef:
+      {
+         node.param_index = CastToParamRef(expr).GetParamIndex();
+         break;
+      }
+
+      case ExpressionType::Operation:
+      {
+         const auto& expression = CastToOperation(expr);
+         const auto child_count = expression.GetChildCount();
+
+         node.operation = expression.GetOperation();
+
+         LOCAL_ARRAY(long, child_indexes, child_count);
+         for (auto index = 0L; index < child_count; ++index)
+         {
+            child_indexes[index] = AddNode(expression.GetChild(index));
+         }
+
+         node.children_from = m_children.size();
+         m_children.insert(m_children.end(), child_indexes, child_indexes + child_count);
+         node.children_to = m_children.size();
+
+         break;
+      }
+
+      default:
+      {
+         assert(!"Unknown type of expression");
+      }
+   }
+
+   AddNode(node);
+   return m_nodes.size() - 1;
+}
+
+void IncrementalCalculator::AddNode(const Node& node)
+{
+   const auto node_index = static_cast<long>(m_nodes.size());
+   m_nodes.push_back(node);
+
+   if (-1 != node.param_index)
+   {
+      m_param_nodes[node.param_index].push_back(node_index);
+   }
+
+   for (auto index = node.children_from; index < node.children_to; ++index)
+   {
+      m_nodes[m_children[index]].parent = node_index;
+   }
+}
+
+void IncrementalCalculator::CalculateNode(Node& node)
+{
+   const auto child_count = node.children_to - node.children_from;
+
+   LOCAL_ARRAY(TBitBlock, child_values, child_count);
+   for (auto index = 0L; index < child_count; ++index)
+   {
+      child_values[index] = m_nodes[m_children[node.children_from + index]].value;
+   }
+
+   node.value = PerformOperation(node.operation, child_values, child_count);
+}
+
+} // namespace dm
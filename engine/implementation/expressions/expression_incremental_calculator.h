@@ -0,0 +1,55 @@
+#pragma once
+
+#include "expression_base.h"
+#include "expression_flat.h"
+#include "../common/literals.h"
+#include "../common/operations.h"
+#include "../common/noncopyable.h"
+
+#include <vector>
+#include <queue>
+#include <functional>
+
+namespace dm
+{
+
+// Calculates expression over a sequence of blocks, where each next block differs from
+// the previous one by a single parameter (see Gray code mode of BitCombinationGenerator).
+// Values of all nodes are cached, so only ancestors of the changed parameter references
+// are recalculated, and propagation stops at nodes whose values haven't changed.
+class IncrementalCalculator : public NonCopyable
+{
+public:
+   IncrementalCalculator(const TExpressionPtr& expr, long param_count);
+   IncrementalCalculator(const FlatExpression& expr, long param_count);
+
+   // If changed_index is -1, the whole expression is calculated.
+   TBitBlock Calculate(const TBitBlock param_values[], long changed_index);
+
+private:
+   struct Node
+   {
+      OperationType operation;  // OperationType::None for literals and parameter references
+      long param_index;         // -1 for literals and operations
+      long parent;              // -1 for the root
+      long children_from;       // Range of child nodes indexes in m_children
+      long children_to;
+      TBitBlock value;
+   };
+
+   // Nodes are stored in post-order, so children always precede their parent.
+   long AddNode(const TExpressionPtr& expr);
+   void AddNode(const Node& node);
+   void CalculateNode(Node& node);
+
+private:
+   std::vector<Node> m_nodes;
+   std::vector<long> m_children;
+   // Indexes of parameter reference nodes, grouped by parameters.
+   std::vector<std::vector<long>> m_param_nodes;
+   // Dirty nodes that must be recalculated, in ascending order of indexes.
+   std::priority_queue<long, std::vector<long>, std::greater<long>> m_dirty_nodes;
+   std::vector<bool> m_dirty_flags;
+};
+
+} // namespace dm
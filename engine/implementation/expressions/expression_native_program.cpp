@@ -0,0 +1,245 @@
+#include "expression_native_program.h"
+
+#include "../common/local_array.h"
+
+#include <vector>
+#include <initializer_list>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+
+#if defined(_M_X64) || defined(__x86_64__)
+   #define DM_NATIVE_CODE_SUPPORTED
+#endif
+
+#ifdef DM_NATIVE_CODE_SUPPORTED
+   #ifdef _WIN32
+      #include <windows.h>
+   #else
+      #include <sys/mman.h>
+   #endif
+#endif
+
+namespace dm
+{
+
+namespace
+{
+
+#ifdef DM_NATIVE_CODE_SUPPORTED
+
+// Registers usage:
+//    rax - top of the evaluation stack;
+//    rdx - scratch register;
+//    r8  - pointer to parameter values;
+//    r9  - pointer to the stack buffer, that holds the rest of the evaluation stack.
+class CodeGenerator
+{
+public:
+   CodeGenerator() : m_code(), m_depth(0)
+   {
+   }
+
+   const std::vector<unsigned char>& Generate(const ExpressionProgram& program)
+   {
+#if defined(_WIN32) || defined(__CYGWIN__)
+      // Microsoft x64 calling convention: arguments are in rcx and rdx.
+      EmitBytes({ 0x49, 0x89, 0xC8 });  // mov r8, rcx
+      EmitBytes({ 0x49, 0x89, 0xD1 });  // mov r9, rdx
+#else
+      // System V AMD64 calling convention: arguments are in rdi and rsi.
+      EmitBytes({ 0x49, 0x89, 0xF8 });  // mov r8, rdi
+      EmitBytes({ 0x49, 0x89, 0xF1 });  // mov r9, rsi
+#endif
+
+      for (const auto& instruction : program.GetInstructions())
+      {
+         switch (instruction.code)
+         {
+            case ExpressionProgram::OpCode::PushFalse:
+               Push();
+               EmitBytes({ 0x31, 0xC0 });                                // xor eax, eax
+               break;
+
+            case ExpressionProgram::OpCode::PushTrue:
+               Push();
+               EmitBytes({ 0x48, 0xC7, 0xC0, 0xFF, 0xFF, 0xFF, 0xFF });  // mov rax, -1
+               break;
+
+            case ExpressionProgram::OpCode::PushParam:
+               Push();
+               EmitBytes({ 0x49, 0x8B, 0x80 });                          // mov rax, [r8 + disp32]
+               EmitDisplacement(instruction.argument);
+               break;
+
+            case ExpressionProgram::OpCode::Not:
+               EmitBytes({ 0x48, 0xF7, 0xD0 });                          // not rax
+               break;
+
+            case ExpressionProgram::OpCode::And:
+               EmitBytes({ 0x49, 0x23, 0x81 });                          // and rax, [r9 + disp32]
+               Pop();
+               break;
+
+            case ExpressionProgram::OpCode::Or:
+               EmitBytes({ 0x49, 0x0B, 0x81 });                          // or rax, [r9 + disp32]
+               Pop();
+               break;
+
+            case ExpressionProgram::OpCode::Xor:
+               EmitBytes({ 0x49, 0x33, 0x81 });                          // xor rax, [r9 + disp32]
+               Pop();
+               break;
+
+            case ExpressionProgram::OpCode::Implication:
+               EmitBytes({ 0x49, 0x8B, 0x91 });                          // mov rdx, [r9 + disp32]
+               Pop();
+               EmitBytes({ 0x48, 0xF7, 0xD2 });                          // not rdx
+               EmitBytes({ 0x48, 0x09, 0xD0 });                          // or rax, rdx
+               break;
+
+            default:
+               // Jumps are skipped: code is straight-line.
+               break;
+         }
+      }
+
+      assert(1 == m_depth);
+
+      EmitBytes({ 0xC3 });                                               // ret
+
+      return m_code;
+   }
+
+private:
+   void Push()
+   {
+      // Current top of the stack is moved from rax to the stack buffer.
+      if (m_depth > 0)
+      {
+         EmitBytes({ 0x49, 0x89, 0x81 });                                // mov [r9 + disp32], rax
+         EmitDisplacement(m_depth - 1);
+      }
+      ++m_depth;
+   }
+
+   void Pop()
+   {
+      // Binary operations take the second operand from the stack buffer.
+      assert(m_depth > 1);
+      --m_depth;
+      EmitDisplacement(m_depth - 1);
+   }
+
+   void EmitBytes(std::initializer_list<unsigned char> bytes)
+   {
+      m_code.insert(m_code.end(), bytes);
+   }
+
+   void EmitDisplacement(long index)
+   {
+      const auto displacement = static_cast<std::uint32_t>(index * sizeof(TBitBlock));
+      for (auto byte = 0; byte < 4; ++byte)
+      {
+         m_code.push_back(static_cast<unsigned char>(displacement >> (8 * byte)));
+      }
+   }
+
+private:
+   std::vector<unsigned char> m_code;
+   long m_depth;
+};
+
+void* AllocateExecutableMemory(const std::vector<unsigned char>& code)
+{
+   // Memory is never writable and executable at the same time.
+#ifdef _WIN32
+   auto memory = ::VirtualAlloc(nullptr, code.size(), MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+   if (nullptr == memory)
+   {
+      return nullptr;
+   }
+
+   std::memcpy(memory, code.data(), code.size());
+
+   DWORD old_protection = 0;
+   if (!::VirtualProtect(memory, code.size(), PAGE_EXECUTE_READ, &old_protection))
+   {
+      ::VirtualFree(memory, 0, MEM_RELEASE);
+      return nullptr;
+   }
+
+   ::FlushInstructionCache(::GetCurrentProcess(), memory, code.size());
+#else
+   auto memory = ::mmap(nullptr, code.size(), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (MAP_FAILED == memory)
+   {
+      return nullptr;
+   }
+
+   std::memcpy(memory, code.data(), code.size());
+
+   if (::mprotect(memory, code.size(), PROT_READ | PROT_EXEC) != 0)
+   {
+      ::munmap(memory, code.size());
+      return nullptr;
+   }
+#endif
+
+   return memory;
+}
+
+void FreeExecutableMemory(void* memory, std::size_t size)
+{
+#ifdef _WIN32
+   size; // To avoid warning
+   ::VirtualFree(memory, 0, MEM_RELEASE);
+#else
+   ::munmap(memory, size);
+#endif
+}
+
+#endif // DM_NATIVE_CODE_SUPPORTED
+
+} // namespace
+
+TNativeExpressionProgramPtr NativeExpressionProgram::Create(const ExpressionProgram& program)
+{
+#ifdef DM_NATIVE_CODE_SUPPORTED
+   CodeGenerator generator;
+   const auto& code = generator.Generate(program);
+
+   auto memory = AllocateExecutableMemory(code);
+   if (nullptr == memory)
+   {
+      return TNativeExpressionProgramPtr();
+   }
+
+   return TNativeExpressionProgramPtr(
+      new NativeExpressionProgram(memory, code.size(), program.GetStackSize()));
+#else
+   program; // To avoid warning
+   return TNativeExpressionProgramPtr();
+#endif
+}
+
+NativeExpressionProgram::NativeExpressionProgram(void* memory, std::size_t size, long stack_size) :
+   m_memory(memory), m_size(size), m_stack_size(stack_size),
+   m_function(reinterpret_cast<TFunctionPtr>(memory))
+{
+}
+
+NativeExpressionProgram::~NativeExpressionProgram()
+{
+#ifdef DM_NATIVE_CODE_SUPPORTED
+   FreeExecutableMemory(m_memory, m_size);
+#endif
+}
+
+TBitBlock NativeExpressionProgram::Execute(const TBitBlock param_values[]) const
+{
+   LOCAL_ARRAY(TBitBlock, stack, m_stack_size);
+   return m_function(param_values, stack);
+}
+
+} // namespace dm
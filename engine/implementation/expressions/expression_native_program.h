@@ -0,0 +1,44 @@
+#pragma once
+
+#include "expression_program.h"
+#include "../common/literals.h"
+#include "../common/noncopyable.h"
+
+#include <memory>
+#include <cstddef>
+
+namespace dm
+{
+
+class NativeExpressionProgram;
+using TNativeExpressionProgramPtr = std::unique_ptr<NativeExpressionProgram>;
+
+// Straight-line x86-64 machine code, generated from ExpressionProgram into
+// an executable memory buffer. Conditional jumps of the source program are
+// omitted, since they only skip operands that can't change the result.
+class NativeExpressionProgram : public NonCopyable
+{
+public:
+   // Returns empty pointer if native code can't be generated for the program
+   // on the current platform, so the caller must fall back to the interpreter.
+   static TNativeExpressionProgramPtr Create(const ExpressionProgram& program);
+
+   ~NativeExpressionProgram();
+
+   TBitBlock Execute(const TBitBlock param_values[]) const;
+
+private:
+   // Generated code keeps intermediate values in the stack buffer,
+   // provided by the caller, so it doesn't touch the machine stack.
+   using TFunctionPtr = TBitBlock(*)(const TBitBlock param_values[], TBitBlock stack[]);
+
+   NativeExpressionProgram(void* memory, std::size_t size, long stack_size);
+
+private:
+   void* m_memory;
+   std::size_t m_size;
+   long m_stack_size;
+   TFunctionPtr m_function;
+};
+
+} // namespace dm
@@ -2,15 +2,161 @@
 #include "expressions.h"
 #include "expression_utils.h"
 
+#include <algorithm>
+#include <vector>
 #include <cassert>
 
 namespace dm
 {
 
-void NormalizeExpression(TExpressionPtr& expr)
+namespace
+{
+
+long GetTypeRank(const TExpressionPtr& expr)
+{
+   switch (expr->GetType())
+   {
+      case ExpressionType::ParamRef:
+         return 0;
+      case ExpressionType::Operation:
+         return 1;
+      case ExpressionType::Application:
+         return 2;
+      case ExpressionType::Literal:
+         return 3;
+   }
+
+   assert(!"Unknown expression type.");
+
+   return 0;
+}
+
+// Returns negative value, zero or positive value, if left expression is less,
+// equal or greater than the right one in the canonical order.
+long CompareExpressions(const TExpressionPtr& left, const TExpressionPtr& right)
+{
+   const auto rank = GetTypeRank(left);
+   if (rank != GetTypeRank(right))
+   {
+      return rank - GetTypeRank(right);
+   }
+
+   switch (left->GetType())
+   {
+      case ExpressionType::ParamRef:
+         return CastToParamRef(left).GetParamIndex() - CastToParamRef(right).GetParamIndex();
+
+      case ExpressionType::Literal:
+         return static_cast<long>(CastToLiteral(left).GetLiteral()) -
+                static_cast<long>(CastToLiteral(right).GetLiteral());
+
+      case ExpressionType::Application:
+         return left->ToString().compare(right->ToString());
+
+      default:
+         break;
+   }
+
+   const auto& left_expression = CastToOperation(left);
+   const auto& right_expression = CastToOperation(right);
+
+   if (left_expression.GetOperation() != right_expression.GetOperation())
+   {
+      return static_cast<long>(left_expression.GetOperation()) -
+             static_cast<long>(right_expression.GetOperation());
+   }
+
+   const auto child_count = left_expression.GetChildCount();
+   if (child_count != right_expression.GetChildCount())
+   {
+      return child_count - right_expression.GetChildCount();
+   }
+
+   for (auto index = 0L; index < child_count; ++index)
+   {
+      const auto result = CompareExpressions(left_expression.GetChild(index), right_expression.GetChild(index));
+      if (result != 0)
+      {
+         return result;
+      }
+   }
+
+   return 0;
+}
+
+// Children are sorted before their parents, so the order is canonical for the whole tree.
+void SortOperands(TExpressionPtr& expr)
+{
+   if (expr->GetType() == ExpressionType::Application)
+   {
+      auto& application = CastToApplication(expr);
+      for (auto index = 0L; index < application.GetChildCount(); ++index)
+      {
+         SortOperands(application.GetChild(index));
+      }
+      return;
+   }
+
+   if (expr->GetType() != ExpressionType::Operation)
+   {
+      return;
+   }
+
+   auto& expression = CastToOperation(expr);
+   const auto child_count = expression.GetChildCount();
+
+   for (auto index = 0L; index < child_count; ++index)
+   {
+      SortOperands(expression.GetChild(index));
+   }
+
+   if (!AreOperandsMovable(expression.GetOperation()))
+   {
+      return;
+   }
+
+   TExpressionPtrVector children;
+   children.reserve(child_count);
+   for (auto index = 0L; index < child_count; ++index)
+   {
+      children.push_back(std::move(expression.GetChild(index)));
+   }
+
+   std::stable_sort(children.begin(), children.end(),
+      [](const TExpressionPtr& left, const TExpressionPtr& right)
+      {
+         return CompareExpressions(left, right) < 0;
+      });
+
+   for (auto index = 0L; index < child_count; ++index)
+   {
+      expression.GetChild(index) = std::move(children[index]);
+   }
+}
+
+} // namespace
+
+void NormalizeExpression(TExpressionPtr& expr, bool sort_operands)
 {
    assert(expr.get() != nullptr);
 
+   if (sort_operands)
+   {
+      NormalizeExpression(expr);
+      SortOperands(expr);
+      return;
+   }
+
+   if (expr->GetType() == ExpressionType::Application)
+   {
+      auto& application = CastToApplication(expr);
+      for (auto index = 0L; index < application.GetChildCount(); ++index)
+      {
+         NormalizeExpression(application.GetChild(index));
+      }
+      return;
+   }
+
    if (expr->GetType() != ExpressionType::Operation)
    {
       return;
@@ -45,4 +191,99 @@ void NormalizeExpression(TExpressionPtr& expr)
    }
 }
 
+void NormalizeExpression(FlatExpression& expr)
+{
+   const auto node_count = expr.GetNodeCount();
+
+   // Negations are not normalized together with their subtrees.
+   std::vector<bool> is_skipped(node_count, false);
+   for (auto node = node_count - 1; node >= 0; --node)
+   {
+      if (is_skipped[node] || OperationType::Negation == expr.GetOperation(node))
+      {
+         for (auto index = 0L; index < expr.GetChildCount(node); ++index)
+         {
+            is_skipped[expr.GetChild(node, index)] = true;
+         }
+      }
+   }
+
+   // Most of expressions are already normalized by the parser.
+   auto is_normalized = true;
+   for (auto node = 0L; node < node_count && is_normalized; ++node)
+   {
+      const auto operation = expr.GetOperation(node);
+      if (OperationType::None == operation || OperationType::Negation == operation || is_skipped[node])
+      {
+         continue;
+      }
+
+      const auto are_operands_movable = AreOperandsMovable(operation);
+      for (auto index = 0L; index < expr.GetChildCount(node); ++index)
+      {
+         if ((are_operands_movable || 0 == index) && expr.GetOperation(expr.GetChild(node, index)) == operation)
+         {
+            is_normalized = false;
+            break;
+         }
+      }
+   }
+
+   if (is_normalized)
+   {
+      return;
+   }
+
+   FlatExpression result;
+   std::vector<long> new_indexes(node_count, -1);
+   std::vector<long> children;
+
+   for (auto node = 0L; node < node_count; ++node)
+   {
+      switch (expr.GetType(node))
+      {
+         case ExpressionType::Literal:
+            new_indexes[node] = result.AddLiteral(expr.GetLiteral(node));
+            break;
+
+         case ExpressionType::ParamRef:
+            new_indexes[node] = result.AddParamRef(expr.GetParamIndex(node));
+            break;
+
+         default:
+         {
+            const auto operation = expr.GetOperation(node);
+            const auto are_operands_movable = AreOperandsMovable(operation);
+            const auto is_normalized = !is_skipped[node] && OperationType::Negation != operation;
+
+            children.clear();
+            for (auto index = 0L; index < expr.GetChildCount(node); ++index)
+            {
+               const auto child = new_indexes[expr.GetChild(node, index)];
+
+               // Children of the child are already normalized, so they are just moved up.
+               if (is_normalized && (are_operands_movable || 0 == index) && result.GetOperation(child) == operation)
+               {
+                  for (auto child_index = 0L; child_index < result.GetChildCount(child); ++child_index)
+                  {
+                     children.push_back(result.GetChild(child, child_index));
+                  }
+               }
+               else
+               {
+                  children.push_back(child);
+               }
+            }
+
+            new_indexes[node] = result.AddOperation(operation, children.data(), children.size());
+            break;
+         }
+      }
+   }
+
+   // Moved up operations are left unreachable.
+   result.RemoveUnreachableNodes();
+   expr = std::move(result);
+}
+
 } // namespace dm
@@ -1,10 +1,15 @@
 #pragma once
 
 #include "expression_base.h"
+#include "expression_flat.h"
 
 namespace dm
 {
 
-void NormalizeExpression(TExpressionPtr& expr);
+// If sort_operands is true, operands of operations with movable operands are sorted
+// in the canonical order: parameters by indexes, then operations, then literals.
+void NormalizeExpression(TExpressionPtr& expr, bool sort_operands = false);
+// Gives the same result, as the tree version, by a linear scan over nodes.
+void NormalizeExpression(FlatExpression& expr);
 
 } // namespace dm
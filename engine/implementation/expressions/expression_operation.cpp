@@ -10,6 +10,7 @@ OperationExpression::OperationExpression(
    TExpressionPtr&& child) :
       Base(),
       m_operation(OperationType::Negation),
+      m_is_evaluated(false),
       m_children()
 {
    m_children.push_back(std::move(child));
@@ -19,6 +20,7 @@ OperationExpression::OperationExpression(
    OperationType operation, TExpressionPtrVector&& children) :
       Base(),
       m_operation(operation), 
+      m_is_evaluated(false),
       m_children(std::move(children))
 {
    assert
@@ -31,6 +33,7 @@ OperationExpression::OperationExpression(
 OperationExpression::OperationExpression(const OperationExpression& rhs):
    Base(),
    m_operation(rhs.m_operation),
+   m_is_evaluated(rhs.m_is_evaluated),
    m_children()
 {
    m_children.reserve(rhs.m_children.size());
@@ -44,6 +47,7 @@ OperationExpression::OperationExpression(
    const OperationExpression& rhs, const TExpressionPtrVector& actual_params) :
       Base(),
       m_operation(rhs.m_operation),
+      m_is_evaluated(false),
       m_children()
 {
    m_children.reserve(rhs.m_children.size());
@@ -62,6 +66,17 @@ void OperationExpression::SetOperation(OperationType operation)
 {
    assert(operation != OperationType::None);
    m_operation = operation;
+   m_is_evaluated = false;
+}
+
+bool OperationExpression::IsEvaluated() const
+{
+   return m_is_evaluated;
+}
+
+void OperationExpression::SetEvaluated(bool is_evaluated)
+{
+   m_is_evaluated = is_evaluated;
 }
 
 long OperationExpression::GetChildCount() const
@@ -78,23 +93,27 @@ const TExpressionPtr& OperationExpression::GetChild(long index) const
 TExpressionPtr& OperationExpression::GetChild(long index)
 {
    assert(index >=0 && index < (long)m_children.size());
+   m_is_evaluated = false;
    return m_children[index];
 }
 
 void OperationExpression::AddChild(TExpressionPtr&& expression)
 {
+   m_is_evaluated = false;
    m_children.push_back(std::move(expression));
 }
 
 void OperationExpression::InsertChild(long index, TExpressionPtr&& expression)
 {
    assert(index >=0 && index <= (long)m_children.size());
+   m_is_evaluated = false;
    m_children.insert(m_children.begin() + index, std::move(expression));
 }
 
 void OperationExpression::InsertChildren(long index, TExpressionPtrVector&& expressions)
 {
    assert(index >=0 && index <= (long)m_children.size());
+   m_is_evaluated = false;
    m_children.reserve(m_children.size() + expressions.size());
    for (auto& expression : expressions)
    {
@@ -107,6 +126,7 @@ void OperationExpression::InsertChildren(long index, TExpressionPtrVector&& expr
 void OperationExpression::RemoveChild(long index)
 {
    assert(index >=0 && index < (long)m_children.size());
+   m_is_evaluated = false;
    m_children.erase(m_children.begin() + index);
 }
 
@@ -114,6 +134,7 @@ void OperationExpression::RemoveChildren(long indexFrom, long indexTo)
 {
    assert(indexFrom >=0 && indexFrom < (long)m_children.size());
    assert(indexTo >=0 && indexTo <= (long)m_children.size());
+   m_is_evaluated = false;
    m_children.erase(m_children.begin() + indexFrom, m_children.begin() + indexTo);
 }
 
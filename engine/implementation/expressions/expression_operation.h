@@ -2,6 +2,7 @@
 
 #include "expression_base.h"
 #include "../common/operations.h"
+#include "../common/small_vector.h"
 
 namespace dm
 {
@@ -17,6 +18,11 @@ public:
    OperationType GetOperation() const;
    void SetOperation(OperationType operation);
 
+   // Operation is marked as evaluated by the evaluator. The mark is reset by any
+   // modification of the operation, including access to a non-constant child.
+   bool IsEvaluated() const;
+   void SetEvaluated(bool is_evaluated);
+
    long GetChildCount() const;
    const TExpressionPtr& GetChild(long index) const;
    TExpressionPtr& GetChild(long index);
@@ -40,8 +46,12 @@ private:
    OperationExpression& operator=(const OperationExpression& rhs) = delete;
 
 private:
+   // Most of operations are binary, so their children are stored inline.
+   using TChildren = SmallVector<TExpressionPtr, 2>;
+
    OperationType m_operation;
-   TExpressionPtrVector m_children;
+   bool m_is_evaluated;
+   TChildren m_children;
 };
 
 } // namespace dm
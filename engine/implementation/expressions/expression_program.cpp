@@ -0,0 +1,300 @@
+#include "expression_program.h"
+#include "expression_utils.h"
+#include "expressions.h"
+
+#include "../common/local_array.h"
+
+#include <cassert>
+
+namespace dm
+{
+
+ExpressionProgram::ExpressionProgram(const TExpressionPtr& expr) :
+   m_instructions(), m_stack_size(0), m_curr_stack_size(0)
+{
+   assert(expr.get() != nullptr);
+
+   Compile(expr);
+
+   assert(1 == m_curr_stack_size);
+}
+
+const ExpressionProgram::TInstructionVector& ExpressionProgram::GetInstructions() const
+{
+   return m_instructions;
+}
+
+long ExpressionProgram::GetStackSize() const
+{
+   return m_stack_size;
+}
+
+TBitBlock ExpressionProgram::Execute(const TBitBlock param_values[]) const
+{
+   LOCAL_ARRAY(TBitBlock, stack, m_stack_size);
+   auto top = -1L;
+
+   const auto instruction_count = static_cast<long>(m_instructions.size());
+   for (auto index = 0L; index < instruction_count; ++index)
+   {
+      const auto& instruction = m_instructions[index];
+      switch (instruction.code)
+      {
+         case OpCode::PushFalse:
+            stack[++top] = g_bit_block_false;
+            break;
+
+         case OpCode::PushTrue:
+            stack[++top] = g_bit_block_true;
+            break;
+
+         case OpCode::PushParam:
+            stack[++top] = param_values[instruction.argument];
+            break;
+
+         case OpCode::Not:
+            stack[top] = ~stack[top];
+            break;
+
+         case OpCode::And:
+            stack[top - 1] &= stack[top];
+            --top;
+            break;
+
+         case OpCode::Or:
+            stack[top - 1] |= stack[top];
+            --top;
+            break;
+
+         case OpCode::Implication:
+            stack[top - 1] = ~stack[top - 1] | stack[top];
+            --top;
+            break;
+
+         case OpCode::Xor:
+            stack[top - 1] ^= stack[top];
+            --top;
+            break;
+
+         case OpCode::JumpIfFalse:
+            if (g_bit_block_false == stack[top])
+            {
+               index = instruction.argument - 1;
+            }
+            break;
+
+         case OpCode::JumpIfTrue:
+            if (g_bit_block_true == stack[top])
+            {
+               index = instruction.argument - 1;
+            }
+            break;
+
+         case OpCode::JumpIfFalseSetTrue:
+            if (g_bit_block_false == stack[top])
+            {
+               stack[top] = g_bit_block_true;
+               index = instruction.argument - 1;
+            }
+            break;
+
+         default:
+            assert(!"Unknown instruction code");
+      }
+   }
+
+   assert(0 == top);
+   return stack[0];
+}
+
+void ExpressionProgram::Compile(const TExpressionPtr& expr)
+{
+   switch (expr->GetType())
+   {
+      case ExpressionType::Literal:
+      {
+         Emit(LiteralType::True == CastToLiteral(expr).GetLiteral() ?
+            OpCode::PushTrue : OpCode::PushFalse);
+         break;
+      }
+
+      case ExpressionType::ParamRef:
+      {
+         Emit(OpCode::PushParam, CastToParamRef(expr).GetParamIndex());
+         break;
+      }
+
+      case ExpressionType::Operation:
+      {
+         const auto& expression = CastToOperation(expr);
+         switch (expression.GetOperation())
+         {
+            case OperationType::Negation:
+            {
+               // Nested negations and negations of parity operations are folded
+               // into the parity chain, otherwise just invert the operand.
+               const auto child_operation = GetOperation(expression.GetChild(0));
+               if (OperationType::Negation == child_operation ||
+                   OperationType::Equality == child_operation ||
+                   OperationType::Plus == child_operation)
+               {
+                  CompileParity(expr);
+               }
+               else
+               {
+                  Compile(expression.GetChild(0));
+                  Emit(OpCode::Not);
+               }
+               break;
+            }
+
+            case OperationType::Conjunction:
+               CompileShortCircuit(expr, OpCode::JumpIfFalse, OpCode::And);
+               break;
+
+            case OperationType::Disjunction:
+               CompileShortCircuit(expr, OpCode::JumpIfTrue, OpCode::Or);
+               break;
+
+            case OperationType::Implication:
+               // (x -> y) is 1 if x is 0, and implication is calculated from left to right.
+               CompileShortCircuit(expr, OpCode::JumpIfFalseSetTrue, OpCode::Implication);
+               break;
+
+            case OperationType::Equality:
+            case OperationType::Plus:
+               CompileParity(expr);
+               break;
+
+            default:
+               assert(!"Unknown type of operation");
+         }
+         break;
+      }
+
+      default:
+      {
+         assert(!"Unknown type of expression");
+      }
+   }
+}
+
+void ExpressionProgram::CompileShortCircuit(
+   const TExpressionPtr& expr, OpCode jump_code, OpCode operation_code)
+{
+   const auto& expression = CastToOperation(expr);
+   const auto child_count = expression.GetChildCount();
+
+   Compile(expression.GetChild(0));
+
+   for (auto index = 1L; index < child_count; ++index)
+   {
+      // If the jump is performed, the top already holds the result of operation
+      // over all operands compiled so far and the current one.
+      const auto jump_index = Emit(jump_code);
+      Compile(expression.GetChild(index));
+      Emit(operation_code);
+      PatchJump(jump_index);
+   }
+}
+
+void ExpressionProgram::CompileParity(const TExpressionPtr& expr)
+{
+   std::vector<const TExpressionPtr*> operands;
+   const auto is_inverted = CollectParityOperands(expr, operands);
+
+   if (operands.empty())
+   {
+      Emit(is_inverted ? OpCode::PushTrue : OpCode::PushFalse);
+      return;
+   }
+
+   Compile(*operands[0]);
+   for (auto index = 1L; index < static_cast<long>(operands.size()); ++index)
+   {
+      Compile(*operands[index]);
+      Emit(OpCode::Xor);
+   }
+
+   if (is_inverted)
+   {
+      Emit(OpCode::Not);
+   }
+}
+
+bool ExpressionProgram::CollectParityOperands(
+   const TExpressionPtr& expr, std::vector<const TExpressionPtr*>& operands)
+{
+   // We use following rules:
+   //    1. (x1 + ... + xn) = x1 ^ ... ^ xn
+   //    2. (x1 = ... = xn) = x1 ^ ... ^ xn ^ (n - 1 is odd)
+   //    3. !x = x ^ 1
+   //    4. literals are constant parts of the parity
+
+   const auto literal = GetLiteral(expr);
+   if (LiteralType::None != literal)
+   {
+      return (LiteralType::True == literal);
+   }
+
+   const auto operation = GetOperation(expr);
+   if (OperationType::Negation != operation &&
+       OperationType::Equality != operation &&
+       OperationType::Plus != operation)
+   {
+      operands.push_back(&expr);
+      return false;
+   }
+
+   const auto& expression = CastToOperation(expr);
+   const auto child_count = expression.GetChildCount();
+
+   auto is_inverted = (OperationType::Negation == operation) ||
+                      (OperationType::Equality == operation && 0 == (child_count & 1));
+
+   for (auto index = 0L; index < child_count; ++index)
+   {
+      if (CollectParityOperands(expression.GetChild(index), operands))
+      {
+         is_inverted = !is_inverted;
+      }
+   }
+
+   return is_inverted;
+}
+
+long ExpressionProgram::Emit(OpCode code, long argument)
+{
+   switch (code)
+   {
+      case OpCode::PushFalse:
+      case OpCode::PushTrue:
+      case OpCode::PushParam:
+         if (++m_curr_stack_size > m_stack_size)
+         {
+            m_stack_size = m_curr_stack_size;
+         }
+         break;
+
+      case OpCode::And:
+      case OpCode::Or:
+      case OpCode::Implication:
+      case OpCode::Xor:
+         --m_curr_stack_size;
+         break;
+
+      default:
+         break;
+   }
+
+   m_instructions.push_back(Instruction{code, argument});
+   return static_cast<long>(m_instructions.size()) - 1;
+}
+
+void ExpressionProgram::PatchJump(long index)
+{
+   assert(index >= 0 && index < static_cast<long>(m_instructions.size()));
+   m_instructions[index].argument = static_cast<long>(m_instructions.size());
+}
+
+} // namespace dm
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "expression_base.h"
+#include "../common/literals.h"
+#include "../common/noncopyable.h"
+
+#include <vector>
+#include <memory>
+
+namespace dm
+{
+
+// Flat postfix representation of an expression. It is compiled once from the
+// expression tree and then executed for every block of combinations without
+// recursion, virtual calls and memory allocations.
+class ExpressionProgram : public NonCopyable
+{
+public:
+   enum class OpCode : unsigned char
+   {
+      PushFalse,
+      PushTrue,
+      PushParam,   // Argument is an index of the parameter.
+      Not,
+      And,
+      Or,
+      Implication,
+      Xor,
+      // Conditional jumps are used to skip evaluation of operands which
+      // can't change the result. Argument is an index of the target instruction.
+      JumpIfFalse,        // Jumps if all bits of the top are 0, top is kept.
+      JumpIfTrue,         // Jumps if all bits of the top are 1, top is kept.
+      JumpIfFalseSetTrue  // Jumps if all bits of the top are 0, top is replaced with 1.
+   };
+
+   struct Instruction
+   {
+      OpCode code;
+      long argument;
+   };
+
+   using TInstructionVector = std::vector<Instruction>;
+
+   ExpressionProgram(const TExpressionPtr& expr);
+
+   const TInstructionVector& GetInstructions() const;
+   // Maximum amount of stack elements that is needed during execution.
+   long GetStackSize() const;
+
+   TBitBlock Execute(const TBitBlock param_values[]) const;
+
+private:
+   void Compile(const TExpressionPtr& expr);
+   void CompileShortCircuit(const TExpressionPtr& expr, OpCode jump_code, OpCode operation_code);
+   void CompileParity(const TExpressionPtr& expr);
+
+   // Collects operands of nested plus/equality/negation expressions, so the whole
+   // chain can be calculated as a single sequence of Xor instructions.
+   // Returns true if the result of the chain must be inverted.
+   static bool CollectParityOperands(const TExpressionPtr& expr,
+                                     std::vector<const TExpressionPtr*>& operands);
+
+   long Emit(OpCode code, long argument = 0);
+   void PatchJump(long index);
+
+private:
+   TInstructionVector m_instructions;
+   long m_stack_size;
+   long m_curr_stack_size;
+};
+
+using TExpressionProgramPtr = std::unique_ptr<ExpressionProgram>;
+
+} // namespace dm
@@ -5,6 +5,7 @@
 #include "../common/local_array.h"
 
 #include <algorithm>
+#include <vector>
 #include <cassert>
 
 namespace dm
@@ -25,6 +26,21 @@ LiteralType SimplifyExpressionImpl(TExpressionPtr& expr)
    {
       return LiteralType::None;
    }
+   else if (ExpressionType::Application == type)
+   {
+      // Application is not expanded, so only actual parameters are simplified.
+      auto& application = CastToApplication(expr);
+      for (auto index = 0L; index < application.GetChildCount(); ++index)
+      {
+         auto& child = application.GetChild(index);
+         const auto child_value = SimplifyExpressionImpl(child);
+         if (LiteralType::None != child_value && LiteralType::None == GetLiteral(child))
+         {
+            child = std::make_unique<LiteralExpression>(child_value);
+         }
+      }
+      return LiteralType::None;
+   }
 
    // Case of (ExpressionType::Operation == type)
 
@@ -191,4 +207,119 @@ void SimplifyExpression(TExpressionPtr& expr)
    }
 }
 
+void SimplifyExpression(FlatExpression& expr)
+{
+   const auto node_count = expr.GetNodeCount();
+
+   // Only literals can be simplified.
+   auto has_literals = false;
+   for (auto node = 0L; node < node_count && !has_literals; ++node)
+   {
+      has_literals = (ExpressionType::Literal == expr.GetType(node));
+   }
+
+   if (!has_literals)
+   {
+      return;
+   }
+
+   // Nodes with actual values are not added to the result, literals
+   // for them are added by their parents on the same places, where
+   // the tree version leaves or moves them.
+   FlatExpression result;
+   std::vector<long> new_indexes(node_count, -1);
+   std::vector<LiteralType> values(node_count, LiteralType::None);
+   std::vector<LiteralType> actual_values;
+   std::vector<long> children;
+
+   for (auto node = 0L; node < node_count; ++node)
+   {
+      switch (expr.GetType(node))
+      {
+         case ExpressionType::Literal:
+            values[node] = expr.GetLiteral(node);
+            break;
+
+         case ExpressionType::ParamRef:
+            new_indexes[node] = result.AddParamRef(expr.GetParamIndex(node));
+            break;
+
+         default:
+         {
+            const auto operation = expr.GetOperation(node);
+            const auto child_count = expr.GetChildCount(node);
+
+            actual_values.clear();
+            auto first_actual_values_count = 0L;
+            for (auto index = 0L; index < child_count; ++index)
+            {
+               const auto value = values[expr.GetChild(node, index)];
+               if (LiteralType::None != value)
+               {
+                  if (static_cast<long>(actual_values.size()) == index)
+                  {
+                     ++first_actual_values_count;
+                  }
+                  actual_values.push_back(value);
+               }
+            }
+
+            const auto actual_values_count = static_cast<long>(actual_values.size());
+            if (actual_values_count == child_count)
+            {
+               values[node] = PerformOperation(operation, actual_values.data(), actual_values_count);
+               break;
+            }
+
+            children.clear();
+            auto index = 0L;
+
+            if (0 == actual_values_count)
+            {
+               // Nothing to simplify
+            }
+            else if (AreOperandsMovable(operation))
+            {
+               // All actual values are calculated into a single literal at the end.
+               for (; index < child_count; ++index)
+               {
+                  const auto child = expr.GetChild(node, index);
+                  if (LiteralType::None == values[child])
+                  {
+                     children.push_back(new_indexes[child]);
+                  }
+               }
+               children.push_back(result.AddLiteral((1 == actual_values_count) ? actual_values[0] :
+                  PerformOperation(operation, actual_values.data(), actual_values_count)));
+            }
+            else if (first_actual_values_count > 1)
+            {
+               // Only first actual values can be calculated, if operands can't be moved.
+               children.push_back(result.AddLiteral(
+                  PerformOperation(operation, actual_values.data(), first_actual_values_count)));
+               index = first_actual_values_count;
+            }
+
+            for (; index < child_count; ++index)
+            {
+               const auto child = expr.GetChild(node, index);
+               children.push_back(LiteralType::None != values[child] ?
+                  result.AddLiteral(values[child]) : new_indexes[child]);
+            }
+
+            new_indexes[node] = result.AddOperation(operation, children.data(), children.size());
+            break;
+         }
+      }
+   }
+
+   if (node_count > 0 && LiteralType::None != values[node_count - 1])
+   {
+      result = FlatExpression();
+      result.AddLiteral(values[node_count - 1]);
+   }
+
+   expr = std::move(result);
+}
+
 } // namespace dm
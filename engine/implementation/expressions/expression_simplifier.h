@@ -1,10 +1,13 @@
 #pragma once
 
 #include "expression_base.h"
+#include "expression_flat.h"
 
 namespace dm
 {
 
 void SimplifyExpression(TExpressionPtr& expr);
+// Gives the same result, as the tree version, by a linear scan over nodes.
+void SimplifyExpression(FlatExpression& expr);
 
 } // namespace dm
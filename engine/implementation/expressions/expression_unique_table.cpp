@@ -0,0 +1,559 @@
+#include "expression_unique_table.h"
+#include "expression_simplifier.h"
+#include "expression_utils.h"
+#include "expressions.h"
+
+#include "../variables/variable.h"
+
+#include <functional>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+// Parameters of shallow trees, that are built for simplification of a single
+// operation, refer to children of the operation by indexes.
+const VariableDeclaration& GetPlaceholderDeclaration()
+{
+   static VariableDeclaration declaration;
+   return declaration;
+}
+
+void AppendToString(std::string& result, const UniqueExpression& expression, const VariableDeclaration& variable)
+{
+   switch (expression.GetType())
+   {
+      case ExpressionType::Literal:
+         result += LiteralTypeToString(expression.GetLiteral());
+         break;
+
+      case ExpressionType::ParamRef:
+         result += variable.GetParameter(expression.GetParamIndex()).GetName();
+         break;
+
+      case ExpressionType::Operation:
+      {
+         const auto operation = expression.GetOperation();
+         if (OperationType::Negation == operation)
+         {
+            result += OperationTypeToString(operation);
+            AppendToString(result, *expression.GetChild(0), variable);
+            break;
+         }
+
+         const auto operation_str =
+            std::string(1, ' ') + OperationTypeToString(operation) + std::string(1, ' ');
+
+         result += "(";
+         for (auto index = 0L; index < expression.GetChildCount(); ++index)
+         {
+            if (index != 0)
+            {
+               result += operation_str;
+            }
+            AppendToString(result, *expression.GetChild(index), variable);
+         }
+         result += ")";
+         break;
+      }
+
+      default:
+         assert(!"Unknown expression type");
+   }
+}
+
+// Results of transformation of distinct nodes.
+using TExpressionMap = std::unordered_map<const UniqueExpression*, TUniqueExpressionPtr>;
+
+// Literal operands are folded by the tree simplifier, applied to the shallow tree,
+// where all operands except literals are replaced by placeholders.
+TUniqueExpressionPtr MakeSimplifiedOperation(OperationType operation, TUniqueExpressionPtrVector&& operands)
+{
+   auto& table = UniqueExpressionTable::GetInstance();
+
+   if (OperationType::Negation == operation)
+   {
+      assert(1 == operands.size());
+      if (ExpressionType::Literal == operands[0]->GetType())
+      {
+         const auto literal = operands[0]->GetLiteral();
+         return table.MakeLiteral(PerformOperation(operation, &literal, 1));
+      }
+      return table.MakeOperation(operation, std::move(operands));
+   }
+
+   auto has_literals = false;
+   for (const auto& operand : operands)
+   {
+      has_literals = has_literals || (ExpressionType::Literal == operand->GetType());
+   }
+
+   if (!has_literals)
+   {
+      return table.MakeOperation(operation, std::move(operands));
+   }
+
+   TExpressionPtrVector shallow_children;
+   shallow_children.reserve(operands.size());
+   for (auto index = 0L; index < (long)operands.size(); ++index)
+   {
+      if (ExpressionType::Literal == operands[index]->GetType())
+      {
+         shallow_children.push_back(std::make_unique<LiteralExpression>(operands[index]->GetLiteral()));
+      }
+      else
+      {
+         shallow_children.push_back(std::make_unique<ParamRefExpression>(GetPlaceholderDeclaration(), index));
+      }
+   }
+
+   TExpressionPtr shallow_expr = std::make_unique<OperationExpression>(operation, std::move(shallow_children));
+   SimplifyExpression(shallow_expr);
+
+   return InternExpression(shallow_expr, operands);
+}
+
+TUniqueExpressionPtr SubstituteParamsImpl(const TUniqueExpressionPtr& expr,
+   const TUniqueExpressionPtrVector& params, TExpressionMap& substituted)
+{
+   switch (expr->GetType())
+   {
+      case ExpressionType::Literal:
+         return expr;
+
+      case ExpressionType::ParamRef:
+         return params.at(expr->GetParamIndex());
+
+      case ExpressionType::Operation:
+      {
+         auto iter = substituted.find(expr.get());
+         if (iter != substituted.end())
+         {
+            return iter->second;
+         }
+
+         auto is_changed = false;
+         TUniqueExpressionPtrVector children;
+         children.reserve(expr->GetChildCount());
+         for (auto index = 0L; index < expr->GetChildCount(); ++index)
+         {
+            children.push_back(SubstituteParamsImpl(expr->GetChild(index), params, substituted));
+            is_changed = is_changed || (children.back() != expr->GetChild(index));
+         }
+
+         auto result = is_changed ?
+            UniqueExpressionTable::GetInstance().MakeOperation(expr->GetOperation(), std::move(children)) :
+            expr;
+
+         substituted.emplace(expr.get(), result);
+         return result;
+      }
+
+      default:
+         assert(!"Unknown expression type");
+         return expr;
+   }
+}
+
+TUniqueExpressionPtr NormalizeImpl(const TUniqueExpressionPtr& expr, TExpressionMap& normalized)
+{
+   // Negations are not normalized together with their subtrees, as NormalizeExpression does it.
+   if (ExpressionType::Operation != expr->GetType() || OperationType::Negation == expr->GetOperation())
+   {
+      return expr;
+   }
+
+   auto iter = normalized.find(expr.get());
+   if (iter != normalized.end())
+   {
+      return iter->second;
+   }
+
+   const auto operation = expr->GetOperation();
+   const auto are_operands_movable = AreOperandsMovable(operation);
+
+   auto is_changed = false;
+   TUniqueExpressionPtrVector children;
+   children.reserve(expr->GetChildCount());
+   for (auto index = 0L; index < expr->GetChildCount(); ++index)
+   {
+      auto child = NormalizeImpl(expr->GetChild(index), normalized);
+      if ((are_operands_movable || 0 == index) &&
+          ExpressionType::Operation == child->GetType() && operation == child->GetOperation())
+      {
+         for (auto child_index = 0L; child_index < child->GetChildCount(); ++child_index)
+         {
+            children.push_back(child->GetChild(child_index));
+         }
+         is_changed = true;
+      }
+      else
+      {
+         is_changed = is_changed || (child != expr->GetChild(index));
+         children.push_back(std::move(child));
+      }
+   }
+
+   auto result = is_changed ?
+      UniqueExpressionTable::GetInstance().MakeOperation(operation, std::move(children)) :
+      expr;
+
+   normalized.emplace(expr.get(), result);
+   return result;
+}
+
+TUniqueExpressionPtr SimplifyImpl(const TUniqueExpressionPtr& expr, TExpressionMap& simplified)
+{
+   if (ExpressionType::Operation != expr->GetType())
+   {
+      return expr;
+   }
+
+   auto iter = simplified.find(expr.get());
+   if (iter != simplified.end())
+   {
+      return iter->second;
+   }
+
+   // Children are simplified before their parent, as SimplifyExpression does it,
+   // so only literal operands of the parent are left to fold.
+   auto is_changed = false;
+   auto has_literals = false;
+   TUniqueExpressionPtrVector children;
+   children.reserve(expr->GetChildCount());
+   for (auto index = 0L; index < expr->GetChildCount(); ++index)
+   {
+      children.push_back(SimplifyImpl(expr->GetChild(index), simplified));
+      is_changed = is_changed || (children.back() != expr->GetChild(index));
+      has_literals = has_literals || (ExpressionType::Literal == children.back()->GetType());
+   }
+
+   auto result = (is_changed || has_literals) ?
+      MakeSimplifiedOperation(expr->GetOperation(), std::move(children)) :
+      expr;
+
+   simplified.emplace(expr.get(), result);
+   return result;
+}
+
+} // namespace
+
+///////////// UniqueExpression //////////////
+
+UniqueExpression::UniqueExpression(ExpressionType type, LiteralType literal, long param_index,
+                                   OperationType operation, TUniqueExpressionPtrVector&& children, std::size_t hash) :
+   m_type(type), m_literal(literal), m_param_index(param_index),
+   m_operation(operation), m_children(std::move(children)), m_hash(hash)
+{
+}
+
+ExpressionType UniqueExpression::GetType() const
+{
+   return m_type;
+}
+
+LiteralType UniqueExpression::GetLiteral() const
+{
+   return m_literal;
+}
+
+long UniqueExpression::GetParamIndex() const
+{
+   return m_param_index;
+}
+
+OperationType UniqueExpression::GetOperation() const
+{
+   return m_operation;
+}
+
+long UniqueExpression::GetChildCount() const
+{
+   return m_children.size();
+}
+
+const TUniqueExpressionPtr& UniqueExpression::GetChild(long index) const
+{
+   assert(index >= 0 && index < (long)m_children.size());
+   return m_children[index];
+}
+
+bool UniqueExpression::IsEqual(ExpressionType type, LiteralType literal, long param_index,
+                               OperationType operation, const TUniqueExpressionPtrVector& children) const
+{
+   // Children are unique, so they are compared by pointers.
+   return m_type == type && m_literal == literal && m_param_index == param_index &&
+          m_operation == operation && m_children == children;
+}
+
+///////////// UniqueExpressionTable //////////////
+
+UniqueExpressionTable& UniqueExpressionTable::GetInstance()
+{
+   static UniqueExpressionTable table;
+   return table;
+}
+
+UniqueExpressionTable::UniqueExpressionTable() : m_mutex(), m_nodes()
+{
+}
+
+TUniqueExpressionPtr UniqueExpressionTable::MakeLiteral(LiteralType literal)
+{
+   assert(literal != LiteralType::None);
+   return FindOrAdd(ExpressionType::Literal, literal, -1, OperationType::None, TUniqueExpressionPtrVector());
+}
+
+TUniqueExpressionPtr UniqueExpressionTable::MakeParamRef(long param_index)
+{
+   assert(param_index >= 0);
+   return FindOrAdd(ExpressionType::ParamRef, LiteralType::None, param_index, OperationType::None, TUniqueExpressionPtrVector());
+}
+
+TUniqueExpressionPtr UniqueExpressionTable::MakeOperation(OperationType operation, TUniqueExpressionPtrVector&& children)
+{
+   assert
+   (
+      (OperationType::Negation == operation && children.size() == 1) ||
+      (OperationType::Negation != operation && children.size() > 1)
+   );
+   return FindOrAdd(ExpressionType::Operation, LiteralType::None, -1, operation, std::move(children));
+}
+
+TUniqueExpressionPtr UniqueExpressionTable::MakeNormalizedOperation(
+   OperationType operation, TUniqueExpressionPtrVector&& children)
+{
+   // Negation isn't normalized, but negation of a literal is simplified.
+   if (OperationType::Negation == operation)
+   {
+      return MakeSimplifiedOperation(operation, std::move(children));
+   }
+
+   const auto are_operands_movable = AreOperandsMovable(operation);
+
+   TUniqueExpressionPtrVector operands;
+   operands.reserve(children.size());
+
+   for (auto index = 0L; index < (long)children.size(); ++index)
+   {
+      auto& child = children[index];
+      if ((are_operands_movable || 0 == index) &&
+          ExpressionType::Operation == child->GetType() && operation == child->GetOperation())
+      {
+         for (auto child_index = 0L; child_index < child->GetChildCount(); ++child_index)
+         {
+            operands.push_back(child->GetChild(child_index));
+         }
+      }
+      else
+      {
+         operands.push_back(std::move(child));
+      }
+   }
+
+   return MakeSimplifiedOperation(operation, std::move(operands));
+}
+
+long UniqueExpressionTable::GetNodeCount() const
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+   return m_nodes.size();
+}
+
+TUniqueExpressionPtr UniqueExpressionTable::FindOrAdd(ExpressionType type, LiteralType literal, long param_index,
+                                                      OperationType operation, TUniqueExpressionPtrVector&& children)
+{
+   const auto hash = GetHash(type, literal, param_index, operation, children);
+
+   std::lock_guard<std::mutex> lock(m_mutex);
+
+   const auto range = m_nodes.equal_range(hash);
+   for (auto iter = range.first; iter != range.second; ++iter)
+   {
+      // The node can be already released, but not removed from the table yet.
+      auto node = iter->second.lock();
+      if (node.get() != nullptr && node->IsEqual(type, literal, param_index, operation, children))
+      {
+         return node;
+      }
+   }
+
+   TUniqueExpressionPtr node(
+      new UniqueExpression(type, literal, param_index, operation, std::move(children), hash),
+      [this](const UniqueExpression* node)
+      {
+         Remove(node);
+         // Children are released after the lock is freed, since they remove themselves too.
+         delete node;
+      });
+
+   m_nodes.emplace(hash, node);
+   return node;
+}
+
+void UniqueExpressionTable::Remove(const UniqueExpression* node)
+{
+   std::lock_guard<std::mutex> lock(m_mutex);
+
+   // The entry of the released node is already expired, as well as entries of other
+   // nodes, that are being released concurrently. They can be removed together.
+   const auto range = m_nodes.equal_range(node->m_hash);
+   for (auto iter = range.first; iter != range.second;)
+   {
+      if (iter->second.expired())
+      {
+         iter = m_nodes.erase(iter);
+      }
+      else
+      {
+         ++iter;
+      }
+   }
+}
+
+std::size_t UniqueExpressionTable::GetHash(ExpressionType type, LiteralType literal, long param_index,
+                                           OperationType operation, const TUniqueExpressionPtrVector& children)
+{
+   auto hash = std::hash<long>()(static_cast<long>(type));
+
+   const auto combine = [&hash](std::size_t value)
+   {
+      hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+   };
+
+   combine(std::hash<long>()(static_cast<long>(literal)));
+   combine(std::hash<long>()(param_index));
+   combine(std::hash<long>()(static_cast<long>(operation)));
+   for (const auto& child : children)
+   {
+      combine(std::hash<const UniqueExpression*>()(child.get()));
+   }
+
+   return hash;
+}
+
+///////////// Functions //////////////
+
+TUniqueExpressionPtr InternExpression(const TExpressionPtr& expr, const TUniqueExpressionPtrVector& params)
+{
+   assert(expr.get() != nullptr);
+   auto& table = UniqueExpressionTable::GetInstance();
+
+   switch (expr->GetType())
+   {
+      case ExpressionType::Literal:
+         return table.MakeLiteral(CastToLiteral(expr).GetLiteral());
+
+      case ExpressionType::ParamRef:
+      {
+         const auto param_index = CastToParamRef(expr).GetParamIndex();
+         return params.empty() ? table.MakeParamRef(param_index) : params.at(param_index);
+      }
+
+      case ExpressionType::Operation:
+      {
+         const auto& expression = CastToOperation(expr);
+
+         TUniqueExpressionPtrVector children;
+         children.reserve(expression.GetChildCount());
+         for (auto index = 0L; index < expression.GetChildCount(); ++index)
+         {
+            children.push_back(InternExpression(expression.GetChild(index), params));
+         }
+
+         return table.MakeOperation(expression.GetOperation(), std::move(children));
+      }
+
+      case ExpressionType::Application:
+      {
+         // Hash-consed expression of the applied variable is shared, so
+         // the application is expanded without copying of its tree.
+         const auto& expression = CastToApplication(expr);
+
+         TUniqueExpressionPtrVector actual_params;
+         actual_params.reserve(expression.GetChildCount());
+         for (auto index = 0L; index < expression.GetChildCount(); ++index)
+         {
+            actual_params.push_back(InternExpression(expression.GetChild(index), params));
+         }
+
+         return SubstituteParams(expression.GetVariable().GetSharedExpression(), actual_params);
+      }
+
+      default:
+         assert(!"Unknown expression type");
+         return TUniqueExpressionPtr();
+   }
+}
+
+TUniqueExpressionPtr SubstituteParams(const TUniqueExpressionPtr& expr, const TUniqueExpressionPtrVector& params)
+{
+   assert(expr.get() != nullptr);
+
+   TExpressionMap substituted;
+   return SubstituteParamsImpl(expr, params, substituted);
+}
+
+TUniqueExpressionPtr NormalizeUniqueExpression(const TUniqueExpressionPtr& expr)
+{
+   assert(expr.get() != nullptr);
+
+   TExpressionMap normalized;
+   return NormalizeImpl(expr, normalized);
+}
+
+TUniqueExpressionPtr SimplifyUniqueExpression(const TUniqueExpressionPtr& expr)
+{
+   assert(expr.get() != nullptr);
+
+   TExpressionMap simplified;
+   return SimplifyImpl(expr, simplified);
+}
+
+TExpressionPtr ExpandExpression(const TUniqueExpressionPtr& expr, const VariableDeclaration& variable)
+{
+   assert(expr.get() != nullptr);
+
+   switch (expr->GetType())
+   {
+      case ExpressionType::Literal:
+         return std::make_unique<LiteralExpression>(expr->GetLiteral());
+
+      case ExpressionType::ParamRef:
+         return std::make_unique<ParamRefExpression>(variable, expr->GetParamIndex());
+
+      case ExpressionType::Operation:
+      {
+         TExpressionPtrVector children;
+         children.reserve(expr->GetChildCount());
+         for (auto index = 0L; index < expr->GetChildCount(); ++index)
+         {
+            children.push_back(ExpandExpression(expr->GetChild(index), variable));
+         }
+
+         if (OperationType::Negation == expr->GetOperation())
+         {
+            return std::make_unique<OperationExpression>(std::move(children[0]));
+         }
+         return std::make_unique<OperationExpression>(expr->GetOperation(), std::move(children));
+      }
+
+      default:
+         assert(!"Unknown expression type");
+         return TExpressionPtr();
+   }
+}
+
+std::string UniqueExpressionToString(const TUniqueExpressionPtr& expr, const VariableDeclaration& variable)
+{
+   assert(expr.get() != nullptr);
+
+   std::string result;
+   AppendToString(result, *expr, variable);
+   return result;
+}
+
+} // namespace dm
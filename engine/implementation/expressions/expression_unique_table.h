@@ -0,0 +1,113 @@
+#pragma once
+
+#include "expression_base.h"
+#include "../common/literals.h"
+#include "../common/operations.h"
+#include "../common/noncopyable.h"
+
+#include <memory>
+#include <vector>
+#include <string>
+#include <mutex>
+#include <unordered_map>
+
+namespace dm
+{
+
+class VariableDeclaration;
+
+class UniqueExpression;
+using TUniqueExpressionPtr = std::shared_ptr<const UniqueExpression>;
+using TUniqueExpressionPtrVector = std::vector<TUniqueExpressionPtr>;
+
+// Immutable hash-consed expression node. Structurally identical nodes are
+// represented by a single instance, so expressions form a DAG, that can be
+// compared by pointers. Parameters are represented by indexes only, so the
+// same node is shared between variables with different parameter names.
+class UniqueExpression : public NonCopyable
+{
+public:
+   ExpressionType GetType() const;
+   LiteralType GetLiteral() const;
+   long GetParamIndex() const;
+   OperationType GetOperation() const;
+
+   long GetChildCount() const;
+   const TUniqueExpressionPtr& GetChild(long index) const;
+
+private:
+   friend class UniqueExpressionTable;
+
+   UniqueExpression(ExpressionType type, LiteralType literal, long param_index,
+                    OperationType operation, TUniqueExpressionPtrVector&& children, std::size_t hash);
+
+   bool IsEqual(ExpressionType type, LiteralType literal, long param_index,
+                OperationType operation, const TUniqueExpressionPtrVector& children) const;
+
+private:
+   ExpressionType m_type;
+   LiteralType m_literal;
+   long m_param_index;
+   OperationType m_operation;
+   TUniqueExpressionPtrVector m_children;
+   std::size_t m_hash;
+};
+
+// Global unique table of hash-consed nodes, keyed on the node contents and
+// identities of its children. Nodes are removed from the table when the last
+// reference to them is released.
+class UniqueExpressionTable : public NonCopyable
+{
+public:
+   static UniqueExpressionTable& GetInstance();
+
+   TUniqueExpressionPtr MakeLiteral(LiteralType literal);
+   TUniqueExpressionPtr MakeParamRef(long param_index);
+   // Children are kept as is.
+   TUniqueExpressionPtr MakeOperation(OperationType operation, TUniqueExpressionPtrVector&& children);
+   // Merges children with the same operation and folds literal children in the same
+   // way, as NormalizeExpression and SimplifyExpression do it for expression trees.
+   TUniqueExpressionPtr MakeNormalizedOperation(OperationType operation, TUniqueExpressionPtrVector&& children);
+
+   // Amount of nodes, that are alive.
+   long GetNodeCount() const;
+
+private:
+   UniqueExpressionTable();
+
+   TUniqueExpressionPtr FindOrAdd(ExpressionType type, LiteralType literal, long param_index,
+                                  OperationType operation, TUniqueExpressionPtrVector&& children);
+   void Remove(const UniqueExpression* node);
+
+   static std::size_t GetHash(ExpressionType type, LiteralType literal, long param_index,
+                              OperationType operation, const TUniqueExpressionPtrVector& children);
+
+private:
+   using TNodeMap = std::unordered_multimap<std::size_t, std::weak_ptr<const UniqueExpression>>;
+
+   mutable std::mutex m_mutex;
+   TNodeMap m_nodes;
+};
+
+// Converts the expression tree into the hash-consed form. Parameter with index i
+// is replaced by params[i], or by the parameter node itself if params are empty.
+TUniqueExpressionPtr InternExpression(const TExpressionPtr& expr,
+   const TUniqueExpressionPtrVector& params = TUniqueExpressionPtrVector());
+
+// Replaces parameters with actual values. Each distinct node is substituted once,
+// so the result is built in time, linear to the amount of distinct nodes.
+TUniqueExpressionPtr SubstituteParams(const TUniqueExpressionPtr& expr, const TUniqueExpressionPtrVector& params);
+
+// Build the same expressions, as NormalizeExpression and SimplifyExpression build
+// from the expanded tree, so hash-consing doesn't change the printed form.
+// Each distinct node is transformed once.
+TUniqueExpressionPtr NormalizeUniqueExpression(const TUniqueExpressionPtr& expr);
+TUniqueExpressionPtr SimplifyUniqueExpression(const TUniqueExpressionPtr& expr);
+
+// Builds the expression tree, which references parameters of the variable.
+TExpressionPtr ExpandExpression(const TUniqueExpressionPtr& expr, const VariableDeclaration& variable);
+
+// The same string, as the expanded tree has.
+std::string UniqueExpressionToString(const TUniqueExpressionPtr& expr, const VariableDeclaration& variable);
+
+} // namespace dm
@@ -48,6 +48,20 @@ OperationExpression& CastToOperation(TExpressionPtr& expr)
    return static_cast<OperationExpression&>(*expr.get());
 }
 
+const ApplicationExpression& CastToApplication(const TExpressionPtr& expr)
+{
+   assert(expr.get() != nullptr);
+   assert(expr->GetType() == ExpressionType::Application);
+   return static_cast<const ApplicationExpression&>(*expr.get());
+}
+
+ApplicationExpression& CastToApplication(TExpressionPtr& expr)
+{
+   assert(expr.get() != nullptr);
+   assert(expr->GetType() == ExpressionType::Application);
+   return static_cast<ApplicationExpression&>(*expr.get());
+}
+
 LiteralType GetLiteral(const TExpressionPtr& expr)
 {
    assert(expr.get() != nullptr);
@@ -11,6 +11,7 @@ namespace dm
 class LiteralExpression;
 class ParamRefExpression;
 class OperationExpression;
+class ApplicationExpression;
 
 // Expression casts
 const LiteralExpression& CastToLiteral(const TExpressionPtr& expr);
@@ -19,6 +20,8 @@ const ParamRefExpression& CastToParamRef(const TExpressionPtr& expr);
 ParamRefExpression& CastToParamRef(TExpressionPtr& expr);
 const OperationExpression& CastToOperation(const TExpressionPtr& expr);
 OperationExpression& CastToOperation(TExpressionPtr& expr);
+const ApplicationExpression& CastToApplication(const TExpressionPtr& expr);
+ApplicationExpression& CastToApplication(TExpressionPtr& expr);
 
 // Helpers
 LiteralType GetLiteral(const TExpressionPtr& expr);
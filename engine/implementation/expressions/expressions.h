@@ -2,4 +2,5 @@
 
 #include "expression_literal.h"
 #include "expression_param_ref.h"
-#include "expression_operation.h"
\ No newline at end of file
+#include "expression_operation.h"
+#include "expression_application.h"
\ No newline at end of file
@@ -0,0 +1,208 @@
+#include "consensus.h"
+#include "cube_set.h"
+#include "../expressions/expression_utils.h"
+#include "../variables/variable_declaration.h"
+
+#include <algorithm>
+#include <numeric>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+// Disjunctions with more prime implicants are left to the evaluator.
+const size_t g_max_evaluated_cube_count = 4096;
+
+// Checks that the disjunction of cubes is true on all combinations by splitting
+// by the variable, which is in the most cubes with both signs.
+bool IsTautology(const TCubeVector& cubes)
+{
+   auto positive = TBitBlock(0);
+   auto negative = TBitBlock(0);
+   for (const auto& cube : cubes)
+   {
+      if (0 == cube.mask)
+      {
+         return true;
+      }
+      positive |= cube.values;
+      negative |= cube.mask & ~cube.values;
+   }
+
+   // Disjunction, where each variable has a single sign, is false on the combination,
+   // where all variables have opposite signs.
+   auto binate = positive & negative;
+   if (0 == binate)
+   {
+      return false;
+   }
+
+   auto split_bit = TBitBlock(0);
+   auto split_count = 0L;
+   for (; binate != 0; binate &= binate - 1)
+   {
+      const auto bit = binate & ~(binate - 1);
+      const auto count = std::count_if(cubes.begin(), cubes.end(), [bit](const Cube& cube)
+      {
+         return 0 != (cube.mask & bit);
+      });
+      if (count > split_count)
+      {
+         split_bit = bit;
+         split_count = count;
+      }
+   }
+
+   for (auto value : { split_bit, TBitBlock(0) })
+   {
+      TCubeVector cofactor;
+      cofactor.reserve(cubes.size());
+      for (const auto& cube : cubes)
+      {
+         if (0 == (cube.mask & split_bit) || (cube.values & split_bit) == value)
+         {
+            cofactor.push_back(Cube{ cube.mask & ~split_bit, cube.values & ~split_bit });
+         }
+      }
+      if (!IsTautology(cofactor))
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+} // namespace
+
+bool BuildBlakeCubes(TCubeVector& cubes, size_t max_cube_count)
+{
+   if (cubes.size() > max_cube_count)
+   {
+      return false;
+   }
+
+   CubeSet cube_set(max_cube_count);
+   auto used_bits = TBitBlock(0);
+   for (const auto& cube : cubes)
+   {
+      cube_set.Add(cube);
+      used_bits |= cube.mask;
+   }
+
+   // Consensus by a variable is made for cubes, which are in the set at the beginning of
+   // its pass, as new cubes don't have this variable. Cubes, which are absorbed meanwhile,
+   // are skipped, as consensuses with them are absorbed by the absorbing cube.
+   TCubeVector positive_cubes;
+   TCubeVector negative_cubes;
+   for (; used_bits != 0; used_bits &= used_bits - 1)
+   {
+      const auto bit = used_bits & ~(used_bits - 1);
+
+      positive_cubes.clear();
+      negative_cubes.clear();
+      cube_set.ForEachCube([&](const Cube& cube)
+      {
+         if (cube.mask & bit)
+         {
+            ((cube.values & bit) ? positive_cubes : negative_cubes).push_back(cube);
+         }
+      });
+
+      for (const auto& positive_cube : positive_cubes)
+      {
+         for (const auto& negative_cube : negative_cubes)
+         {
+            if (GetCubeConflicts(positive_cube, negative_cube) != bit)
+            {
+               continue;
+            }
+            if (!cube_set.Contains(positive_cube))
+            {
+               break;
+            }
+            if (!cube_set.Contains(negative_cube))
+            {
+               continue;
+            }
+
+            const auto mask = (positive_cube.mask | negative_cube.mask) & ~bit;
+            const auto values = (positive_cube.values | negative_cube.values) & ~bit;
+            if (cube_set.Add(Cube{ mask, values }) && cube_set.IsOverflowed())
+            {
+               return false;
+            }
+         }
+      }
+   }
+
+   cube_set.MoveCubes(cubes);
+   return true;
+}
+
+void RemoveRedundantCubes(TCubeVector& cubes, long param_count)
+{
+   SortCubes(cubes, param_count);
+
+   // Cubes with more literals cover less combinations, so they are checked first.
+   std::vector<size_t> order(cubes.size());
+   std::iota(order.begin(), order.end(), size_t(0));
+   std::stable_sort(order.begin(), order.end(), [&cubes](size_t left, size_t right)
+   {
+      return CountSetBits(cubes[left].mask) > CountSetBits(cubes[right].mask);
+   });
+
+   // The cube is covered by the other ones, if their cofactor by it is a tautology.
+   std::vector<bool> is_removed(cubes.size(), false);
+   TCubeVector cofactor;
+   for (auto index : order)
+   {
+      const auto& cube = cubes[index];
+      cofactor.clear();
+      for (auto other_index = size_t(0); other_index < cubes.size(); ++other_index)
+      {
+         const auto& other_cube = cubes[other_index];
+         if (other_index != index && !is_removed[other_index] && DoCubesIntersect(cube, other_cube))
+         {
+            cofactor.push_back(Cube{ other_cube.mask & ~cube.mask, other_cube.values & ~cube.mask });
+         }
+      }
+      is_removed[index] = IsTautology(cofactor);
+   }
+
+   auto last = size_t(0);
+   for (auto index = size_t(0); index < cubes.size(); ++index)
+   {
+      if (!is_removed[index])
+      {
+         cubes[last++] = cubes[index];
+      }
+   }
+   cubes.resize(last);
+}
+
+bool EvaluateDnfExpression(TExpressionPtr& expr, const VariableDeclaration& variable)
+{
+   const auto param_count = variable.GetParameterCount();
+   if (param_count > g_bit_block_size ||
+       ExpressionType::Operation != expr->GetType() ||
+       OperationType::Disjunction != GetOperation(expr))
+   {
+      return false;
+   }
+
+   TCubeVector cubes;
+   if (!GetDnfCubes(expr, param_count, cubes) ||
+       !BuildBlakeCubes(cubes, g_max_evaluated_cube_count))
+   {
+      return false;
+   }
+
+   RemoveRedundantCubes(cubes, param_count);
+   expr = BuildDnfExpression(cubes, variable);
+   return true;
+}
+
+} // namespace dm
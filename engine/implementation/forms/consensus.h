@@ -0,0 +1,26 @@
+#pragma once
+
+#include "cube.h"
+
+namespace dm
+{
+
+class VariableDeclaration;
+
+// Replaces cubes by all prime cubes of their disjunction (Blake canonical form) by
+// iterated consensus with absorption, making consensus by each variable once (Tison's
+// method). Returns false and leaves cubes in an unspecified state, if the amount
+// of cubes exceeds max_cube_count.
+bool BuildBlakeCubes(TCubeVector& cubes, size_t max_cube_count);
+
+// Removes cubes, which are covered by the other ones, starting from the smallest ones.
+// Cubes are sorted by SortCubes.
+void RemoveRedundantCubes(TCubeVector& cubes, long param_count);
+
+// Replaces the disjunction of conjunctions of literals by the disjunction of prime
+// implicants, none of which is covered by the others. It's the result of absorption,
+// gluing, Blake-Poretsky and consensus laws. Returns false, if the expression
+// isn't a disjunction of conjunctions of literals or has too many prime implicants.
+bool EvaluateDnfExpression(TExpressionPtr& expr, const VariableDeclaration& variable);
+
+} // namespace dm
@@ -0,0 +1,214 @@
+#include "cube.h"
+#include "../expressions/expressions.h"
+#include "../expressions/expression_utils.h"
+#include "../variables/variable_declaration.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+// Literal of the term is negated, if its sign in the cube differs from is_positive.
+TExpressionPtr BuildTerm(const Cube& cube, const VariableDeclaration& variable,
+                         OperationType operation, bool is_positive)
+{
+   const auto param_count = variable.GetParameterCount();
+
+   TExpressionPtrVector literals;
+   for (auto param_index = 0L; param_index < param_count; ++param_index)
+   {
+      const auto bit = TBitBlock(1) << (param_count - 1 - param_index);
+      if (0 == (cube.mask & bit))
+      {
+         continue;
+      }
+
+      TExpressionPtr literal = std::make_unique<ParamRefExpression>(variable, param_index);
+      if ((0 != (cube.values & bit)) != is_positive)
+      {
+         literal = std::make_unique<OperationExpression>(std::move(literal));
+      }
+      literals.push_back(std::move(literal));
+   }
+
+   assert(!literals.empty());
+   if (1 == literals.size())
+   {
+      return std::move(literals[0]);
+   }
+   return std::make_unique<OperationExpression>(operation, std::move(literals));
+}
+
+TExpressionPtr BuildTwoLevelExpression(const TCubeVector& cubes, const VariableDeclaration& variable,
+                                       OperationType operation, OperationType term_operation, bool is_positive)
+{
+   // Empty cube covers all combinations, so the expression is a constant.
+   const auto empty_literal = is_positive ? LiteralType::True : LiteralType::False;
+   if (cubes.empty())
+   {
+      return std::make_unique<LiteralExpression>(
+         is_positive ? LiteralType::False : LiteralType::True);
+   }
+
+   TExpressionPtrVector terms;
+   terms.reserve(cubes.size());
+   for (const auto& cube : cubes)
+   {
+      if (0 == cube.mask)
+      {
+         return std::make_unique<LiteralExpression>(empty_literal);
+      }
+      terms.push_back(BuildTerm(cube, variable, term_operation, is_positive));
+   }
+
+   if (1 == terms.size())
+   {
+      return std::move(terms[0]);
+   }
+   return std::make_unique<OperationExpression>(operation, std::move(terms));
+}
+
+// Adds the literal to the cube. Returns false if the expression isn't a literal.
+bool AddCubeLiteral(const TExpressionPtr& expr, long param_count, Cube& cube, bool& is_contradiction)
+{
+   auto is_positive = true;
+   const TExpressionPtr* param_ref = &expr;
+   if (ExpressionType::Operation == expr->GetType() && OperationType::Negation == GetOperation(expr))
+   {
+      is_positive = false;
+      param_ref = &CastToOperation(expr).GetChild(0);
+   }
+
+   if (ExpressionType::Literal == (*param_ref)->GetType())
+   {
+      is_contradiction = is_contradiction || ((LiteralType::True == GetLiteral(*param_ref)) != is_positive);
+      return true;
+   }
+   if (ExpressionType::ParamRef != (*param_ref)->GetType())
+   {
+      return false;
+   }
+
+   const auto bit = TBitBlock(1) << (param_count - 1 - GetParamIndex(*param_ref));
+   if ((cube.mask & bit) && (0 != (cube.values & bit)) != is_positive)
+   {
+      is_contradiction = true;
+   }
+   cube.mask |= bit;
+   cube.values |= is_positive ? bit : 0;
+   return true;
+}
+
+} // namespace
+
+bool GetDnfCubes(const TExpressionPtr& expr, long param_count, TCubeVector& cubes)
+{
+   assert(param_count <= g_bit_block_size);
+
+   if (ExpressionType::Operation == expr->GetType() && OperationType::Disjunction == GetOperation(expr))
+   {
+      const auto& expression = CastToOperation(expr);
+      for (auto index = 0L; index < expression.GetChildCount(); ++index)
+      {
+         if (!GetDnfCubes(expression.GetChild(index), param_count, cubes))
+         {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   Cube cube{ 0, 0 };
+   auto is_contradiction = false;
+   if (ExpressionType::Operation == expr->GetType() && OperationType::Conjunction == GetOperation(expr))
+   {
+      const auto& expression = CastToOperation(expr);
+      for (auto index = 0L; index < expression.GetChildCount(); ++index)
+      {
+         if (!AddCubeLiteral(expression.GetChild(index), param_count, cube, is_contradiction))
+         {
+            return false;
+         }
+      }
+   }
+   else if (!AddCubeLiteral(expr, param_count, cube, is_contradiction))
+   {
+      return false;
+   }
+
+   if (!is_contradiction)
+   {
+      cubes.push_back(cube);
+   }
+   return true;
+}
+
+void SortCubes(TCubeVector& cubes, long param_count)
+{
+   // Parameters go from the highest bit, so cubes are compared by bits from the highest one.
+   // For the highest differing bit of masks the cube with the parameter goes first,
+   // otherwise for the highest differing bit of values the positive cube goes first.
+   std::sort(cubes.begin(), cubes.end(), [param_count](const Cube& left, const Cube& right)
+   {
+      const auto mask_diff = left.mask ^ right.mask;
+      const auto values_diff = (left.values ^ right.values) & left.mask & right.mask;
+      for (auto bit = param_count - 1; bit >= 0; --bit)
+      {
+         const auto bit_mask = TBitBlock(1) << bit;
+         if (values_diff & bit_mask)
+         {
+            return 0 != (left.values & bit_mask);
+         }
+         if (mask_diff & bit_mask)
+         {
+            return 0 != (left.mask & bit_mask);
+         }
+      }
+      return false;
+   });
+}
+
+TExpressionPtr BuildDnfExpression(const TCubeVector& cubes, const VariableDeclaration& variable)
+{
+   return BuildTwoLevelExpression(cubes, variable, OperationType::Disjunction, OperationType::Conjunction, true);
+}
+
+TExpressionPtr BuildCnfExpression(const TCubeVector& cubes, const VariableDeclaration& variable)
+{
+   return BuildTwoLevelExpression(cubes, variable, OperationType::Conjunction, OperationType::Disjunction, false);
+}
+
+TExpressionPtr BuildZhegalkinExpression(const TCubeVector& monomials, const VariableDeclaration& variable)
+{
+   if (monomials.empty())
+   {
+      return std::make_unique<LiteralExpression>(LiteralType::False);
+   }
+
+   TExpressionPtrVector terms;
+   terms.reserve(monomials.size());
+   for (const auto& monomial : monomials)
+   {
+      assert(monomial.values == monomial.mask);
+      if (0 == monomial.mask)
+      {
+         terms.push_back(std::make_unique<LiteralExpression>(LiteralType::True));
+      }
+      else
+      {
+         terms.push_back(BuildTerm(monomial, variable, OperationType::Conjunction, true));
+      }
+   }
+
+   if (1 == terms.size())
+   {
+      return std::move(terms[0]);
+   }
+   return std::make_unique<OperationExpression>(OperationType::Plus, std::move(terms));
+}
+
+} // namespace dm
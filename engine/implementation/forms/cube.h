@@ -0,0 +1,88 @@
+#pragma once
+
+#include "../expressions/expression_base.h"
+#include "../common/literals.h"
+
+#include <vector>
+
+namespace dm
+{
+
+class VariableDeclaration;
+
+// Conjunction of literals, packed into two bit masks. Variable v of a cube is the v-th
+// bit (counting from the lowest one) of a combination number in the truth table,
+// so it's parameter (param_count - 1 - v) of a variable.
+struct Cube
+{
+   // Bit v is set, if variable v is in the cube.
+   TBitBlock mask;
+   // Bit v is set, if variable v is in the cube without negation.
+   // Bits, that are not in the mask, are zero.
+   TBitBlock values;
+};
+
+using TCubeVector = std::vector<Cube>;
+
+// Cube, that consists of all variables and covers the single combination.
+inline Cube MakeMintermCube(long param_count, long long combination)
+{
+   const auto mask = (param_count < g_bit_block_size) ?
+      ((TBitBlock(1) << param_count) - 1) : g_bit_block_true;
+   return Cube{ mask, static_cast<TBitBlock>(combination) & mask };
+}
+
+inline bool operator==(const Cube& left, const Cube& right)
+{
+   return left.mask == right.mask && left.values == right.values;
+}
+
+inline bool operator!=(const Cube& left, const Cube& right)
+{
+   return !(left == right);
+}
+
+// Returns true if all combinations of the contained cube are covered by the containing one.
+inline bool DoesCubeContain(const Cube& containing, const Cube& contained)
+{
+   return 0 == (containing.mask & ~contained.mask) &&
+          0 == ((containing.values ^ contained.values) & containing.mask);
+}
+
+inline bool DoCubesIntersect(const Cube& left, const Cube& right)
+{
+   return 0 == ((left.values ^ right.values) & left.mask & right.mask);
+}
+
+// Variables, that are in both cubes with different signs.
+inline TBitBlock GetCubeConflicts(const Cube& left, const Cube& right)
+{
+   return (left.values ^ right.values) & left.mask & right.mask;
+}
+
+// Minimal cube, that contains both cubes.
+inline Cube GetSupercube(const Cube& left, const Cube& right)
+{
+   const auto mask = left.mask & right.mask & ~GetCubeConflicts(left, right);
+   return Cube{ mask, left.values & mask };
+}
+
+// Sorts cubes in order of parameters of the variable: the cube with the first
+// parameter without negation goes first, then the one with negated parameter,
+// and then the one without the parameter.
+void SortCubes(TCubeVector& cubes, long param_count);
+
+// Adds cubes of a disjunction of conjunctions of literals (or a single conjunction,
+// or a single literal) to the vector. Contradictory conjunctions are skipped.
+// Returns false if the expression has another shape.
+bool GetDnfCubes(const TExpressionPtr& expr, long param_count, TCubeVector& cubes);
+
+// Disjunction of conjunctions, formed by cubes, that cover true combinations.
+TExpressionPtr BuildDnfExpression(const TCubeVector& cubes, const VariableDeclaration& variable);
+// Conjunction of disjunctions, which are negations of cubes, that cover false combinations.
+TExpressionPtr BuildCnfExpression(const TCubeVector& cubes, const VariableDeclaration& variable);
+// Sum modulo 2 of monomials, which are cubes without negated variables.
+// The empty cube is the constant 1.
+TExpressionPtr BuildZhegalkinExpression(const TCubeVector& monomials, const VariableDeclaration& variable);
+
+} // namespace dm
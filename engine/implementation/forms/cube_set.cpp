@@ -0,0 +1,188 @@
+#include "cube_set.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace dm
+{
+
+CubeSet::CubeSet(size_t max_cube_count) :
+   m_max_cube_count(max_cube_count), m_cubes(), m_cube_indexes(), m_nodes(1, TrieNode{ {}, 0, false, Cube{ 0, 0 } })
+{
+}
+
+bool CubeSet::Add(const Cube& cube)
+{
+   TLiteral literals[g_bit_block_size];
+   const auto literal_count = GetLiterals(cube, literals);
+   if (Contains(cube) || HasSubset(0, literals, literal_count))
+   {
+      return false;
+   }
+
+   RemoveSupersets(0, literals, literal_count);
+   Insert(cube, literals, literal_count);
+   return true;
+}
+
+bool CubeSet::Contains(const Cube& cube) const
+{
+   return m_cube_indexes.count(cube) != 0;
+}
+
+bool CubeSet::IsCovered(const Cube& cube) const
+{
+   TLiteral literals[g_bit_block_size];
+   const auto literal_count = GetLiterals(cube, literals);
+   return Contains(cube) || HasSubset(0, literals, literal_count);
+}
+
+size_t CubeSet::GetSize() const
+{
+   return m_cubes.size();
+}
+
+bool CubeSet::IsOverflowed() const
+{
+   return m_cubes.size() > m_max_cube_count;
+}
+
+void CubeSet::MoveCubes(TCubeVector& cubes)
+{
+   cubes = std::move(m_cubes);
+   m_cubes.clear();
+   m_cube_indexes.clear();
+   m_nodes.resize(1);
+   m_nodes[0].children.clear();
+   m_nodes[0].cube_count = 0;
+}
+
+long CubeSet::GetLiterals(const Cube& cube, TLiteral literals[])
+{
+   // Negative literal of a variable goes just before the positive one.
+   auto literal_count = 0L;
+   for (auto mask = cube.mask; mask != 0; mask &= mask - 1)
+   {
+      const auto var = FindFirstSetBit(mask);
+      literals[literal_count++] = static_cast<TLiteral>(2 * var + ((cube.values >> var) & 1));
+   }
+   return literal_count;
+}
+
+bool CubeSet::HasSubset(size_t node_index, const TLiteral literals[], long literal_count) const
+{
+   const auto& node = m_nodes[node_index];
+   if (node.is_terminal)
+   {
+      return true;
+   }
+
+   // Both children and literals are sorted, so they are walked together.
+   auto child = node.children.begin();
+   for (auto index = 0L; index < literal_count && child != node.children.end(); ++index)
+   {
+      child = std::lower_bound(child, node.children.end(), literals[index], [](const TChild& child, TLiteral literal)
+      {
+         return child.first < literal;
+      });
+      if (child != node.children.end() && child->first == literals[index])
+      {
+         if (0 != m_nodes[child->second].cube_count &&
+             HasSubset(child->second, literals + index + 1, literal_count - index - 1))
+         {
+            return true;
+         }
+         ++child;
+      }
+   }
+   return false;
+}
+
+size_t CubeSet::RemoveSupersets(size_t node_index, const TLiteral literals[], long literal_count)
+{
+   auto removed_count = size_t(0);
+   if (0 == literal_count && m_nodes[node_index].is_terminal)
+   {
+      m_nodes[node_index].is_terminal = false;
+      Erase(m_nodes[node_index].cube);
+      ++removed_count;
+   }
+
+   // Supersets can have any literals before the next literal of the cube,
+   // except the opposite one, while the rest of the cube is matched.
+   for (auto child_index = size_t(0); child_index < m_nodes[node_index].children.size(); ++child_index)
+   {
+      const auto child = m_nodes[node_index].children[child_index];
+      if (0 != literal_count && child.first > literals[0])
+      {
+         break;
+      }
+      if (0 == m_nodes[child.second].cube_count)
+      {
+         continue;
+      }
+
+      if (0 != literal_count && child.first == literals[0])
+      {
+         removed_count += RemoveSupersets(child.second, literals + 1, literal_count - 1);
+      }
+      else if (0 == literal_count || (child.first >> 1) != (literals[0] >> 1))
+      {
+         removed_count += RemoveSupersets(child.second, literals, literal_count);
+      }
+   }
+
+   m_nodes[node_index].cube_count -= removed_count;
+   return removed_count;
+}
+
+void CubeSet::Insert(const Cube& cube, const TLiteral literals[], long literal_count)
+{
+   auto node_index = size_t(0);
+   ++m_nodes[node_index].cube_count;
+   for (auto index = 0L; index < literal_count; ++index)
+   {
+      auto& children = m_nodes[node_index].children;
+      auto child = std::lower_bound(children.begin(), children.end(), literals[index], [](const TChild& child, TLiteral literal)
+      {
+         return child.first < literal;
+      });
+      if (child != children.end() && child->first == literals[index])
+      {
+         node_index = child->second;
+         ++m_nodes[node_index].cube_count;
+         continue;
+      }
+
+      const auto new_node_index = m_nodes.size();
+      children.insert(child, TChild(literals[index], new_node_index));
+      m_nodes.push_back(TrieNode{ {}, 1, false, Cube{ 0, 0 } });
+      node_index = new_node_index;
+   }
+
+   auto& node = m_nodes[node_index];
+   assert(!node.is_terminal);
+   node.is_terminal = true;
+   node.cube = cube;
+
+   m_cube_indexes.emplace(cube, m_cubes.size());
+   m_cubes.push_back(cube);
+}
+
+void CubeSet::Erase(const Cube& cube)
+{
+   const auto position = m_cube_indexes.find(cube);
+   assert(position != m_cube_indexes.end());
+
+   // The last cube takes place of the erased one.
+   const auto index = position->second;
+   m_cube_indexes.erase(position);
+   if (index + 1 != m_cubes.size())
+   {
+      m_cubes[index] = m_cubes.back();
+      m_cube_indexes[m_cubes[index]] = index;
+   }
+   m_cubes.pop_back();
+}
+
+} // namespace dm
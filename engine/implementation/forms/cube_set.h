@@ -0,0 +1,84 @@
+#pragma once
+
+#include "cube.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace dm
+{
+
+struct CubeHash
+{
+   size_t operator()(const Cube& cube) const
+   {
+      return std::hash<TBitBlock>()(cube.mask * 0x9E3779B97F4A7C15ull ^ cube.values);
+   }
+};
+
+// Set of cubes, none of which contains another one. Besides the hash table cubes are kept
+// in a trie by their literals in ascending order, so cubes, that contain the given one
+// or are contained by it, are searched only among cubes with suitable prefixes.
+class CubeSet
+{
+public:
+   explicit CubeSet(size_t max_cube_count);
+
+   // Adds the cube, if it isn't covered by the set, and removes cubes, which it contains.
+   // Returns false if the cube isn't added.
+   bool Add(const Cube& cube);
+
+   bool Contains(const Cube& cube) const;
+   // Returns true if the cube is in the set or is contained by a cube of the set.
+   bool IsCovered(const Cube& cube) const;
+
+   size_t GetSize() const;
+   // Returns true if the set has more cubes, than the limit, given to the constructor.
+   bool IsOverflowed() const;
+
+   // Calls processor(cube) for all cubes of the set.
+   template <typename TProcessor>
+   void ForEachCube(TProcessor processor) const;
+
+   // Moves cubes to the vector, leaving the set empty.
+   void MoveCubes(TCubeVector& cubes);
+
+private:
+   using TLiteral = unsigned char;
+   using TChild = std::pair<TLiteral, size_t>;
+
+   struct TrieNode
+   {
+      // Children are sorted by literals.
+      std::vector<TChild> children;
+      // Amount of cubes in the subtree, so subtrees of removed cubes are skipped.
+      size_t cube_count;
+      bool is_terminal;
+      Cube cube;
+   };
+
+   static long GetLiterals(const Cube& cube, TLiteral literals[]);
+
+   bool HasSubset(size_t node_index, const TLiteral literals[], long literal_count) const;
+   // Returns the amount of removed cubes.
+   size_t RemoveSupersets(size_t node_index, const TLiteral literals[], long literal_count);
+   void Insert(const Cube& cube, const TLiteral literals[], long literal_count);
+   void Erase(const Cube& cube);
+
+private:
+   size_t m_max_cube_count;
+   TCubeVector m_cubes;
+   std::unordered_map<Cube, size_t, CubeHash> m_cube_indexes;
+   std::vector<TrieNode> m_nodes;
+};
+
+template <typename TProcessor>
+void CubeSet::ForEachCube(TProcessor processor) const
+{
+   for (const auto& cube : m_cubes)
+   {
+      processor(cube);
+   }
+}
+
+} // namespace dm
@@ -0,0 +1,294 @@
+#include "expansion.h"
+#include "cube_set.h"
+#include "../expressions/expression_utils.h"
+#include "../expressions/expressions.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+using TCubeVectorPtrVector = std::vector<const TCubeVector*>;
+
+class Expander
+{
+public:
+   Expander(long param_count, size_t max_term_count);
+
+   // Builds cubes of the expression or of its negation.
+   bool Expand(const TExpressionPtr& expr, bool is_positive, TCubeVector& cubes);
+
+private:
+   bool ExpandChildren(const OperationExpression& expression, bool is_positive, bool is_product, TCubeVector& cubes);
+   // Implication, equality and plus are applied to children from left to right, so cubes
+   // of both the prefix and its negation are built.
+   bool ExpandFolded(const OperationExpression& expression, bool is_positive, TCubeVector& cubes);
+
+   bool Unite(const TCubeVectorPtrVector& terms, TCubeVector& cubes);
+   bool Multiply(TCubeVectorPtrVector factors, TCubeVector& cubes);
+
+   // Returns false if the budget of terms is exceeded.
+   bool CountTerm();
+
+private:
+   long m_param_count;
+   size_t m_max_term_count;
+   size_t m_term_count;
+};
+
+Expander::Expander(long param_count, size_t max_term_count) :
+   m_param_count(param_count), m_max_term_count(max_term_count), m_term_count(0)
+{
+}
+
+bool Expander::Expand(const TExpressionPtr& expr, bool is_positive, TCubeVector& cubes)
+{
+   cubes.clear();
+   switch (expr->GetType())
+   {
+   case ExpressionType::Literal:
+      if ((LiteralType::True == GetLiteral(expr)) == is_positive)
+      {
+         cubes.push_back(Cube{ 0, 0 });
+      }
+      return true;
+
+   case ExpressionType::ParamRef:
+   {
+      const auto bit = TBitBlock(1) << (m_param_count - 1 - GetParamIndex(expr));
+      cubes.push_back(Cube{ bit, is_positive ? bit : 0 });
+      return true;
+   }
+
+   case ExpressionType::Operation:
+   {
+      const auto& expression = CastToOperation(expr);
+      switch (expression.GetOperation())
+      {
+      case OperationType::Negation:
+         return Expand(expression.GetChild(0), !is_positive, cubes);
+      case OperationType::Conjunction:
+         return ExpandChildren(expression, is_positive, is_positive, cubes);
+      case OperationType::Disjunction:
+         return ExpandChildren(expression, is_positive, !is_positive, cubes);
+      default:
+         return ExpandFolded(expression, is_positive, cubes);
+      }
+   }
+
+   default:
+      assert(false);
+      return false;
+   }
+}
+
+bool Expander::ExpandChildren(const OperationExpression& expression, bool is_positive, bool is_product,
+                              TCubeVector& cubes)
+{
+   std::vector<TCubeVector> child_cubes(expression.GetChildCount());
+   TCubeVectorPtrVector child_cube_ptrs;
+   for (auto index = 0L; index < expression.GetChildCount(); ++index)
+   {
+      if (!Expand(expression.GetChild(index), is_positive, child_cubes[index]))
+      {
+         return false;
+      }
+      child_cube_ptrs.push_back(&child_cubes[index]);
+   }
+   return is_product ? Multiply(child_cube_ptrs, cubes) : Unite(child_cube_ptrs, cubes);
+}
+
+bool Expander::ExpandFolded(const OperationExpression& expression, bool is_positive, TCubeVector& cubes)
+{
+   const auto operation = expression.GetOperation();
+   assert(OperationType::Implication == operation ||
+          OperationType::Equality == operation ||
+          OperationType::Plus == operation);
+
+   TCubeVector positive;
+   TCubeVector negative;
+   if (!Expand(expression.GetChild(0), true, positive) ||
+       !Expand(expression.GetChild(0), false, negative))
+   {
+      return false;
+   }
+
+   TCubeVector child_positive;
+   TCubeVector child_negative;
+   TCubeVector left;
+   TCubeVector right;
+   for (auto index = 1L; index < expression.GetChildCount(); ++index)
+   {
+      if (!Expand(expression.GetChild(index), true, child_positive) ||
+          !Expand(expression.GetChild(index), false, child_negative))
+      {
+         return false;
+      }
+
+      // Only the required sign is built for the whole expression.
+      const auto is_last = (index + 1 == expression.GetChildCount());
+      TCubeVector new_positive;
+      TCubeVector new_negative;
+      if (OperationType::Implication == operation)
+      {
+         if ((!is_last || is_positive) && !Unite({ &negative, &child_positive }, new_positive))
+         {
+            return false;
+         }
+         if ((!is_last || !is_positive) && !Multiply({ &positive, &child_negative }, new_negative))
+         {
+            return false;
+         }
+      }
+      else
+      {
+         // Equal prefix and child make the equality true and the plus false.
+         const auto is_equality = (OperationType::Equality == operation);
+         if (!is_last || is_positive == is_equality)
+         {
+            auto& result = is_equality ? new_positive : new_negative;
+            if (!Multiply({ &positive, &child_positive }, left) ||
+                !Multiply({ &negative, &child_negative }, right) ||
+                !Unite({ &left, &right }, result))
+            {
+               return false;
+            }
+         }
+         if (!is_last || is_positive != is_equality)
+         {
+            auto& result = is_equality ? new_negative : new_positive;
+            if (!Multiply({ &positive, &child_negative }, left) ||
+                !Multiply({ &negative, &child_positive }, right) ||
+                !Unite({ &left, &right }, result))
+            {
+               return false;
+            }
+         }
+      }
+
+      positive.swap(new_positive);
+      negative.swap(new_negative);
+   }
+
+   cubes.swap(is_positive ? positive : negative);
+   return true;
+}
+
+bool Expander::Unite(const TCubeVectorPtrVector& terms, TCubeVector& cubes)
+{
+   CubeSet cube_set(m_max_term_count);
+   for (auto term_cubes : terms)
+   {
+      for (const auto& cube : *term_cubes)
+      {
+         if (!CountTerm())
+         {
+            return false;
+         }
+         cube_set.Add(cube);
+      }
+   }
+   cube_set.MoveCubes(cubes);
+   return true;
+}
+
+bool Expander::Multiply(TCubeVectorPtrVector factors, TCubeVector& cubes)
+{
+   // Factors with a single cube are multiplied at once, the rest go from the smallest ones,
+   // so more terms are cut off at the beginning.
+   auto initial = Cube{ 0, 0 };
+   auto last = size_t(0);
+   for (auto factor : factors)
+   {
+      if (factor->empty() || (1 == factor->size() && !DoCubesIntersect(initial, (*factor)[0])))
+      {
+         cubes.clear();
+         return true;
+      }
+      if (1 == factor->size())
+      {
+         initial.mask |= (*factor)[0].mask;
+         initial.values |= (*factor)[0].values;
+      }
+      else
+      {
+         factors[last++] = factor;
+      }
+   }
+   factors.resize(last);
+   std::stable_sort(factors.begin(), factors.end(), [](const TCubeVector* left, const TCubeVector* right)
+   {
+      return left->size() < right->size();
+   });
+
+   if (factors.empty())
+   {
+      cubes.assign(1, initial);
+      return true;
+   }
+
+   // Terms are enumerated in depth-first order, prefixes[level] is the product of cubes,
+   // chosen in factors before the level.
+   CubeSet product(m_max_term_count);
+   const auto level_count = static_cast<long>(factors.size());
+   std::vector<Cube> prefixes(level_count, initial);
+   std::vector<size_t> choices(level_count, 0);
+   for (auto level = 0L; level >= 0; )
+   {
+      auto& choice = choices[level];
+      if (choice == factors[level]->size())
+      {
+         if (--level >= 0)
+         {
+            ++choices[level];
+         }
+         continue;
+      }
+
+      const auto& prefix = prefixes[level];
+      const auto& cube = (*factors[level])[choice];
+      if (DoCubesIntersect(prefix, cube))
+      {
+         const Cube term{ prefix.mask | cube.mask, prefix.values | cube.values };
+
+         // Extensions of a covered term are covered too.
+         if (!product.IsCovered(term))
+         {
+            if (!CountTerm())
+            {
+               return false;
+            }
+            if (level + 1 < level_count)
+            {
+               prefixes[++level] = term;
+               choices[level] = 0;
+               continue;
+            }
+            product.Add(term);
+         }
+      }
+      ++choice;
+   }
+
+   product.MoveCubes(cubes);
+   return true;
+}
+
+bool Expander::CountTerm()
+{
+   return ++m_term_count <= m_max_term_count;
+}
+
+} // namespace
+
+bool ExpandToCubes(const TExpressionPtr& expr, long param_count, size_t max_term_count, TCubeVector& cubes)
+{
+   assert(param_count <= g_bit_block_size);
+   return Expander(param_count, max_term_count).Expand(expr, true, cubes);
+}
+
+} // namespace dm
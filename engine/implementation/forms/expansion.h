@@ -0,0 +1,15 @@
+#pragma once
+
+#include "cube.h"
+
+namespace dm
+{
+
+// Opens brackets of the expression by distributive and De Morgan's laws, building cubes of
+// its disjunctive form. Products of disjunctions are generated term by term, and a term,
+// which is covered by already generated ones, is skipped with all its extensions.
+// Returns false, as soon as more than max_term_count terms (including partial products
+// and terms of all intermediate forms) are generated. Expression must not contain applications.
+bool ExpandToCubes(const TExpressionPtr& expr, long param_count, size_t max_term_count, TCubeVector& cubes);
+
+} // namespace dm
@@ -0,0 +1,157 @@
+#include "normal_forms.h"
+#include "../common/combinations.h"
+#include "../common/parallel_utils.h"
+#include "../variables/variable_calculator.h"
+
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+// Amount of blocks, that are calculated by a worker thread at once.
+const long long g_chunk_size = 64;
+
+} // namespace
+
+TCubeVector BuildMintermCubes(const Variable& variable, bool value)
+{
+   const auto param_count = variable.GetParameterCount();
+   assert(param_count < g_bit_block_size);
+
+   // Variable must be prepared before parallel calculation.
+   variable.PrepareCalculation();
+
+   BitCombinationGenerator generator(param_count);
+   const auto block_mask = generator.GetBlockMask();
+   const auto block_count = generator.GetBlockCount();
+
+   // Each chunk collects its own cubes, they are joined in order of chunks.
+   std::vector<TCubeVector> chunk_cubes((block_count + g_chunk_size - 1) / g_chunk_size);
+
+   ProcessInParallel(block_count, g_chunk_size, [&](long long from, long long to)
+   {
+      BitCombinationGenerator range_generator(param_count, true);
+      range_generator.SetBlockRange(from, to);
+
+      VariableCalculator calculator(variable);
+
+      // Blocks are calculated in Gray code order and scanned in ascending one.
+      TBitBlock blocks[g_chunk_size];
+      for (auto param_values = range_generator.GenerateFirst();
+           param_values != nullptr;
+           param_values = range_generator.GenerateNext())
+      {
+         const auto result = calculator.Calculate(param_values, range_generator.GetChangedIndex());
+         blocks[range_generator.GetBlockIndex() - from] = (value ? result : ~result) & block_mask;
+      }
+
+      auto& cubes = chunk_cubes[from / g_chunk_size];
+      for (auto block_index = from; block_index < to; ++block_index)
+      {
+         for (auto bits = blocks[block_index - from]; bits != g_bit_block_false; bits &= bits - 1)
+         {
+            cubes.push_back(MakeMintermCube(param_count, block_index * g_bit_block_size + FindFirstSetBit(bits)));
+         }
+      }
+
+      return true;
+   });
+
+   TCubeVector cubes;
+   auto cube_count = size_t(0);
+   for (const auto& part : chunk_cubes)
+   {
+      cube_count += part.size();
+   }
+   cubes.reserve(cube_count);
+   for (const auto& part : chunk_cubes)
+   {
+      cubes.insert(cubes.end(), part.begin(), part.end());
+   }
+   return cubes;
+}
+
+void GlueMintermCubes(TCubeVector& cubes, long param_count)
+{
+   // Before the sweep of variable v all variables starting from v are in each cube,
+   // so cubes with the same higher bits form a contiguous group in the ascending order.
+   // The group, where variable v is positive, directly follows its pair. Cubes inside
+   // a group don't intersect, so their first combinations differ, and pairs of groups
+   // are glued by a single merging walk.
+   std::vector<bool> is_glued;
+   for (auto var = 0L; var < param_count; ++var)
+   {
+      const auto var_mask = TBitBlock(1) << var;
+      is_glued.assign(cubes.size(), false);
+
+      auto glued_count = size_t(0);
+      auto group_begin = size_t(0);
+      while (group_begin < cubes.size())
+      {
+         const auto group_key = cubes[group_begin].values >> var;
+         auto group_end = group_begin + 1;
+         while (group_end < cubes.size() && (cubes[group_end].values >> var) == group_key)
+         {
+            ++group_end;
+         }
+
+         if (0 != (group_key & 1))
+         {
+            group_begin = group_end;
+            continue;
+         }
+
+         auto pair_end = group_end;
+         while (pair_end < cubes.size() && (cubes[pair_end].values >> var) == (group_key | 1))
+         {
+            ++pair_end;
+         }
+
+         for (auto index = group_begin, pair_index = group_end; index < group_end && pair_index < pair_end; )
+         {
+            auto& cube = cubes[index];
+            const auto& pair_cube = cubes[pair_index];
+            const auto pair_values = pair_cube.values & ~var_mask;
+            if (cube.values < pair_values)
+            {
+               ++index;
+            }
+            else if (cube.values > pair_values)
+            {
+               ++pair_index;
+            }
+            else
+            {
+               if (cube.mask == pair_cube.mask)
+               {
+                  cube.mask &= ~var_mask;
+                  is_glued[pair_index] = true;
+                  ++glued_count;
+               }
+               ++index;
+               ++pair_index;
+            }
+         }
+
+         group_begin = pair_end;
+      }
+
+      if (glued_count != 0)
+      {
+         auto last = size_t(0);
+         for (auto index = size_t(0); index < cubes.size(); ++index)
+         {
+            if (!is_glued[index])
+            {
+               cubes[last++] = cubes[index];
+            }
+         }
+         cubes.resize(last);
+      }
+   }
+}
+
+} // namespace dm
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "cube.h"
+
+namespace dm
+{
+
+class Variable;
+
+// Normal forms are built for variables with no more parameters than this.
+const long g_max_normal_form_parameter_count = 24;
+
+// Minterm cubes of combinations, on which the variable has the given value, in ascending
+// order of combinations. Values are streamed from the enumerator chunk by chunk in parallel,
+// so the truth table isn't built.
+TCubeVector BuildMintermCubes(const Variable& variable, bool value);
+
+// Glues minterm cubes, which differ by the sign of a single variable, sweeping variables
+// from the last parameter to the first one. Cubes of the result don't intersect, and stay
+// in ascending order of their first combinations.
+void GlueMintermCubes(TCubeVector& cubes, long param_count);
+
+} // namespace dm
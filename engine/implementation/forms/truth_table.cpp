@@ -0,0 +1,197 @@
+#include "truth_table.h"
+#include "../common/parallel_utils.h"
+#include "../variables/variable_calculator.h"
+
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+// Amount of blocks, that are calculated by a worker thread at once.
+const long long g_chunk_size = 64;
+
+} // namespace
+
+TruthTable::TruthTable(long param_count) :
+   m_param_count(param_count), m_blocks()
+{
+   assert(param_count >= 0 && param_count <= g_max_truth_table_parameter_count);
+   m_blocks.resize(BitCombinationGenerator(param_count).GetBlockCount(), g_bit_block_false);
+}
+
+TruthTable TruthTable::Build(const Variable& variable)
+{
+   const auto param_count = variable.GetParameterCount();
+   TruthTable table(param_count);
+
+   // Variable must be prepared before parallel calculation.
+   variable.PrepareCalculation();
+
+   const auto block_mask = table.GetValidBlockMask();
+   ProcessInParallel(table.GetBlockCount(), g_chunk_size, [&](long long from, long long to)
+   {
+      BitCombinationGenerator generator(param_count, true);
+      generator.SetBlockRange(from, to);
+
+      VariableCalculator calculator(variable);
+
+      for (auto param_values = generator.GenerateFirst();
+           param_values != nullptr;
+           param_values = generator.GenerateNext())
+      {
+         table.m_blocks[generator.GetBlockIndex()] =
+            calculator.Calculate(param_values, generator.GetChangedIndex()) & block_mask;
+      }
+
+      return true;
+   });
+
+   return table;
+}
+
+long TruthTable::GetParameterCount() const
+{
+   return m_param_count;
+}
+
+long long TruthTable::GetCombinationCount() const
+{
+   return 1LL << m_param_count;
+}
+
+long long TruthTable::GetBlockCount() const
+{
+   return m_blocks.size();
+}
+
+TBitBlock TruthTable::GetBlock(long long index) const
+{
+   return m_blocks[index];
+}
+
+void TruthTable::SetBlock(long long index, TBitBlock block)
+{
+   m_blocks[index] = block & GetValidBlockMask();
+}
+
+bool TruthTable::GetValue(long long combination) const
+{
+   return 0 != (m_blocks[combination / g_bit_block_size] & (TBitBlock(1) << (combination % g_bit_block_size)));
+}
+
+void TruthTable::SetValue(long long combination, bool value)
+{
+   const auto bit_mask = TBitBlock(1) << (combination % g_bit_block_size);
+   auto& block = m_blocks[combination / g_bit_block_size];
+   block = value ? (block | bit_mask) : (block & ~bit_mask);
+}
+
+void TruthTable::Invert()
+{
+   const auto block_mask = GetValidBlockMask();
+   for (auto& block : m_blocks)
+   {
+      block = ~block & block_mask;
+   }
+}
+
+void TruthTable::Unite(const TruthTable& rhs)
+{
+   assert(m_param_count == rhs.m_param_count);
+   for (auto index = 0LL; index < GetBlockCount(); ++index)
+   {
+      m_blocks[index] |= rhs.m_blocks[index];
+   }
+}
+
+void TruthTable::Subtract(const TruthTable& rhs)
+{
+   assert(m_param_count == rhs.m_param_count);
+   for (auto index = 0LL; index < GetBlockCount(); ++index)
+   {
+      m_blocks[index] &= ~rhs.m_blocks[index];
+   }
+}
+
+void TruthTable::ApplyMobiusTransform()
+{
+   // Low bits of combinations are inside blocks, so halves of a block are summed by shifts.
+   for (auto bit = 0L; bit < g_bit_block_dimension && bit < m_param_count; ++bit)
+   {
+      const auto low_half = ~GetBitBlockPattern(bit);
+      for (auto& block : m_blocks)
+      {
+         block ^= (block & low_half) << (1 << bit);
+      }
+   }
+
+   // High bits of combinations are bits of block indexes.
+   for (auto step = 1LL; step < GetBlockCount(); step <<= 1)
+   {
+      for (auto index = 0LL; index < GetBlockCount(); ++index)
+      {
+         if (index & step)
+         {
+            m_blocks[index] ^= m_blocks[index ^ step];
+         }
+      }
+   }
+}
+
+bool TruthTable::IsEmpty() const
+{
+   for (auto block : m_blocks)
+   {
+      if (block != g_bit_block_false)
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+long long TruthTable::CountTrueValues() const
+{
+   auto count = 0LL;
+   for (auto block : m_blocks)
+   {
+      count += CountSetBits(block);
+   }
+   return count;
+}
+
+bool TruthTable::IsCubeTrue(const Cube& cube) const
+{
+   return ForEachCubeBlock(cube, [this](long long block_index, TBitBlock pattern)
+   {
+      return 0 == (~m_blocks[block_index] & pattern);
+   });
+}
+
+bool TruthTable::IsCubeFalse(const Cube& cube) const
+{
+   return ForEachCubeBlock(cube, [this](long long block_index, TBitBlock pattern)
+   {
+      return 0 == (m_blocks[block_index] & pattern);
+   });
+}
+
+void TruthTable::SetCube(const Cube& cube, bool value)
+{
+   ForEachCubeBlock(cube, [this, value](long long block_index, TBitBlock pattern)
+   {
+      auto& block = m_blocks[block_index];
+      block = value ? (block | pattern) : (block & ~pattern);
+      return true;
+   });
+}
+
+TBitBlock TruthTable::GetValidBlockMask() const
+{
+   return BitCombinationGenerator(m_param_count).GetBlockMask();
+}
+
+} // namespace dm
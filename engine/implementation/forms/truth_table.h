@@ -0,0 +1,125 @@
+#pragma once
+
+#include "cube.h"
+#include "../common/literals.h"
+#include "../common/combinations.h"
+
+#include <vector>
+
+namespace dm
+{
+
+class Variable;
+
+// Truth tables are built for variables with no more parameters than this.
+const long g_max_truth_table_parameter_count = 24;
+
+// Values of a function, packed into bit blocks in the same order, as BitCombinationGenerator
+// generates combinations: bit j of block i holds the value on combination number
+// (i * g_bit_block_size + j), in which 0-th parameter is the highest bit.
+// Bits of the block over the amount of combinations are always zero.
+class TruthTable
+{
+public:
+   // All values are false.
+   TruthTable(long param_count);
+
+   // Calculates the variable on all combinations of parameters in parallel.
+   static TruthTable Build(const Variable& variable);
+
+   long GetParameterCount() const;
+   long long GetCombinationCount() const;
+   long long GetBlockCount() const;
+
+   TBitBlock GetBlock(long long index) const;
+   void SetBlock(long long index, TBitBlock block);
+
+   bool GetValue(long long combination) const;
+   void SetValue(long long combination, bool value);
+
+   // Bitwise operations with the table of the same size.
+   void Invert();
+   void Unite(const TruthTable& rhs);
+   void Subtract(const TruthTable& rhs);
+
+   // Replaces values by coefficients of the Zhegalkin polynomial (and vice versa, as
+   // the transform is an involution): value on combination m becomes the sum modulo 2
+   // of values on all combinations, which are submasks of m.
+   void ApplyMobiusTransform();
+
+   bool IsEmpty() const;
+   long long CountTrueValues() const;
+
+   // Cube operations visit only blocks, that intersect the cube.
+   // Returns true if the table is true on all combinations of the cube.
+   bool IsCubeTrue(const Cube& cube) const;
+   // Returns true if the table is false on all combinations of the cube.
+   bool IsCubeFalse(const Cube& cube) const;
+   void SetCube(const Cube& cube, bool value);
+
+   // Calls processor(combination) for true combinations of the cube in ascending order.
+   template <typename TProcessor>
+   void ForEachTrueCombination(const Cube& cube, TProcessor processor) const;
+
+private:
+   // Calls processor(block_index, pattern) for blocks, that intersect the cube,
+   // where pattern marks combinations of the cube inside the block.
+   // Processing is stopped, if processor returns false.
+   template <typename TProcessor>
+   bool ForEachCubeBlock(const Cube& cube, TProcessor processor) const;
+
+   TBitBlock GetValidBlockMask() const;
+
+private:
+   long m_param_count;
+   std::vector<TBitBlock> m_blocks;
+};
+
+template <typename TProcessor>
+void TruthTable::ForEachTrueCombination(const Cube& cube, TProcessor processor) const
+{
+   ForEachCubeBlock(cube, [this, &processor](long long block_index, TBitBlock pattern)
+   {
+      for (auto bits = m_blocks[block_index] & pattern; bits != g_bit_block_false; bits &= bits - 1)
+      {
+         processor(block_index * g_bit_block_size + FindFirstSetBit(bits));
+      }
+      return true;
+   });
+}
+
+template <typename TProcessor>
+bool TruthTable::ForEachCubeBlock(const Cube& cube, TProcessor processor) const
+{
+   auto pattern = GetValidBlockMask();
+   for (auto bit = 0L; bit < g_bit_block_dimension && bit < m_param_count; ++bit)
+   {
+      const auto bit_mask = TBitBlock(1) << bit;
+      if (cube.mask & bit_mask)
+      {
+         pattern &= (cube.values & bit_mask) ? GetBitBlockPattern(bit) : ~GetBitBlockPattern(bit);
+      }
+   }
+
+   // Blocks of the cube are enumerated as subsets of its free high variables.
+   const auto block_bit_count = (m_param_count > g_bit_block_dimension) ?
+      (m_param_count - g_bit_block_dimension) : 0;
+   const auto block_bits = (TBitBlock(1) << block_bit_count) - 1;
+   const auto free_bits = ~(cube.mask >> g_bit_block_dimension) & block_bits;
+   const auto fixed_bits = (cube.values >> g_bit_block_dimension) & block_bits;
+
+   auto subset = TBitBlock(0);
+   do
+   {
+      if (!processor(static_cast<long long>(fixed_bits | subset), pattern))
+      {
+         return false;
+      }
+      subset = (subset - free_bits) & free_bits;
+   }
+   while (subset != 0);
+
+   return true;
+}
+
+} // namespace dm
@@ -0,0 +1,1157 @@
+#include "two_level_minimizer.h"
+#include "../common/noncopyable.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <unordered_set>
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+// Maximal amount of reduce/expand iterations of the Espresso loop.
+const long g_max_espresso_iteration_count = 16;
+
+// Expanding cubes towards other cubes of the cover requires comparison with all of them,
+// so larger covers are expanded in the fixed order of variables.
+const std::size_t g_max_directed_expansion_cover_size = 4096;
+
+struct CubeHash
+{
+   std::size_t operator()(const Cube& cube) const
+   {
+      return std::hash<TBitBlock>()((cube.mask * 0x9E3779B97F4A7C15ull) ^ cube.values);
+   }
+};
+
+using TCubeSet = std::unordered_set<Cube, CubeHash>;
+
+bool IsCubeLess(const Cube& left, const Cube& right)
+{
+   return left.mask < right.mask || (left.mask == right.mask && left.values < right.values);
+}
+
+bool DoesCubeContainCombination(const Cube& cube, long long combination)
+{
+   return 0 == ((static_cast<TBitBlock>(combination) ^ cube.values) & cube.mask);
+}
+
+long GetLiteralCount(const Cube& cube)
+{
+   return CountSetBits(cube.mask);
+}
+
+// Covers are compared by amount of cubes, and then by amount of literals.
+struct CoverCost
+{
+   long cube_count;
+   long literal_count;
+
+   bool operator<(const CoverCost& rhs) const
+   {
+      return cube_count < rhs.cube_count ||
+         (cube_count == rhs.cube_count && literal_count < rhs.literal_count);
+   }
+};
+
+CoverCost GetCoverCost(const TCubeVector& cover)
+{
+   CoverCost cost = { static_cast<long>(cover.size()), 0 };
+   for (const auto& cube : cover)
+   {
+      cost.literal_count += GetLiteralCount(cube);
+   }
+   return cost;
+}
+
+// Quine-McCluskey method: implicants, that differ by a single variable, are glued
+// level by level, and implicants, that are not glued, are prime.
+TCubeVector GeneratePrimeCubes(const TruthTable& care_set, const TruthTable& on_set)
+{
+   const auto param_count = care_set.GetParameterCount();
+
+   TCubeVector level;
+   care_set.ForEachTrueCombination(Cube{ 0, 0 }, [&level, param_count](long long combination)
+   {
+      level.push_back(MakeMintermCube(param_count, combination));
+   });
+
+   TCubeVector primes;
+   while (!level.empty())
+   {
+      const TCubeSet level_set(level.begin(), level.end());
+      TCubeSet next_level_set;
+
+      for (const auto& cube : level)
+      {
+         auto is_glued = false;
+         for (auto bits = cube.mask; bits != 0; bits &= bits - 1)
+         {
+            const auto bit_mask = bits & ~(bits - 1);
+            if (level_set.count(Cube{ cube.mask, cube.values ^ bit_mask }) > 0)
+            {
+               is_glued = true;
+               next_level_set.insert(Cube{ cube.mask & ~bit_mask, cube.values & ~bit_mask });
+            }
+         }
+
+         // Prime cubes, that cover only don't care combinations, are useless.
+         if (!is_glued && !on_set.IsCubeFalse(cube))
+         {
+            primes.push_back(cube);
+         }
+      }
+
+      // Order of the set isn't defined, so the level is sorted to keep results stable.
+      level.assign(next_level_set.begin(), next_level_set.end());
+      std::sort(level.begin(), level.end(), IsCubeLess);
+   }
+
+   return primes;
+}
+
+// Set of rows or prime cubes of the covering table.
+using TBitVector = std::vector<TBitBlock>;
+
+TBitVector MakeBitVector(long size)
+{
+   return TBitVector((size + g_bit_block_size - 1) / g_bit_block_size, 0);
+}
+
+bool TestBit(const TBitVector& bits, long index)
+{
+   return 0 != (bits[index / g_bit_block_size] & (TBitBlock(1) << (index % g_bit_block_size)));
+}
+
+void SetBit(TBitVector& bits, long index)
+{
+   bits[index / g_bit_block_size] |= TBitBlock(1) << (index % g_bit_block_size);
+}
+
+void ResetBit(TBitVector& bits, long index)
+{
+   bits[index / g_bit_block_size] &= ~(TBitBlock(1) << (index % g_bit_block_size));
+}
+
+// Returns -1, if there are no set bits.
+long FindFirstBit(const TBitVector& bits)
+{
+   for (std::size_t index = 0; index < bits.size(); ++index)
+   {
+      if (bits[index] != 0)
+      {
+         return static_cast<long>(index * g_bit_block_size) + FindFirstSetBit(bits[index]);
+      }
+   }
+   return -1;
+}
+
+bool IsEmpty(const TBitVector& bits)
+{
+   return FindFirstBit(bits) < 0;
+}
+
+long CountCommonBits(const TBitVector& left, const TBitVector& right)
+{
+   auto count = 0L;
+   for (std::size_t index = 0; index < left.size(); ++index)
+   {
+      count += CountSetBits(left[index] & right[index]);
+   }
+   return count;
+}
+
+// Returns true, if all bits of subset, that are set in the filter, are set in the set too.
+bool IsSubset(const TBitVector& subset, const TBitVector& set, const TBitVector& filter)
+{
+   for (std::size_t index = 0; index < subset.size(); ++index)
+   {
+      if (0 != (subset[index] & filter[index] & ~set[index]))
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+template <typename TFunction>
+void ForEachCommonBit(const TBitVector& left, const TBitVector& right, TFunction func)
+{
+   for (std::size_t index = 0; index < left.size(); ++index)
+   {
+      for (auto bits = left[index] & right[index]; bits != 0; bits &= bits - 1)
+      {
+         func(static_cast<long>(index * g_bit_block_size) + FindFirstSetBit(bits));
+      }
+   }
+}
+
+// Exact solver of the covering problem by branch and bound. The amount of prime cubes
+// of the cover is minimized first, and then the amount of literals is minimized among
+// covers with the minimal amount of prime cubes. The table is reduced before each
+// branching by essential prime cubes, row dominance and column dominance, and branches
+// are bounded by Lagrangian relaxation of the table.
+class PrimeCoverSolver : public NonCopyable
+{
+public:
+   PrimeCoverSolver(const TCubeVector& primes, const std::vector<std::vector<long>>& row_primes);
+
+   // Returns prime cubes of the cover.
+   std::vector<long> Solve();
+
+private:
+   // Active rows are not covered yet, active prime cubes are neither selected nor excluded.
+   // Multipliers of the relaxation are passed to subtables, so their bound starts from them.
+   struct Table
+   {
+      TBitVector rows;
+      TBitVector primes;
+      std::vector<double> row_multipliers;
+      double cube_count_multiplier;
+      std::vector<long> selection;
+      long long cost;
+   };
+
+   // Only covers, which are cheaper than the limit, are searched.
+   struct Solution
+   {
+      std::vector<long> selection;
+      long long limit;
+   };
+
+   // Prime cube costs 1, while the amount of cubes is minimized, and its amount of literals then.
+   long long GetPrimeCost(long prime) const;
+
+   Table MakeTable() const;
+   std::vector<long> GetRows(const Table& table) const;
+   std::vector<long> GetPrimes(const Table& table) const;
+
+   void SelectPrime(Table& table, long prime) const;
+   // Returns false, if the table can't be covered within the maximal amount of cubes.
+   bool Reduce(Table& table) const;
+   // Splits the table into parts, that have no common rows and prime cubes.
+   std::vector<Table> Split(const Table& table) const;
+   // Returns false, if the lower bound of the cost of covers isn't less than the limit.
+   // Prime cubes, that must be or can't be in covers cheaper than the limit, are selected
+   // or excluded, and is_changed is set then.
+   bool Bound(Table& table, long long limit, bool& is_changed) const;
+   // Returns prime cubes of the row with the least amount of them in order of branching.
+   std::vector<long> GetBranchPrimes(const Table& table) const;
+   void Search(Table& table, Solution& best) const;
+
+private:
+   static const long s_max_subgradient_iteration_count = 256;
+
+   const TCubeVector& m_primes;
+   std::vector<TBitVector> m_row_primes;
+   std::vector<TBitVector> m_prime_rows;
+   bool m_are_literals_minimized;
+   long m_max_cube_count;
+};
+
+PrimeCoverSolver::PrimeCoverSolver(const TCubeVector& primes, const std::vector<std::vector<long>>& row_primes) :
+   m_primes(primes),
+   m_row_primes(row_primes.size(), MakeBitVector(primes.size())),
+   m_prime_rows(primes.size(), MakeBitVector(row_primes.size())),
+   m_are_literals_minimized(false),
+   m_max_cube_count(static_cast<long>(primes.size()))
+{
+   for (auto row = 0L; row < (long)row_primes.size(); ++row)
+   {
+      for (auto prime : row_primes[row])
+      {
+         SetBit(m_row_primes[row], prime);
+         SetBit(m_prime_rows[prime], row);
+      }
+   }
+}
+
+std::vector<long> PrimeCoverSolver::Solve()
+{
+   // Greedy cover bounds the search of the minimal amount of cubes from the start.
+   m_are_literals_minimized = false;
+   m_max_cube_count = static_cast<long>(m_primes.size());
+
+   auto greedy_table = MakeTable();
+   while (Reduce(greedy_table) && !IsEmpty(greedy_table.rows))
+   {
+      SelectPrime(greedy_table, GetBranchPrimes(greedy_table)[0]);
+   }
+   assert(IsEmpty(greedy_table.rows));
+
+   Solution best = { greedy_table.selection, greedy_table.cost + 1 };
+   auto table = MakeTable();
+   Search(table, best);
+
+   // Parts of the table are bound by the amount of cubes, so the table isn't split then.
+   m_are_literals_minimized = true;
+   m_max_cube_count = static_cast<long>(best.selection.size());
+
+   best.limit = 1;
+   for (auto prime : best.selection)
+   {
+      best.limit += GetPrimeCost(prime);
+   }
+   table = MakeTable();
+   Search(table, best);
+
+   return best.selection;
+}
+
+long long PrimeCoverSolver::GetPrimeCost(long prime) const
+{
+   return m_are_literals_minimized ? GetLiteralCount(m_primes[prime]) : 1;
+}
+
+PrimeCoverSolver::Table PrimeCoverSolver::MakeTable() const
+{
+   Table table = { MakeBitVector(m_row_primes.size()), MakeBitVector(m_primes.size()),
+                   std::vector<double>(m_row_primes.size(), -1.0), 0.0, std::vector<long>(), 0 };
+   for (auto row = 0L; row < (long)m_row_primes.size(); ++row)
+   {
+      SetBit(table.rows, row);
+   }
+   for (auto prime = 0L; prime < (long)m_primes.size(); ++prime)
+   {
+      SetBit(table.primes, prime);
+   }
+   return table;
+}
+
+std::vector<long> PrimeCoverSolver::GetRows(const Table& table) const
+{
+   std::vector<long> rows;
+   ForEachCommonBit(table.rows, table.rows, [&rows](long row)
+   {
+      rows.push_back(row);
+   });
+   return rows;
+}
+
+std::vector<long> PrimeCoverSolver::GetPrimes(const Table& table) const
+{
+   std::vector<long> primes;
+   ForEachCommonBit(table.primes, table.primes, [&primes](long prime)
+   {
+      primes.push_back(prime);
+   });
+   return primes;
+}
+
+void PrimeCoverSolver::SelectPrime(Table& table, long prime) const
+{
+   ResetBit(table.primes, prime);
+   table.selection.push_back(prime);
+   table.cost += GetPrimeCost(prime);
+
+   for (std::size_t index = 0; index < table.rows.size(); ++index)
+   {
+      table.rows[index] &= ~m_prime_rows[prime][index];
+   }
+}
+
+bool PrimeCoverSolver::Reduce(Table& table) const
+{
+   // Dominance rarely allows further reduction, except by new essential prime cubes,
+   // so it's applied once.
+   auto is_dominance_applied = false;
+   auto is_changed = true;
+   while (is_changed)
+   {
+      is_changed = false;
+
+      // Prime cube is essential, if it's the only one, that covers a row.
+      auto rows = GetRows(table);
+      std::vector<long> prime_counts(m_row_primes.size(), 0);
+      for (auto row : rows)
+      {
+         if (!TestBit(table.rows, row))
+         {
+            continue;
+         }
+
+         prime_counts[row] = CountCommonBits(m_row_primes[row], table.primes);
+         if (0 == prime_counts[row])
+         {
+            return false;
+         }
+         if (1 == prime_counts[row])
+         {
+            ForEachCommonBit(m_row_primes[row], table.primes, [this, &table](long prime)
+            {
+               SelectPrime(table, prime);
+            });
+            is_changed = true;
+         }
+      }
+
+      if ((long)table.selection.size() > m_max_cube_count)
+      {
+         return false;
+      }
+      if (is_changed || is_dominance_applied)
+      {
+         continue;
+      }
+      is_dominance_applied = true;
+
+      // Row, whose prime cubes include all prime cubes of another row, is covered together with it.
+      // Such rows are among rows of any prime cube of the other row, so the one with the least
+      // amount of rows is checked.
+      const auto primes = GetPrimes(table);
+      std::vector<long> row_counts(m_primes.size(), 0);
+      for (auto prime : primes)
+      {
+         row_counts[prime] = CountCommonBits(m_prime_rows[prime], table.rows);
+      }
+
+      for (auto row : rows)
+      {
+         if (!TestBit(table.rows, row))
+         {
+            continue;
+         }
+
+         auto min_prime = -1L;
+         ForEachCommonBit(m_row_primes[row], table.primes, [&](long prime)
+         {
+            if (min_prime < 0 || row_counts[prime] < row_counts[min_prime])
+            {
+               min_prime = prime;
+            }
+         });
+
+         ForEachCommonBit(m_prime_rows[min_prime], table.rows, [&](long other_row)
+         {
+            if (other_row != row &&
+                (prime_counts[row] < prime_counts[other_row] || (prime_counts[row] == prime_counts[other_row] && row < other_row)) &&
+                IsSubset(m_row_primes[row], m_row_primes[other_row], table.primes))
+            {
+               ResetBit(table.rows, other_row);
+               is_changed = true;
+            }
+         });
+      }
+
+      // Prime cube, whose rows are covered by another prime cube, that costs no more, is excluded.
+      // Such prime cubes are among prime cubes of any row of the excluded one, so the row
+      // with the least amount of prime cubes is checked.
+      for (auto prime : primes)
+      {
+         row_counts[prime] = CountCommonBits(m_prime_rows[prime], table.rows);
+      }
+
+      for (auto prime : primes)
+      {
+         auto min_row = -1L;
+         ForEachCommonBit(m_prime_rows[prime], table.rows, [&](long row)
+         {
+            if (min_row < 0 || prime_counts[row] < prime_counts[min_row])
+            {
+               min_row = row;
+            }
+         });
+
+         if (min_row < 0)
+         {
+            ResetBit(table.primes, prime);
+            is_changed = true;
+            continue;
+         }
+
+         ForEachCommonBit(m_row_primes[min_row], table.primes, [&](long other_prime)
+         {
+            if (other_prime == prime || !TestBit(table.primes, prime) || GetPrimeCost(other_prime) > GetPrimeCost(prime) ||
+                row_counts[other_prime] < row_counts[prime] ||
+                !IsSubset(m_prime_rows[prime], m_prime_rows[other_prime], table.rows))
+            {
+               return;
+            }
+
+            // Prime cubes with the same rows and cost exclude each other, so the first one is kept.
+            if (GetPrimeCost(other_prime) < GetPrimeCost(prime) || other_prime < prime ||
+                row_counts[other_prime] > row_counts[prime])
+            {
+               ResetBit(table.primes, prime);
+               is_changed = true;
+            }
+         });
+      }
+   }
+
+   return true;
+}
+
+std::vector<PrimeCoverSolver::Table> PrimeCoverSolver::Split(const Table& table) const
+{
+   std::vector<Table> parts;
+   auto rest_rows = table.rows;
+   while (!IsEmpty(rest_rows))
+   {
+      // Rows and prime cubes, that are reachable from the first rest row, form a part.
+      Table part = { MakeBitVector(m_row_primes.size()), MakeBitVector(m_primes.size()),
+                     table.row_multipliers, 0.0, std::vector<long>(), 0 };
+
+      std::vector<long> rows(1, FindFirstBit(rest_rows));
+      ResetBit(rest_rows, rows[0]);
+      SetBit(part.rows, rows[0]);
+
+      while (!rows.empty())
+      {
+         const auto row = rows.back();
+         rows.pop_back();
+
+         ForEachCommonBit(m_row_primes[row], table.primes, [&](long prime)
+         {
+            if (TestBit(part.primes, prime))
+            {
+               return;
+            }
+
+            SetBit(part.primes, prime);
+            ForEachCommonBit(m_prime_rows[prime], rest_rows, [&](long prime_row)
+            {
+               ResetBit(rest_rows, prime_row);
+               SetBit(part.rows, prime_row);
+               rows.push_back(prime_row);
+            });
+         });
+      }
+
+      parts.push_back(std::move(part));
+   }
+   return parts;
+}
+
+bool PrimeCoverSolver::Bound(Table& table, long long limit, bool& is_changed) const
+{
+   is_changed = false;
+
+   // Costs are integer, so a cover is cheaper than the limit, only if its cost isn't above this.
+   const auto max_cost = static_cast<double>(limit - table.cost - 1) + 0.5;
+   const auto rest_cube_count = static_cast<double>(m_max_cube_count - (long)table.selection.size());
+
+   // Rows of prime cubes are indexes in the list of active rows.
+   const auto rows = GetRows(table);
+   const auto primes = GetPrimes(table);
+   std::vector<long> row_positions(m_row_primes.size(), -1);
+   for (auto position = 0L; position < (long)rows.size(); ++position)
+   {
+      row_positions[rows[position]] = position;
+   }
+
+   std::vector<long> prime_row_offsets(1, 0);
+   std::vector<long> prime_rows;
+   std::vector<double> prime_costs;
+   for (auto prime : primes)
+   {
+      ForEachCommonBit(m_prime_rows[prime], table.rows, [&](long row)
+      {
+         prime_rows.push_back(row_positions[row]);
+      });
+      prime_row_offsets.push_back(static_cast<long>(prime_rows.size()));
+      prime_costs.push_back(static_cast<double>(GetPrimeCost(prime)));
+   }
+
+   // Multiplier of a new row is its share of the cheapest cost per row of its prime cubes.
+   std::vector<double> row_multipliers(rows.size(), std::numeric_limits<double>::max());
+   for (auto index = 0L; index < (long)primes.size(); ++index)
+   {
+      const auto share = prime_costs[index] / (prime_row_offsets[index + 1] - prime_row_offsets[index]);
+      for (auto offset = prime_row_offsets[index]; offset < prime_row_offsets[index + 1]; ++offset)
+      {
+         row_multipliers[prime_rows[offset]] = std::min(row_multipliers[prime_rows[offset]], share);
+      }
+   }
+   for (auto position = 0L; position < (long)rows.size(); ++position)
+   {
+      if (table.row_multipliers[rows[position]] >= 0.0)
+      {
+         row_multipliers[position] = table.row_multipliers[rows[position]];
+      }
+   }
+   auto cube_count_multiplier = table.cube_count_multiplier;
+
+   // Lagrangian relaxation drops the constraints, that rows are covered and that the amount
+   // of cubes is limited, at the price of their multipliers. The bound is the sum of row
+   // multipliers and of negative reduced costs of prime cubes without the price of the rest cubes.
+   std::vector<double> reduced_costs(primes.size(), 0.0);
+   const auto calculate_bound = [&]()
+   {
+      auto bound = -cube_count_multiplier * rest_cube_count;
+      for (auto multiplier : row_multipliers)
+      {
+         bound += multiplier;
+      }
+      for (auto index = 0L; index < (long)primes.size(); ++index)
+      {
+         auto reduced_cost = prime_costs[index] + cube_count_multiplier;
+         for (auto offset = prime_row_offsets[index]; offset < prime_row_offsets[index + 1]; ++offset)
+         {
+            reduced_cost -= row_multipliers[prime_rows[offset]];
+         }
+         reduced_costs[index] = reduced_cost;
+         bound += std::min(reduced_cost, 0.0);
+      }
+      return bound;
+   };
+
+   // Multipliers are improved by subgradient optimization towards the limit. The step is
+   // decreased, when the bound doesn't grow for several iterations.
+   auto best_row_multipliers = row_multipliers;
+   auto best_cube_count_multiplier = cube_count_multiplier;
+   auto best_bound = calculate_bound();
+   auto bound = best_bound;
+   auto step_scale = 2.0;
+   auto failure_count = 0L;
+   std::vector<long> cover_counts(rows.size(), 0);
+   for (auto iteration = 0L; iteration < s_max_subgradient_iteration_count && best_bound <= max_cost &&
+        step_scale > 0.01; ++iteration)
+   {
+      std::fill(cover_counts.begin(), cover_counts.end(), 0);
+      auto cube_count = 0L;
+      for (auto index = 0L; index < (long)primes.size(); ++index)
+      {
+         if (reduced_costs[index] < 0.0)
+         {
+            ++cube_count;
+            for (auto offset = prime_row_offsets[index]; offset < prime_row_offsets[index + 1]; ++offset)
+            {
+               ++cover_counts[prime_rows[offset]];
+            }
+         }
+      }
+
+      auto norm = 0.0;
+      for (auto position = 0L; position < (long)rows.size(); ++position)
+      {
+         const auto gradient = 1.0 - cover_counts[position];
+         if (gradient > 0.0 || row_multipliers[position] > 0.0)
+         {
+            norm += gradient * gradient;
+         }
+      }
+      const auto cube_count_gradient = m_are_literals_minimized ? cube_count - rest_cube_count : 0.0;
+      if (cube_count_gradient > 0.0 || cube_count_multiplier > 0.0)
+      {
+         norm += cube_count_gradient * cube_count_gradient;
+      }
+      if (0.0 == norm)
+      {
+         break;
+      }
+
+      const auto step = step_scale * (max_cost + 1.0 - bound) / norm;
+      for (auto position = 0L; position < (long)rows.size(); ++position)
+      {
+         row_multipliers[position] = std::max(0.0, row_multipliers[position] + step * (1.0 - cover_counts[position]));
+      }
+      cube_count_multiplier = std::max(0.0, cube_count_multiplier + step * cube_count_gradient);
+
+      bound = calculate_bound();
+      if (bound > best_bound)
+      {
+         best_bound = bound;
+         best_row_multipliers = row_multipliers;
+         best_cube_count_multiplier = cube_count_multiplier;
+         failure_count = 0;
+      }
+      else if (++failure_count == 8)
+      {
+         step_scale /= 2.0;
+         failure_count = 0;
+      }
+   }
+
+   row_multipliers = best_row_multipliers;
+   cube_count_multiplier = best_cube_count_multiplier;
+   best_bound = calculate_bound();
+   if (best_bound > max_cost)
+   {
+      return false;
+   }
+
+   for (auto position = 0L; position < (long)rows.size(); ++position)
+   {
+      table.row_multipliers[rows[position]] = row_multipliers[position];
+   }
+   table.cube_count_multiplier = cube_count_multiplier;
+
+   // Selection of a prime cube with positive reduced cost increases the bound by it,
+   // and exclusion of a prime cube with negative reduced cost decreases the bound by it.
+   for (auto index = 0L; index < (long)primes.size(); ++index)
+   {
+      if (best_bound + std::abs(reduced_costs[index]) > max_cost)
+      {
+         if (reduced_costs[index] < 0.0)
+         {
+            SelectPrime(table, primes[index]);
+         }
+         else
+         {
+            ResetBit(table.primes, primes[index]);
+         }
+         is_changed = true;
+      }
+   }
+
+   return true;
+}
+
+std::vector<long> PrimeCoverSolver::GetBranchPrimes(const Table& table) const
+{
+   // The row with the least amount of prime cubes is branched on.
+   auto branch_row = -1L;
+   auto branch_prime_count = 0L;
+   for (auto row : GetRows(table))
+   {
+      const auto prime_count = CountCommonBits(m_row_primes[row], table.primes);
+      if (branch_row < 0 || prime_count < branch_prime_count)
+      {
+         branch_row = row;
+         branch_prime_count = prime_count;
+      }
+   }
+
+   // Prime cubes, that cover more rows and cost less, are tried first to find a cheap cover early.
+   std::vector<long> branch_primes;
+   std::vector<long> row_counts(m_primes.size(), 0);
+   ForEachCommonBit(m_row_primes[branch_row], table.primes, [&](long prime)
+   {
+      branch_primes.push_back(prime);
+      row_counts[prime] = CountCommonBits(m_prime_rows[prime], table.rows);
+   });
+   std::stable_sort(branch_primes.begin(), branch_primes.end(), [this, &row_counts](long left, long right)
+   {
+      if (row_counts[left] != row_counts[right])
+      {
+         return row_counts[left] > row_counts[right];
+      }
+      return GetPrimeCost(left) < GetPrimeCost(right);
+   });
+
+   return branch_primes;
+}
+
+void PrimeCoverSolver::Search(Table& table, Solution& best) const
+{
+   auto is_changed = true;
+   while (is_changed)
+   {
+      if (!Reduce(table))
+      {
+         return;
+      }
+
+      if (IsEmpty(table.rows))
+      {
+         if (table.cost < best.limit)
+         {
+            best.selection = table.selection;
+            best.limit = table.cost;
+         }
+         return;
+      }
+
+      if (!Bound(table, best.limit, is_changed))
+      {
+         return;
+      }
+   }
+
+   auto parts = m_are_literals_minimized ? std::vector<Table>() : Split(table);
+   if (parts.size() > 1)
+   {
+      // The cheapest cover of the table is the union of the cheapest covers of its parts.
+      for (auto& part : parts)
+      {
+         Solution part_best = { std::vector<long>(), best.limit - table.cost };
+         Search(part, part_best);
+         if (part_best.selection.empty())
+         {
+            return;
+         }
+
+         table.selection.insert(table.selection.end(), part_best.selection.begin(), part_best.selection.end());
+         table.cost += part_best.limit;
+      }
+
+      best.selection = table.selection;
+      best.limit = table.cost;
+      return;
+   }
+
+   // Each branch selects its prime cube and excludes prime cubes of the previous branches,
+   // so the same cover isn't searched twice.
+   for (auto prime : GetBranchPrimes(table))
+   {
+      auto branch_table = table;
+      SelectPrime(branch_table, prime);
+      Search(branch_table, best);
+
+      ResetBit(table.primes, prime);
+   }
+}
+
+// Selects the cheapest set of prime cubes, that cover all true combinations of on_set.
+TCubeVector SelectPrimeCubes(const TCubeVector& primes, const TruthTable& on_set)
+{
+   // Rows of the covering table are true combinations of on_set.
+   std::vector<long> row_indexes(on_set.GetCombinationCount(), -1);
+   auto row_count = 0L;
+   on_set.ForEachTrueCombination(Cube{ 0, 0 }, [&row_indexes, &row_count](long long combination)
+   {
+      row_indexes[combination] = row_count++;
+   });
+
+   std::vector<std::vector<long>> row_primes(row_count);
+   for (auto prime = 0L; prime < (long)primes.size(); ++prime)
+   {
+      on_set.ForEachTrueCombination(primes[prime], [&](long long combination)
+      {
+         row_primes[row_indexes[combination]].push_back(prime);
+      });
+   }
+
+   PrimeCoverSolver solver(primes, row_primes);
+   auto selection = solver.Solve();
+   std::sort(selection.begin(), selection.end());
+
+   TCubeVector cover;
+   for (auto prime : selection)
+   {
+      cover.push_back(primes[prime]);
+   }
+   return cover;
+}
+
+// Heuristic minimization in the manner of Espresso. Cover is kept together with amounts
+// of its cubes, that cover each true combination of on_set, so redundant cubes and
+// combinations, covered by a single cube only, are found without comparison of cubes.
+class EspressoMinimizer : public NonCopyable
+{
+public:
+   EspressoMinimizer(const TruthTable& on_set, const TruthTable& dc_set);
+
+   TCubeVector Minimize();
+
+private:
+   // Frees variables of the cube, while it covers only true combinations of the care set.
+   // If is_directed is true, variables, that separate the cube from other cubes
+   // of the cover, are freed first, so the cube grows towards them.
+   Cube Expand(Cube cube, bool is_directed) const;
+
+   void BuildInitialCover();
+   void ExpandCover();
+   void MakeCoverIrredundant();
+   void ReduceCover();
+
+   void UpdateCoverCounts(const Cube& cube, int delta);
+   void RemoveFlaggedCubes(const std::vector<bool>& is_removed);
+
+private:
+   const TruthTable& m_on_set;
+   TruthTable m_care_set;
+   long m_param_count;
+   TCubeVector m_cover;
+   // Indexed by combinations, only true combinations of on_set are counted.
+   std::vector<std::uint32_t> m_cover_counts;
+};
+
+EspressoMinimizer::EspressoMinimizer(const TruthTable& on_set, const TruthTable& dc_set) :
+   m_on_set(on_set),
+   m_care_set(on_set),
+   m_param_count(on_set.GetParameterCount()),
+   m_cover(),
+   m_cover_counts(on_set.GetCombinationCount(), 0)
+{
+   m_care_set.Unite(dc_set);
+}
+
+TCubeVector EspressoMinimizer::Minimize()
+{
+   BuildInitialCover();
+   MakeCoverIrredundant();
+
+   auto best_cover = m_cover;
+   auto best_cost = GetCoverCost(m_cover);
+
+   for (auto iteration = 0L; iteration < g_max_espresso_iteration_count; ++iteration)
+   {
+      // Reduced cubes can be expanded in other directions, that make other cubes redundant.
+      ReduceCover();
+      ExpandCover();
+      MakeCoverIrredundant();
+
+      const auto cost = GetCoverCost(m_cover);
+      if (!(cost < best_cost))
+      {
+         break;
+      }
+
+      best_cover = m_cover;
+      best_cost = cost;
+   }
+
+   return best_cover;
+}
+
+Cube EspressoMinimizer::Expand(Cube cube, bool is_directed) const
+{
+   std::vector<long> variables;
+   for (auto variable = m_param_count - 1; variable >= 0; --variable)
+   {
+      if (cube.mask & (TBitBlock(1) << variable))
+      {
+         variables.push_back(variable);
+      }
+   }
+
+   if (is_directed && m_cover.size() <= g_max_directed_expansion_cover_size)
+   {
+      // Freeing of the only variable, that conflicts with another cube, brings the cube closer to it.
+      std::vector<long> scores(m_param_count, 0);
+      for (const auto& other_cube : m_cover)
+      {
+         const auto conflicts = GetCubeConflicts(cube, other_cube);
+         if (conflicts != 0 && 0 == (conflicts & (conflicts - 1)))
+         {
+            ++scores[FindFirstSetBit(conflicts)];
+         }
+      }
+
+      std::stable_sort(variables.begin(), variables.end(), [&scores](long left, long right)
+      {
+         return scores[left] > scores[right];
+      });
+   }
+
+   for (auto variable : variables)
+   {
+      // The cube is extended by the opposite half, which must be covered by the care set.
+      const auto bit_mask = TBitBlock(1) << variable;
+      if (m_care_set.IsCubeTrue(Cube{ cube.mask, cube.values ^ bit_mask }))
+      {
+         cube.mask &= ~bit_mask;
+         cube.values &= ~bit_mask;
+      }
+   }
+
+   return cube;
+}
+
+void EspressoMinimizer::BuildInitialCover()
+{
+   // Each combination, that isn't covered yet, is expanded to a prime cube.
+   TruthTable covered_set(m_param_count);
+   m_on_set.ForEachTrueCombination(Cube{ 0, 0 }, [this, &covered_set](long long combination)
+   {
+      if (!covered_set.GetValue(combination))
+      {
+         const auto cube = Expand(MakeMintermCube(m_param_count, combination), false);
+         covered_set.SetCube(cube, true);
+         m_cover.push_back(cube);
+         UpdateCoverCounts(cube, 1);
+      }
+   });
+}
+
+void EspressoMinimizer::ExpandCover()
+{
+   // Smaller cubes are expanded first, since they are more likely to be covered by others.
+   std::vector<long> order(m_cover.size());
+   for (auto index = 0L; index < (long)order.size(); ++index)
+   {
+      order[index] = index;
+   }
+   std::stable_sort(order.begin(), order.end(), [this](long left, long right)
+   {
+      return GetLiteralCount(m_cover[left]) > GetLiteralCount(m_cover[right]);
+   });
+
+   std::vector<bool> is_removed(m_cover.size(), false);
+   for (auto index : order)
+   {
+      if (is_removed[index])
+      {
+         continue;
+      }
+
+      const auto cube = m_cover[index];
+      const auto expanded_cube = Expand(cube, true);
+      if (expanded_cube == cube)
+      {
+         continue;
+      }
+
+      m_on_set.ForEachTrueCombination(expanded_cube, [this, &cube](long long combination)
+      {
+         if (!DoesCubeContainCombination(cube, combination))
+         {
+            ++m_cover_counts[combination];
+         }
+      });
+      m_cover[index] = expanded_cube;
+
+      for (auto other_index = 0L; other_index < (long)m_cover.size(); ++other_index)
+      {
+         if (other_index != index && !is_removed[other_index] &&
+             DoesCubeContain(expanded_cube, m_cover[other_index]))
+         {
+            UpdateCoverCounts(m_cover[other_index], -1);
+            is_removed[other_index] = true;
+         }
+      }
+   }
+
+   RemoveFlaggedCubes(is_removed);
+}
+
+void EspressoMinimizer::MakeCoverIrredundant()
+{
+   // Cubes with more literals cover less combinations, so they are removed first.
+   std::vector<long> order(m_cover.size());
+   for (auto index = 0L; index < (long)order.size(); ++index)
+   {
+      order[index] = index;
+   }
+   std::stable_sort(order.begin(), order.end(), [this](long left, long right)
+   {
+      return GetLiteralCount(m_cover[left]) > GetLiteralCount(m_cover[right]);
+   });
+
+   std::vector<bool> is_removed(m_cover.size(), false);
+   for (auto index : order)
+   {
+      auto is_redundant = true;
+      m_on_set.ForEachTrueCombination(m_cover[index], [this, &is_redundant](long long combination)
+      {
+         is_redundant = is_redundant && m_cover_counts[combination] > 1;
+      });
+
+      if (is_redundant)
+      {
+         UpdateCoverCounts(m_cover[index], -1);
+         is_removed[index] = true;
+      }
+   }
+
+   RemoveFlaggedCubes(is_removed);
+}
+
+void EspressoMinimizer::ReduceCover()
+{
+   // Larger cubes are reduced first, so they leave more combinations to smaller ones.
+   std::vector<long> order(m_cover.size());
+   for (auto index = 0L; index < (long)order.size(); ++index)
+   {
+      order[index] = index;
+   }
+   std::stable_sort(order.begin(), order.end(), [this](long left, long right)
+   {
+      return GetLiteralCount(m_cover[left]) < GetLiteralCount(m_cover[right]);
+   });
+
+   const auto full_mask = MakeMintermCube(m_param_count, 0).mask;
+
+   std::vector<bool> is_removed(m_cover.size(), false);
+   for (auto index : order)
+   {
+      const auto cube = m_cover[index];
+
+      // The cube is reduced to the supercube of combinations, that are covered by it only.
+      auto and_bits = full_mask;
+      auto or_bits = TBitBlock(0);
+      auto has_unique_combinations = false;
+      m_on_set.ForEachTrueCombination(cube, [&](long long combination)
+      {
+         if (1 == m_cover_counts[combination])
+         {
+            and_bits &= static_cast<TBitBlock>(combination);
+            or_bits |= static_cast<TBitBlock>(combination);
+            has_unique_combinations = true;
+         }
+      });
+
+      if (!has_unique_combinations)
+      {
+         // There are no such combinations, so the cube is redundant.
+         UpdateCoverCounts(cube, -1);
+         is_removed[index] = true;
+         continue;
+      }
+
+      const auto mask = full_mask & ~(and_bits ^ or_bits);
+      const Cube reduced_cube = { mask, and_bits & mask };
+
+      m_on_set.ForEachTrueCombination(cube, [this, &reduced_cube](long long combination)
+      {
+         if (!DoesCubeContainCombination(reduced_cube, combination))
+         {
+            --m_cover_counts[combination];
+         }
+      });
+      m_cover[index] = reduced_cube;
+   }
+
+   RemoveFlaggedCubes(is_removed);
+}
+
+void EspressoMinimizer::UpdateCoverCounts(const Cube& cube, int delta)
+{
+   m_on_set.ForEachTrueCombination(cube, [this, delta](long long combination)
+   {
+      m_cover_counts[combination] += delta;
+   });
+}
+
+void EspressoMinimizer::RemoveFlaggedCubes(const std::vector<bool>& is_removed)
+{
+   auto count = 0L;
+   for (auto index = 0L; index < (long)m_cover.size(); ++index)
+   {
+      if (!is_removed[index])
+      {
+         m_cover[count++] = m_cover[index];
+      }
+   }
+   m_cover.resize(count);
+}
+
+} // namespace
+
+TCubeVector MinimizeCover(const TruthTable& on_set, const TruthTable& dc_set)
+{
+   assert(on_set.GetParameterCount() == dc_set.GetParameterCount());
+
+   const auto param_count = on_set.GetParameterCount();
+   if (on_set.IsEmpty())
+   {
+      return TCubeVector();
+   }
+
+   TCubeVector cover;
+   if (param_count <= g_max_exact_minimization_parameter_count)
+   {
+      auto care_set = on_set;
+      care_set.Unite(dc_set);
+      cover = SelectPrimeCubes(GeneratePrimeCubes(care_set, on_set), on_set);
+   }
+   else
+   {
+      EspressoMinimizer minimizer(on_set, dc_set);
+      cover = minimizer.Minimize();
+   }
+
+   SortCubes(cover, param_count);
+   return cover;
+}
+
+} // namespace dm
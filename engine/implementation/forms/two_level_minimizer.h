@@ -0,0 +1,23 @@
+#pragma once
+
+#include "cube.h"
+#include "truth_table.h"
+
+namespace dm
+{
+
+// Functions with no more parameters than this are minimized exactly.
+const long g_max_exact_minimization_parameter_count = 10;
+
+// Builds a cover of true combinations of on_set by prime cubes, which may cover
+// true combinations of dc_set (don't care set) too. Cover with the minimal amount
+// of cubes, and then of literals, is searched. Functions with up to
+// g_max_exact_minimization_parameter_count parameters are minimized exactly: prime cubes
+// are generated by Quine-McCluskey method, and the part of the cover, which isn't defined
+// by essential prime cubes, is found by branch and bound. Larger functions are minimized
+// heuristically by the Espresso loop of reducing, expanding and making the cover
+// irredundant, while the cost of the cover decreases, so their cover may be not minimal.
+// Combinations of on_set must not be in dc_set. Cubes are sorted by SortCubes.
+TCubeVector MinimizeCover(const TruthTable& on_set, const TruthTable& dc_set);
+
+} // namespace dm
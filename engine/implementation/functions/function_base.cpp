@@ -2,11 +2,27 @@
 #include "../common/exception.h"
 #include "../common/qualifier_utils.h"
 
+#include <cstdlib>
 #include <cassert>
 
 namespace dm
 {
 
+namespace
+{
+
+void ParseNumber(const std::string& str, char** end, long& value)
+{
+   value = std::strtol(str.c_str(), end, 10);
+}
+
+void ParseNumber(const std::string& str, char** end, double& value)
+{
+   value = std::strtod(str.c_str(), end);
+}
+
+} // namespace
+
 Function::Function(const char* name, long param_count) :
    NamedEntity(name), m_param_count(param_count)
 {
@@ -59,6 +75,25 @@ Variable* Function::CheckAndGetVariable(
    return const_cast<Variable*>(CheckAndGetConstVariable(variable_mgr, param, must_exist));
 }
 
+template <typename TNumber>
+TNumber Function::CheckAndGetNumber(const StringPtrLen& param, TNumber min_value, TNumber max_value, const char* description)
+{
+   const std::string str = param;
+
+   char* end = nullptr;
+   auto value = TNumber();
+   ParseNumber(str, &end, value);
+   if (str.empty() || end != str.c_str() + str.size() || !(value >= min_value && value <= max_value))
+   {
+      Error(GetParameterReportingString(param), " must be ", description, ".");
+   }
+
+   return value;
+}
+
+template long Function::CheckAndGetNumber(const StringPtrLen&, long, long, const char*);
+template double Function::CheckAndGetNumber(const StringPtrLen&, double, double, const char*);
+
 std::string Function::GetParameterReportingString(const StringPtrLen& param)
 {
    std::stringstream stream;
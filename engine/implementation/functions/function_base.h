@@ -33,6 +33,12 @@ protected:
    Variable* CheckAndGetVariable(
       VariableManager& variable_mgr, const StringPtrLen& param, bool must_exist = true);
 
+   // The whole parameter must be a number from min_value to max_value, otherwise
+   // it's reported, that the parameter must be the described value.
+   // Instantiated for long and double.
+   template <typename TNumber>
+   TNumber CheckAndGetNumber(const StringPtrLen& param, TNumber min_value, TNumber max_value, const char* description);
+
 private:
    std::string GetParameterReportingString(const StringPtrLen& param_value);
 
@@ -0,0 +1,34 @@
+#include "function_mode.h"
+#include "../common/literals.h"
+#include "../common/exception.h"
+
+#include <sstream>
+#include <cassert>
+
+namespace dm
+{
+
+ModeFunction::ModeFunction(const char* name, const char* mode_title, TModeSetter mode_setter) :
+   Function(name, 1), m_mode_title(mode_title), m_mode_setter(mode_setter)
+{
+}
+
+TFunctionOutputPtr ModeFunction::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   assert(params.size() == GetParameterCount());
+
+   const auto literal = StringToLiteralType(params[0]);
+   if (LiteralType::None == literal)
+   {
+      Error("Parameter '", params[0], "' of function '", GetName(), "' must be a literal.");
+   }
+
+   (variable_mgr.*m_mode_setter)(LiteralType::True == literal);
+
+   std::stringstream stream;
+   stream << m_mode_title << " mode is " << (LiteralType::True == literal ? "on" : "off") << ".";
+
+   return std::make_unique<FunctionOutput>(stream.str());
+}
+
+} // namespace dm
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "function_base.h"
+
+namespace dm
+{
+
+// Function with a literal parameter, that switches a mode of the variable manager on or off.
+// Modes affect variables, declared after the switch, so variables, declared before, keep
+// their representation.
+class ModeFunction : public Function
+{
+public:
+   using TModeSetter = void (VariableManager::*)(bool);
+
+   // Title of the mode starts the output, e.g. "Flat store mode is on.".
+   ModeFunction(const char* name, const char* mode_title, TModeSetter mode_setter);
+
+   virtual TFunctionOutputPtr Call(VariableManager& variable_mgr, const TStringPtrLenVector& params) override;
+
+private:
+   const char* m_mode_title;
+   TModeSetter m_mode_setter;
+};
+
+} // namespace dm
@@ -0,0 +1,47 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../aig/aig_balancer.h"
+#include "../../aig/aig_builder.h"
+
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("aig_balance", 1)
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   assert(params.size() == GetParameterCount());
+   auto variable = CheckAndGetVariable(variable_mgr, params[0]);
+
+   const auto param_count = variable->GetParameterCount();
+   AigManager manager(param_count);
+   const auto root = BuildAig(manager, variable->GetSharedExpression());
+
+   // Balanced graph is built separately, so it doesn't contain nodes of the original one.
+   AigManager balanced_manager(param_count);
+   const auto balanced_root = BalanceAig(manager, root, balanced_manager);
+   variable->SetSharedExpression(BuildAigExpression(balanced_manager, balanced_root));
+
+   return std::make_unique<FunctionOutput>(variable->ToString());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
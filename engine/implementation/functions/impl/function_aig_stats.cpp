@@ -0,0 +1,46 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../aig/aig_builder.h"
+
+#include <sstream>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("aig_stats", 1)
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   assert(params.size() == GetParameterCount());
+   auto variable = CheckAndGetConstVariable(variable_mgr, params[0]);
+
+   AigManager manager(variable->GetParameterCount());
+   const auto root = BuildAig(manager, variable->GetSharedExpression());
+
+   std::stringstream stream;
+   stream << "AIG of variable '" << variable->GetName() << "' has "
+          << manager.GetAndCount(root) << " AND nodes and "
+          << manager.GetLevel(AigManager::GetNode(root)) << " levels.";
+
+   return std::make_unique<FunctionOutput>(stream.str());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
@@ -0,0 +1,90 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../bdd/bdd_builder.h"
+
+#include <sstream>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("bdd_compare", 2)
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   assert(params.size() == GetParameterCount());
+
+   auto variable1 = CheckAndGetConstVariable(variable_mgr, params[0]);
+   auto variable2 = CheckAndGetConstVariable(variable_mgr, params[1]);
+
+   std::stringstream stream;
+   stream << "Variables '" << variable1->GetName() << "' and '" << variable2->GetName() << "' are ";
+
+   if (variable1->GetParameterCount() != variable2->GetParameterCount())
+   {
+      stream << "not equal. Different number of parameters.";
+   }
+   else
+   {
+      const auto param_count = variable1->GetParameterCount();
+
+      // Both diagrams share the manager, so equal functions have equal roots.
+      BddManager manager(param_count);
+      const auto bdd1 = BuildBdd(manager, variable1->GetSharedExpression());
+      const auto bdd2 = BuildBdd(manager, variable2->GetSharedExpression());
+
+      if (bdd1 == bdd2)
+      {
+         stream << "equal.";
+      }
+      else
+      {
+         // The first differing combination is found by fixing parameters one
+         // by one, choosing false whenever the rest can still differ.
+         auto diff = manager.Xor(bdd1, bdd2);
+         const auto false_bdd = manager.GetFalse();
+
+         stream << "not equal. Different results on parameter combination (";
+         for (auto index = 0L; index < param_count; ++index)
+         {
+            if (index != 0)
+            {
+               stream << ", ";
+            }
+
+            auto cofactor = manager.Cofactor(diff, index, false);
+            auto value = LiteralType::False;
+            if (cofactor == false_bdd)
+            {
+               cofactor = manager.Cofactor(diff, index, true);
+               value = LiteralType::True;
+            }
+            diff = cofactor;
+
+            stream << LiteralTypeToString(value);
+         }
+         stream << ").";
+      }
+   }
+
+   return std::make_unique<FunctionOutput>(stream.str());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
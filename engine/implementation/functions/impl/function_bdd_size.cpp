@@ -0,0 +1,60 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../bdd/bdd_builder.h"
+
+#include <sstream>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("bdd_size", 1)
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   assert(params.size() == GetParameterCount());
+   auto variable = CheckAndGetConstVariable(variable_mgr, params[0]);
+
+   BddManager manager(variable->GetParameterCount());
+   const auto bdd = BuildBdd(manager, variable->GetSharedExpression());
+
+   // Automatic reordering is triggered only by large diagrams, so the final
+   // order is improved explicitly.
+   manager.ReorderVariables();
+
+   std::stringstream stream;
+   stream << "BDD of variable '" << variable->GetName() << "' has "
+          << manager.GetNodeCount(bdd) << " nodes. Variable order: (";
+
+   const auto order = manager.GetVariableOrder();
+   for (auto index = 0L; index < (long)order.size(); ++index)
+   {
+      if (index != 0)
+      {
+         stream << ", ";
+      }
+      stream << variable->GetParameter(order[index]).GetName();
+   }
+   stream << ").";
+
+   return std::make_unique<FunctionOutput>(stream.str());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
@@ -0,0 +1,67 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../forms/consensus.h"
+#include "../../forms/normal_forms.h"
+#include "../../common/exception.h"
+
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+// Building of the Blake canonical form stops, when it has more cubes.
+const size_t g_max_blake_cube_count = 65536;
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("blake", 1)
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   assert(params.size() == GetParameterCount());
+
+   auto variable = CheckAndGetVariable(variable_mgr, params[0]);
+   const auto param_count = variable->GetParameterCount();
+
+   // Consensuses are made for cubes of the disjunctive form, the variable is brought to,
+   // if it's in another form.
+   TCubeVector cubes;
+   if (param_count > g_bit_block_size || !GetDnfCubes(variable->GetExpression(), param_count, cubes))
+   {
+      if (param_count > g_max_normal_form_parameter_count)
+      {
+         Error("Function '", GetName(), "' supports variables in disjunctive form or with up to ",
+               g_max_normal_form_parameter_count, " parameters.");
+      }
+
+      cubes = BuildMintermCubes(*variable, true);
+      GlueMintermCubes(cubes, param_count);
+   }
+
+   if (!BuildBlakeCubes(cubes, g_max_blake_cube_count))
+   {
+      Error("Variable '", variable->GetName(), "' has more than ", g_max_blake_cube_count, " prime implicants.");
+   }
+
+   SortCubes(cubes, param_count);
+   variable->SetExpression(BuildDnfExpression(cubes, *variable));
+
+   return std::make_unique<FunctionOutput>(variable->ToString());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
@@ -1,9 +1,13 @@
 #include "../function_base.h"
 #include "../function_registrator.h"
 #include "../../common/combinations.h"
-#include "../../expressions/expression_calculator.h"
+#include "../../common/parallel_utils.h"
+#include "../../variables/variable_calculator.h"
+#include "../../sat/sat_utils.h"
 
 #include <sstream>
+#include <atomic>
+#include <mutex>
 #include <cassert>
 
 namespace dm
@@ -12,6 +16,12 @@ namespace dm
 namespace
 {
 
+// Amount of blocks, that are compared by a worker thread at once.
+const long long g_chunk_size = 1024;
+
+// Variables with more parameters are compared by the SAT solver instead of enumeration.
+const long g_max_enumerated_param_count = 24;
+
 class FunctionImpl : public Function
 {
 public:
@@ -38,44 +48,122 @@ TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStri
    {
       stream << "not equal. Different number of parameters.";
    }
+   else if (variable1->GetParameterCount() > g_max_enumerated_param_count)
+   {
+      std::vector<bool> param_values;
+      if (FindFirstDifferingCombination(variable1->GetSharedExpression(), variable2->GetSharedExpression(),
+                                        variable1->GetParameterCount(), param_values))
+      {
+         stream << "not equal. Different results on parameter combination (";
+         for (auto index = 0L; index < (long)param_values.size(); ++index)
+         {
+            if (index != 0)
+            {
+               stream << ", ";
+            }
+            stream << LiteralTypeToString(param_values[index] ? LiteralType::True : LiteralType::False);
+         }
+         stream << ").";
+      }
+      else
+      {
+         stream << "equal.";
+      }
+   }
    else
    {
       const auto param_count = variable1->GetParameterCount();
 
-      CombinationGenerator generator(param_count);
-      auto param_values = generator.GenerateFirst();
-      while (param_values != nullptr)
+      // Variables must be prepared before parallel calculation.
+      variable1->PrepareCalculation();
+      variable2->PrepareCalculation();
+
+      BitCombinationGenerator generator(param_count);
+      const auto block_mask = generator.GetBlockMask();
+      const auto block_count = generator.GetBlockCount();
+
+      // Index of the first block, where variables differ.
+      std::mutex diff_block_mutex;
+      std::atomic<long long> diff_block(block_count);
+
+      ProcessInParallel(block_count, g_chunk_size, [&](long long from, long long to)
       {
-         const auto result1 = CalculateExpression(variable1->GetExpression(), param_values);
-         const auto result2 = CalculateExpression(variable2->GetExpression(), param_values);
+         // Blocks after the already found one are not interesting.
+         if (from > diff_block)
+         {
+            return false;
+         }
+
+         // Blocks of the chunk are enumerated in Gray code order, so the whole
+         // chunk is checked to find its first differing block.
+         BitCombinationGenerator range_generator(param_count, true);
+         range_generator.SetBlockRange(from, to);
+
+         VariableCalculator calculator1(*variable1);
+         VariableCalculator calculator2(*variable2);
 
-         if (result1 != result2)
+         auto chunk_diff_block = to;
+
+         for (auto param_values = range_generator.GenerateFirst();
+              param_values != nullptr;
+              param_values = range_generator.GenerateNext())
          {
-            stream << "not equal. Different results on parameter combination (";
-            auto is_first = true;
-            for (auto index = 0L; index < param_count; ++index)
+            const auto changed_index = range_generator.GetChangedIndex();
+            const auto result1 = calculator1.Calculate(param_values, changed_index);
+            const auto result2 = calculator2.Calculate(param_values, changed_index);
+
+            if (((result1 ^ result2) & block_mask) != g_bit_block_false &&
+                range_generator.GetBlockIndex() < chunk_diff_block)
             {
-               if (is_first)
-               {
-                  is_first = false;
-               }
-               else
-               {
-                  stream << ", ";
-               }
-               stream << LiteralTypeToString(param_values[index]);
+               chunk_diff_block = range_generator.GetBlockIndex();
             }
-            stream << ").";
-            break;
          }
 
-         param_values = generator.GenerateNext();
-      }
+         if (chunk_diff_block == to)
+         {
+            return true;
+         }
 
-      if (nullptr == param_values)
+         std::lock_guard<std::mutex> lock(diff_block_mutex);
+         if (chunk_diff_block < diff_block)
+         {
+            diff_block = chunk_diff_block;
+         }
+         return false;
+      });
+
+      if (diff_block == block_count)
       {
          stream << "equal.";
       }
+      else
+      {
+         generator.SetBlockRange(diff_block, diff_block + 1);
+         const auto param_values = generator.GenerateFirst();
+
+         const auto result1 = variable1->Calculate(param_values);
+         const auto result2 = variable2->Calculate(param_values);
+
+         // The lowest differing bit corresponds to the first differing combination.
+         const auto diff_bit = FindFirstSetBit((result1 ^ result2) & block_mask);
+         assert(diff_bit != -1);
+
+         stream << "not equal. Different results on parameter combination (";
+         auto is_first = true;
+         for (auto index = 0L; index < param_count; ++index)
+         {
+            if (is_first)
+            {
+               is_first = false;
+            }
+            else
+            {
+               stream << ", ";
+            }
+            stream << LiteralTypeToString(GetBitBlockLiteral(param_values[index], diff_bit));
+         }
+         stream << ").";
+      }
    }
    
    return std::make_unique<FunctionOutput>(stream.str());
@@ -0,0 +1,44 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+
+#include <sstream>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("compile", 1)
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   assert(params.size() == GetParameterCount());
+   auto variable = CheckAndGetVariable(variable_mgr, params[0]);
+
+   // If native code isn't supported on the platform, the interpreted program is used,
+   // so results of calculations and the output don't depend on the platform.
+   variable->CompileNative();
+
+   std::stringstream stream;
+   stream << "Variable '" << variable->GetName() << "' is compiled.";
+
+   return std::make_unique<FunctionOutput>(stream.str());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
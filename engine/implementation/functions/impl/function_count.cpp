@@ -0,0 +1,94 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../common/big_integer.h"
+#include "../../common/combinations.h"
+#include "../../common/parallel_utils.h"
+#include "../../variables/variable_calculator.h"
+#include "../../sat/sat_utils.h"
+
+#include <sstream>
+#include <atomic>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+// Amount of blocks, that are counted by a worker thread at once.
+const long long g_chunk_size = 1024;
+
+// Variables with more parameters are counted by the model counter instead of enumeration.
+const long g_max_enumerated_param_count = 24;
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+
+private:
+   static BigInteger CountByEnumeration(const Variable& variable);
+};
+
+FunctionImpl::FunctionImpl() : Function("count", 1)
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   assert(params.size() == GetParameterCount());
+   auto variable = CheckAndGetConstVariable(variable_mgr, params[0]);
+
+   const auto param_count = variable->GetParameterCount();
+   const auto count = (param_count > g_max_enumerated_param_count) ?
+      CountSatisfyingCombinations(variable->GetSharedExpression(), param_count) :
+      CountByEnumeration(*variable);
+
+   std::stringstream stream;
+   stream << "Variable '" << variable->GetName() << "' is true on " << count.ToString()
+          << " of " << BigInteger(1).ShiftLeft(param_count).ToString() << " parameter combinations.";
+
+   return std::make_unique<FunctionOutput>(stream.str());
+}
+
+BigInteger FunctionImpl::CountByEnumeration(const Variable& variable)
+{
+   // Variable must be prepared before parallel calculation.
+   variable.PrepareCalculation();
+
+   BitCombinationGenerator generator(variable.GetParameterCount());
+   const auto block_mask = generator.GetBlockMask();
+
+   std::atomic<long long> count(0);
+
+   ProcessInParallel(generator.GetBlockCount(), g_chunk_size, [&](long long from, long long to)
+   {
+      BitCombinationGenerator range_generator(variable.GetParameterCount(), true);
+      range_generator.SetBlockRange(from, to);
+
+      VariableCalculator calculator(variable);
+
+      auto chunk_count = 0LL;
+      for (auto param_values = range_generator.GenerateFirst();
+           param_values != nullptr;
+           param_values = range_generator.GenerateNext())
+      {
+         const auto result = calculator.Calculate(param_values, range_generator.GetChangedIndex());
+         chunk_count += CountSetBits(result & block_mask);
+      }
+
+      count += chunk_count;
+      return true;
+   });
+
+   return BigInteger(count);
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
@@ -0,0 +1,51 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../sat/sat_utils.h"
+#include "../../sat/dimacs.h"
+
+#include <sstream>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("dimacs_export", 1)
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   assert(params.size() == GetParameterCount());
+   auto variable = CheckAndGetConstVariable(variable_mgr, params[0]);
+
+   const auto param_count = variable->GetParameterCount();
+   const auto formula = BuildSatisfiabilityCnf(variable->GetSharedExpression(), param_count);
+
+   // Parameters are the first variables of the formula, the rest are auxiliary.
+   std::stringstream stream;
+   stream << "c Satisfiability of variable '" << variable->GetName() << "'.\n";
+   for (auto index = 0L; index < param_count; ++index)
+   {
+      stream << "c Parameter '" << variable->GetParameter(index).GetName() << "' is variable " << index + 1 << ".\n";
+   }
+   WriteDimacs(stream, formula);
+
+   return std::make_unique<FunctionOutput>(stream.str());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
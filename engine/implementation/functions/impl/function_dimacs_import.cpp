@@ -0,0 +1,116 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../sat/dimacs.h"
+#include "../../expressions/expressions.h"
+#include "../../common/exception.h"
+
+#include <string>
+#include <fstream>
+#include <cstdlib>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+
+private:
+   static TExpressionPtr CreateLiteral(const Variable& variable, TCnfLiteral literal);
+   static TExpressionPtr CreateClause(const Variable& variable, const TCnfClause& clause);
+};
+
+FunctionImpl::FunctionImpl() : Function("dimacs_import", 2)
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   assert(params.size() == GetParameterCount());
+   CheckAndGetConstVariable(variable_mgr, params[0], false);
+
+   const std::string file_name = params[1];
+   std::ifstream file(file_name);
+   if (!file.is_open())
+   {
+      Error("Cannot open file '", file_name, "'.");
+   }
+
+   const auto formula = ReadDimacs(file);
+
+   // Variable of the formula with number N becomes parameter xN.
+   auto variable = std::make_unique<Variable>(params[0]);
+   for (auto index = 1L; index <= formula.GetVariableCount(); ++index)
+   {
+      const auto param_name = "x" + std::to_string(index);
+      variable->AddParameter(param_name.c_str());
+   }
+
+   const auto& clauses = formula.GetClauses();
+   TExpressionPtr expression;
+   if (clauses.empty())
+   {
+      expression = std::make_unique<LiteralExpression>(LiteralType::True);
+   }
+   else if (1 == clauses.size())
+   {
+      expression = CreateClause(*variable, clauses[0]);
+   }
+   else
+   {
+      TExpressionPtrVector children;
+      children.reserve(clauses.size());
+      for (const auto& clause : clauses)
+      {
+         children.push_back(CreateClause(*variable, clause));
+      }
+      expression = std::make_unique<OperationExpression>(OperationType::Conjunction, std::move(children));
+   }
+
+   variable->SetExpression(std::move(expression));
+
+   return std::make_unique<FunctionOutput>(variable_mgr.AddVariable(std::move(variable)).ToString());
+}
+
+TExpressionPtr FunctionImpl::CreateLiteral(const Variable& variable, TCnfLiteral literal)
+{
+   TExpressionPtr param = std::make_unique<ParamRefExpression>(variable, std::labs(literal) - 1);
+   if (literal > 0)
+   {
+      return param;
+   }
+   return std::make_unique<OperationExpression>(std::move(param));
+}
+
+TExpressionPtr FunctionImpl::CreateClause(const Variable& variable, const TCnfClause& clause)
+{
+   if (clause.empty())
+   {
+      return std::make_unique<LiteralExpression>(LiteralType::False);
+   }
+   if (1 == clause.size())
+   {
+      return CreateLiteral(variable, clause[0]);
+   }
+
+   TExpressionPtrVector children;
+   children.reserve(clause.size());
+   for (auto literal : clause)
+   {
+      children.push_back(CreateLiteral(variable, literal));
+   }
+   return std::make_unique<OperationExpression>(OperationType::Disjunction, std::move(children));
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
@@ -39,7 +39,9 @@ TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStri
    copy_function->Call(variable_mgr, nested_params);
 #endif
 
-   EvaluateExpression(variable->GetExpression());
+   // Evaluation works with the whole tree, so applications are expanded.
+   variable->ExpandApplications();
+   EvaluateExpression(variable->GetExpression(), *variable);
 
 #ifndef NDEBUG
    auto compare_function = FunctionManager::GetInstance().FindFunction("compare");
@@ -0,0 +1,54 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../expressions/expression_evaluation_cache.h"
+
+#include <sstream>
+#include <limits>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("eval_cache", 1)
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   (void)variable_mgr; // To avoid warning
+   assert(params.size() == GetParameterCount());
+
+   const auto size_limit = CheckAndGetNumber(params[0], 0L, std::numeric_limits<long>::max(), "a non-negative integer");
+
+   // The cache is shared by all variables, zero size limit disables it.
+   EvaluationCache::GetInstance().SetSizeLimit(size_limit);
+
+   std::stringstream stream;
+   if (0 == size_limit)
+   {
+      stream << "Evaluation cache is off.";
+   }
+   else
+   {
+      stream << "Evaluation cache size limit is " << size_limit << ".";
+   }
+
+   return std::make_unique<FunctionOutput>(stream.str());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
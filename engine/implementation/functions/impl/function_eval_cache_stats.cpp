@@ -0,0 +1,45 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../expressions/expression_evaluation_cache.h"
+
+#include <sstream>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("eval_cache_stats", 0)
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   (void)variable_mgr; // To avoid warning
+   (void)params;
+   assert(params.empty());
+
+   const auto& cache = EvaluationCache::GetInstance();
+
+   std::stringstream stream;
+   stream << "Evaluation cache: " << cache.GetSize() << " of " << cache.GetSizeLimit() << " entries, "
+      << cache.GetHitCount() << " hits, " << cache.GetMissCount() << " misses.";
+
+   return std::make_unique<FunctionOutput>(stream.str());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
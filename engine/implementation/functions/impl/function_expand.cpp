@@ -0,0 +1,72 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../forms/expansion.h"
+#include "../../common/exception.h"
+
+#include <limits>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+// Maximal amount of terms, if it isn't given.
+const long g_default_term_budget = 1 << 20;
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("expand")
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   CheckNonEmptyParameters(params);
+   if (params.size() > 2)
+   {
+      Error("Function '", GetName(), "' expects a variable and an optional maximal amount of terms.");
+   }
+
+   auto variable = CheckAndGetVariable(variable_mgr, params[0]);
+
+   auto term_budget = g_default_term_budget;
+   if (params.size() > 1)
+   {
+      term_budget = CheckAndGetNumber(params[1], 1L, std::numeric_limits<long>::max(), "a positive integer");
+   }
+
+   const auto param_count = variable->GetParameterCount();
+   if (param_count > g_bit_block_size)
+   {
+      Error("Function '", GetName(), "' supports variables with up to ", g_bit_block_size, " parameters.");
+   }
+
+   // Brackets are opened in the whole tree, so applications are expanded.
+   variable->ExpandApplications();
+
+   // Expression isn't replaced, if some of intermediate forms doesn't fit into the budget.
+   TCubeVector cubes;
+   if (!ExpandToCubes(variable->GetExpression(), param_count, term_budget, cubes))
+   {
+      Error("Expansion of variable '", variable->GetName(), "' exceeds the budget of ", term_budget, " terms.");
+   }
+
+   SortCubes(cubes, param_count);
+   variable->SetExpression(BuildDnfExpression(cubes, *variable));
+
+   return std::make_unique<FunctionOutput>(variable->ToString());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
@@ -0,0 +1,24 @@
+#include "../function_mode.h"
+#include "../function_registrator.h"
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public ModeFunction
+{
+public:
+   FunctionImpl();
+};
+
+FunctionImpl::FunctionImpl() : ModeFunction("flat_store", "Flat store", &VariableManager::SetFlatStore)
+{
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
@@ -0,0 +1,24 @@
+#include "../function_mode.h"
+#include "../function_registrator.h"
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public ModeFunction
+{
+public:
+   FunctionImpl();
+};
+
+FunctionImpl::FunctionImpl() : ModeFunction("hash_consing", "Hash-consing", &VariableManager::SetHashConsing)
+{
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
@@ -0,0 +1,67 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../forms/two_level_minimizer.h"
+#include "../../common/exception.h"
+
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("mincnf")
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   CheckNonEmptyParameters(params);
+   if (params.size() > 2)
+   {
+      Error("Function '", GetName(), "' expects a variable and an optional variable of don't care combinations.");
+   }
+
+   auto variable = CheckAndGetVariable(variable_mgr, params[0]);
+   auto dc_variable = (params.size() > 1) ? CheckAndGetConstVariable(variable_mgr, params[1]) : nullptr;
+
+   const auto param_count = variable->GetParameterCount();
+   if (param_count > g_max_truth_table_parameter_count)
+   {
+      Error("Function '", GetName(), "' supports variables with up to ",
+            g_max_truth_table_parameter_count, " parameters.");
+   }
+   if (dc_variable != nullptr && dc_variable->GetParameterCount() != param_count)
+   {
+      Error("Variables '", variable->GetName(), "' and '", dc_variable->GetName(),
+            "' must have the same amount of parameters.");
+   }
+
+   // Conjunction is built from the minimal cover of false combinations,
+   // don't care combinations are excluded from them.
+   auto off_set = TruthTable::Build(*variable);
+   auto dc_set = (dc_variable != nullptr) ? TruthTable::Build(*dc_variable) : TruthTable(param_count);
+   off_set.Invert();
+   off_set.Subtract(dc_set);
+
+   // The form is minimal for variables with up to g_max_exact_minimization_parameter_count
+   // parameters, larger variables are minimized heuristically.
+   variable->SetExpression(BuildCnfExpression(MinimizeCover(off_set, dc_set), *variable));
+
+   return std::make_unique<FunctionOutput>(variable->ToString());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
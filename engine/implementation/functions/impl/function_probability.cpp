@@ -0,0 +1,58 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../sat/sat_utils.h"
+#include "../../common/exception.h"
+
+#include <vector>
+#include <sstream>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("probability")
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   CheckNonEmptyParameters(params);
+   auto variable = CheckAndGetConstVariable(variable_mgr, params[0]);
+
+   const auto param_count = variable->GetParameterCount();
+   if ((long)params.size() != param_count + 1)
+   {
+      Error("Function '", GetName(), "' expects probabilities of all ", param_count,
+            " parameters of variable '", variable->GetName(), "'.");
+   }
+
+   std::vector<double> param_probabilities;
+   param_probabilities.reserve(param_count);
+   for (auto index = 1L; index <= param_count; ++index)
+   {
+      param_probabilities.push_back(CheckAndGetNumber(params[index], 0.0, 1.0, "a probability from 0 to 1"));
+   }
+
+   std::stringstream stream;
+   stream << "Variable '" << variable->GetName() << "' is true with probability "
+          << ComputeTruthProbability(variable->GetSharedExpression(), param_probabilities) << ".";
+
+   return std::make_unique<FunctionOutput>(stream.str());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
@@ -0,0 +1,66 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../aig/aig_builder.h"
+#include "../../aig/aig_rewriter.h"
+#include "../../expressions/expression_unique_table.h"
+
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+// Rewriting is repeated, while it reduces the graph, but not more than this amount of times.
+const long g_max_pass_count = 4;
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("rewrite", 1)
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   assert(params.size() == GetParameterCount());
+   auto variable = CheckAndGetVariable(variable_mgr, params[0]);
+
+   const auto param_count = variable->GetParameterCount();
+   auto manager = std::make_unique<AigManager>(param_count);
+   auto root = BuildAig(*manager, variable->GetSharedExpression());
+   auto and_count = manager->GetAndCount(root);
+
+   // Each pass builds a new graph, so it doesn't contain replaced nodes of the previous one.
+   for (auto pass = 0L; pass < g_max_pass_count; ++pass)
+   {
+      auto rewritten_manager = std::make_unique<AigManager>(param_count);
+      const auto rewritten_root = RewriteAig(*manager, root, *rewritten_manager);
+      const auto rewritten_and_count = rewritten_manager->GetAndCount(rewritten_root);
+      if (rewritten_and_count >= and_count)
+      {
+         break;
+      }
+
+      manager = std::move(rewritten_manager);
+      root = rewritten_root;
+      and_count = rewritten_and_count;
+   }
+
+   // Operations of the graph are binary, so operands with the same operation are merged.
+   variable->SetSharedExpression(NormalizeUniqueExpression(BuildAigExpression(*manager, root)));
+
+   return std::make_unique<FunctionOutput>(variable->ToString());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
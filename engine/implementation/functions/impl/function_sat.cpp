@@ -0,0 +1,60 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../sat/sat_utils.h"
+
+#include <sstream>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("sat", 1)
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   assert(params.size() == GetParameterCount());
+   auto variable = CheckAndGetConstVariable(variable_mgr, params[0]);
+
+   std::stringstream stream;
+   stream << "Variable '" << variable->GetName() << "' is ";
+
+   std::vector<bool> param_values;
+   if (FindFirstSatisfyingCombination(variable->GetSharedExpression(), variable->GetParameterCount(), param_values))
+   {
+      stream << "satisfiable. It is true on parameter combination (";
+      for (auto index = 0L; index < (long)param_values.size(); ++index)
+      {
+         if (index != 0)
+         {
+            stream << ", ";
+         }
+         stream << LiteralTypeToString(param_values[index] ? LiteralType::True : LiteralType::False);
+      }
+      stream << ").";
+   }
+   else
+   {
+      stream << "not satisfiable.";
+   }
+
+   return std::make_unique<FunctionOutput>(stream.str());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
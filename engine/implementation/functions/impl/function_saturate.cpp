@@ -0,0 +1,90 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../egraph/egraph_saturation.h"
+#include "../../common/exception.h"
+
+#include <limits>
+#include <sstream>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+// Maximal amount of nodes of the graph, if it isn't given.
+const long g_default_max_node_count = 10000;
+const long g_max_iteration_count = 30;
+const long g_max_milliseconds = 2000;
+
+const char* SaturationResultToString(SaturationResult result)
+{
+   switch (result)
+   {
+      case SaturationResult::Saturated:
+         return "is saturated";
+      case SaturationResult::NodeLimit:
+         return "reached the limit of nodes";
+      case SaturationResult::IterationLimit:
+         return "reached the limit of iterations";
+      case SaturationResult::TimeLimit:
+         return "reached the limit of time";
+      default:
+         assert(!"Unknown saturation result");
+         return "";
+   }
+}
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("saturate")
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   CheckNonEmptyParameters(params);
+   if (params.size() > 2)
+   {
+      Error("Function '", GetName(), "' expects a variable and an optional maximal amount of nodes.");
+   }
+
+   auto variable = CheckAndGetVariable(variable_mgr, params[0]);
+
+   auto max_node_count = g_default_max_node_count;
+   if (params.size() > 1)
+   {
+      max_node_count = CheckAndGetNumber(params[1], 1L, std::numeric_limits<long>::max(), "a positive integer");
+   }
+
+   EGraph egraph;
+   const auto root = AddExpression(egraph, variable->GetSharedExpression());
+   const auto stats = SaturateEGraph(egraph,
+      SaturationLimits{ max_node_count, g_max_iteration_count, g_max_milliseconds });
+
+   // Even if a limit is reached, the graph contains the original expression, so the extracted one isn't larger.
+   variable->SetSharedExpression(ExtractExpression(egraph, root));
+
+   std::stringstream stream;
+   stream << "E-graph of variable '" << variable->GetName() << "' " << SaturationResultToString(stats.result)
+          << " after " << stats.iteration_count << " iterations with " << egraph.GetClassCount()
+          << " e-classes and " << egraph.GetNodeCount() << " e-nodes.";
+
+   auto output = std::make_unique<FunctionOutput>();
+   output->AddLine(variable->ToString());
+   output->AddLine(stream.str());
+   return output;
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
@@ -0,0 +1,49 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../forms/normal_forms.h"
+#include "../../common/exception.h"
+
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("scnf", 1)
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   assert(params.size() == GetParameterCount());
+
+   auto variable = CheckAndGetVariable(variable_mgr, params[0]);
+
+   const auto param_count = variable->GetParameterCount();
+   if (param_count > g_max_normal_form_parameter_count)
+   {
+      Error("Function '", GetName(), "' supports variables with up to ",
+            g_max_normal_form_parameter_count, " parameters.");
+   }
+
+   const auto cubes = BuildMintermCubes(*variable, false);
+   variable->SetExpression(BuildCnfExpression(cubes, *variable));
+
+   return std::make_unique<FunctionOutput>(variable->ToString());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
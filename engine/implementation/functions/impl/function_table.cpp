@@ -1,9 +1,11 @@
 #include "../function_base.h"
 #include "../function_registrator.h"
 #include "../../common/combinations.h"
-#include "../../expressions/expression_calculator.h"
+#include "../../common/parallel_utils.h"
+#include "../../variables/variable_calculator.h"
 
 #include <string>
+#include <vector>
 #include <sstream>
 #include <iomanip>
 #include <cassert>
@@ -18,6 +20,9 @@ const char g_char_vert_line = '|';
 const char g_char_horz_line = '-';
 const char g_char_filler    = ' ';
 
+// Amount of blocks, that are put into rows by a worker thread at once.
+const long long g_chunk_size = 16;
+
 std::string ConstructHeader(const Variable* variable)
 {
    assert(variable != nullptr);
@@ -43,7 +48,7 @@ std::string ConstructHeader(const Variable* variable)
    return header;
 }
 
-std::string ConstructRow(const Variable* variable, const LiteralType param_values[], LiteralType result)
+std::string ConstructRow(const Variable* variable, const TBitBlock param_values[], long bit, TBitBlock result)
 {
    assert(variable != nullptr);
    const auto declaration = variable->VariableDeclaration::ToString();
@@ -56,14 +61,14 @@ std::string ConstructRow(const Variable* variable, const LiteralType param_value
       row << g_char_vert_line;
       row << g_char_filler;
       row << std::setw(variable->GetParameter(index).GetName().size()) 
-          << LiteralTypeToString(param_values[index]);
+          << LiteralTypeToString(GetBitBlockLiteral(param_values[index], bit));
       row << g_char_filler;
    }
 
    row << g_char_vert_line;
    row << g_char_vert_line;
    row << g_char_filler;
-   row << std::setw(declaration.size()) << LiteralTypeToString(result);
+   row << std::setw(declaration.size()) << LiteralTypeToString(GetBitBlockLiteral(result, bit));
    row << g_char_filler;
    row << g_char_vert_line;
 
@@ -97,14 +102,62 @@ TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStri
    output->AddLine(header);
    output->AddLine(horizontal_line);
 
-   CombinationGenerator generator(variable->GetParameterCount());
+   // Variable must be prepared before parallel calculation.
+   variable->PrepareCalculation();
+
+   BitCombinationGenerator generator(variable->GetParameterCount());
+   const auto block_combination_count = generator.GetBlockCombinationCount();
+   const auto block_count = generator.GetBlockCount();
 
-   for (auto param_values = generator.GenerateFirst();
-        param_values != nullptr;
-        param_values = generator.GenerateNext())
+   // Rows are constructed by worker threads chunk by chunk
+   // and then are added to the output in order of chunks.
+   std::vector<std::string> chunk_rows((block_count + g_chunk_size - 1) / g_chunk_size);
+
+   ProcessInParallel(block_count, g_chunk_size, [&](long long from, long long to)
+   {
+      auto& rows = chunk_rows[from / g_chunk_size];
+
+      // Results are calculated in Gray code order of blocks, while rows
+      // are constructed in the ordinary one.
+      std::vector<TBitBlock> results(to - from);
+
+      BitCombinationGenerator gray_code_generator(variable->GetParameterCount(), true);
+      gray_code_generator.SetBlockRange(from, to);
+
+      VariableCalculator calculator(*variable);
+
+      for (auto param_values = gray_code_generator.GenerateFirst();
+           param_values != nullptr;
+           param_values = gray_code_generator.GenerateNext())
+      {
+         results[gray_code_generator.GetBlockIndex() - from] =
+            calculator.Calculate(param_values, gray_code_generator.GetChangedIndex());
+      }
+
+      BitCombinationGenerator range_generator(variable->GetParameterCount());
+      range_generator.SetBlockRange(from, to);
+
+      for (auto param_values = range_generator.GenerateFirst();
+           param_values != nullptr;
+           param_values = range_generator.GenerateNext())
+      {
+         const auto result = results[range_generator.GetBlockIndex() - from];
+         for (auto bit = 0L; bit < block_combination_count; ++bit)
+         {
+            if (!rows.empty())
+            {
+               rows += '\n';
+            }
+            rows += ConstructRow(variable, param_values, bit, result);
+         }
+      }
+
+      return true;
+   });
+
+   for (const auto& rows : chunk_rows)
    {
-      const auto result = CalculateExpression(variable->GetExpression(), param_values);
-      output->AddLine(ConstructRow(variable, param_values, result));
+      output->AddLine(rows);
    }
 
    output->AddLine(horizontal_line);
@@ -0,0 +1,60 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../sat/sat_utils.h"
+
+#include <sstream>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("taut", 1)
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   assert(params.size() == GetParameterCount());
+   auto variable = CheckAndGetConstVariable(variable_mgr, params[0]);
+
+   std::stringstream stream;
+   stream << "Variable '" << variable->GetName() << "' is ";
+
+   std::vector<bool> param_values;
+   if (FindFirstFalsifyingCombination(variable->GetSharedExpression(), variable->GetParameterCount(), param_values))
+   {
+      stream << "not a tautology. It is false on parameter combination (";
+      for (auto index = 0L; index < (long)param_values.size(); ++index)
+      {
+         if (index != 0)
+         {
+            stream << ", ";
+         }
+         stream << LiteralTypeToString(param_values[index] ? LiteralType::True : LiteralType::False);
+      }
+      stream << ").";
+   }
+   else
+   {
+      stream << "a tautology.";
+   }
+
+   return std::make_unique<FunctionOutput>(stream.str());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
@@ -0,0 +1,68 @@
+#include "../function_base.h"
+#include "../function_registrator.h"
+#include "../../forms/truth_table.h"
+#include "../../common/exception.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+class FunctionImpl : public Function
+{
+public:
+   FunctionImpl();
+
+   virtual TFunctionOutputPtr Call(VariableManager& viriable_mgr, const TStringPtrLenVector& params) override;
+};
+
+FunctionImpl::FunctionImpl() : Function("zhegalkin", 1)
+{
+}
+
+TFunctionOutputPtr FunctionImpl::Call(VariableManager& variable_mgr, const TStringPtrLenVector& params)
+{
+   assert(params.size() == GetParameterCount());
+
+   auto variable = CheckAndGetVariable(variable_mgr, params[0]);
+
+   const auto param_count = variable->GetParameterCount();
+   if (param_count > g_max_truth_table_parameter_count)
+   {
+      Error("Function '", GetName(), "' supports variables with up to ",
+            g_max_truth_table_parameter_count, " parameters.");
+   }
+
+   auto coefficients = TruthTable::Build(*variable);
+   coefficients.ApplyMobiusTransform();
+
+   // Monomial of the combination consists of parameters, which are set in it.
+   TCubeVector monomials;
+   coefficients.ForEachTrueCombination(Cube{ 0, 0 }, [&monomials](long long combination)
+   {
+      const auto mask = static_cast<TBitBlock>(combination);
+      monomials.push_back(Cube{ mask, mask });
+   });
+
+   // Monomials go by degree, and then in order of parameters.
+   std::sort(monomials.begin(), monomials.end(), [](const Cube& left, const Cube& right)
+   {
+      const auto left_degree = CountSetBits(left.mask);
+      const auto right_degree = CountSetBits(right.mask);
+      return (left_degree != right_degree) ? (left_degree < right_degree) : (left.mask > right.mask);
+   });
+
+   variable->SetExpression(BuildZhegalkinExpression(monomials, *variable));
+
+   return std::make_unique<FunctionOutput>(variable->ToString());
+}
+
+} // namespace
+
+REGISTER_FUNCTION(FunctionImpl);
+
+} // namespace dm
@@ -0,0 +1,231 @@
+#include "cnf_encoder.h"
+
+#include <cassert>
+
+namespace dm
+{
+
+CnfEncoder::CnfEncoder(CnfFormula& formula, long param_count) :
+   m_formula(formula), m_operations(), m_true_literal(0)
+{
+   assert(0 == m_formula.GetVariableCount());
+
+   for (auto index = 0L; index < param_count; ++index)
+   {
+      m_formula.AddVariable();
+   }
+}
+
+TCnfLiteral CnfEncoder::GetParamLiteral(long param_index)
+{
+   return param_index + 1;
+}
+
+TCnfLiteral CnfEncoder::Encode(const TUniqueExpressionPtr& expr, int polarity)
+{
+   assert(expr.get() != nullptr);
+   assert(0 != (polarity & Both));
+
+   switch (expr->GetType())
+   {
+      case ExpressionType::Literal:
+      {
+         const auto literal = GetTrueLiteral();
+         return LiteralType::True == expr->GetLiteral() ? literal : -literal;
+      }
+
+      case ExpressionType::ParamRef:
+      {
+         const auto param_index = expr->GetParamIndex();
+         assert(param_index < m_formula.GetVariableCount());
+         return GetParamLiteral(param_index);
+      }
+
+      case ExpressionType::Operation:
+      {
+         const auto& expression = *expr;
+         if (OperationType::Negation == expression.GetOperation())
+         {
+            return -Encode(expression.GetChild(0), FlipPolarity(polarity));
+         }
+
+         // Already encoded operation needs clauses only for missing directions.
+         auto iter = m_operations.find(expr.get());
+         if (iter == m_operations.end())
+         {
+            iter = m_operations.emplace(expr.get(), EncodedOperation{ m_formula.AddVariable(), 0 }).first;
+         }
+
+         const auto literal = iter->second.literal;
+         const auto missing_polarity = polarity & ~iter->second.polarity;
+         if (0 != missing_polarity)
+         {
+            iter->second.polarity |= missing_polarity;
+            EncodeOperation(expression, literal, missing_polarity);
+         }
+         return literal;
+      }
+
+      default:
+         assert(!"Unknown expression type");
+         return 0;
+   }
+}
+
+void CnfEncoder::EncodeOperation(const UniqueExpression& expression, TCnfLiteral output, int polarity)
+{
+   const auto operation = expression.GetOperation();
+   const auto child_count = expression.GetChildCount();
+   assert(child_count > 1);
+
+   switch (operation)
+   {
+      case OperationType::Conjunction:
+      case OperationType::Disjunction:
+      {
+         TCnfClause inputs;
+         inputs.reserve(child_count);
+         for (auto index = 0L; index < child_count; ++index)
+         {
+            inputs.push_back(Encode(expression.GetChild(index), polarity));
+         }
+         AddGate(operation, inputs, output, polarity);
+         break;
+      }
+
+      case OperationType::Implication:
+      {
+         // ((a -> b) -> c) is encoded as a chain of disjunctions !prefix | operand.
+         // The prefix is negated once per each following operand, so its polarity alternates.
+         const auto last_index = child_count - 1;
+
+         auto prefix_polarity = polarity;
+         for (auto index = 1L; index < child_count; ++index)
+         {
+            prefix_polarity = FlipPolarity(prefix_polarity);
+         }
+
+         auto prefix = Encode(expression.GetChild(0), prefix_polarity);
+         for (auto index = 1L; index < child_count; ++index)
+         {
+            // Operand has the same polarity as the result of its step.
+            const auto step_polarity = FlipPolarity(prefix_polarity);
+            const auto operand = Encode(expression.GetChild(index), step_polarity);
+            const auto step_output = (index == last_index) ? output : m_formula.AddVariable();
+
+            AddGate(OperationType::Disjunction, { -prefix, operand }, step_output, step_polarity);
+
+            prefix = step_output;
+            prefix_polarity = step_polarity;
+         }
+         break;
+      }
+
+      case OperationType::Equality:
+      case OperationType::Plus:
+      {
+         // Equality chain is the inverted parity when amount of operations is odd.
+         const auto is_inverted = (OperationType::Equality == operation && 0 == (child_count & 1));
+         const auto last_index = child_count - 1;
+
+         auto prefix = Encode(expression.GetChild(0), Both);
+         for (auto index = 1L; index < child_count; ++index)
+         {
+            const auto operand = Encode(expression.GetChild(index), Both);
+            if (index == last_index)
+            {
+               AddGate(OperationType::Plus, { prefix, operand },
+                       is_inverted ? -output : output,
+                       is_inverted ? FlipPolarity(polarity) : polarity);
+            }
+            else
+            {
+               const auto step_output = m_formula.AddVariable();
+               AddGate(OperationType::Plus, { prefix, operand }, step_output, Both);
+               prefix = step_output;
+            }
+         }
+         break;
+      }
+
+      default:
+         assert(!"Unknown operation type");
+   }
+}
+
+void CnfEncoder::AddGate(OperationType operation, const TCnfClause& inputs, TCnfLiteral output, int polarity)
+{
+   switch (operation)
+   {
+      case OperationType::Conjunction:
+      case OperationType::Disjunction:
+      {
+         // Conjunction is a disjunction with inverted inputs and output.
+         const auto sign = (OperationType::Conjunction == operation) ? -1 : 1;
+         const auto direct_polarity = (OperationType::Conjunction == operation) ? Negative : Positive;
+         const auto single_polarity = (OperationType::Conjunction == operation) ? Positive : Negative;
+
+         if (0 != (polarity & direct_polarity))
+         {
+            // output -> (input1 | input2 | ...)
+            TCnfClause clause;
+            clause.reserve(inputs.size() + 1);
+            clause.push_back(-sign * output);
+            for (auto input : inputs)
+            {
+               clause.push_back(sign * input);
+            }
+            m_formula.AddClause(std::move(clause));
+         }
+
+         if (0 != (polarity & single_polarity))
+         {
+            // inputN -> output
+            for (auto input : inputs)
+            {
+               m_formula.AddClause({ sign * output, -sign * input });
+            }
+         }
+         break;
+      }
+
+      case OperationType::Plus:
+      {
+         assert(2 == inputs.size());
+         const auto input1 = inputs[0];
+         const auto input2 = inputs[1];
+
+         if (0 != (polarity & Positive))
+         {
+            m_formula.AddClause({ -output, input1, input2 });
+            m_formula.AddClause({ -output, -input1, -input2 });
+         }
+         if (0 != (polarity & Negative))
+         {
+            m_formula.AddClause({ output, -input1, input2 });
+            m_formula.AddClause({ output, input1, -input2 });
+         }
+         break;
+      }
+
+      default:
+         assert(!"Unsupported gate operation");
+   }
+}
+
+TCnfLiteral CnfEncoder::GetTrueLiteral()
+{
+   if (0 == m_true_literal)
+   {
+      m_true_literal = m_formula.AddVariable();
+      m_formula.AddClause({ m_true_literal });
+   }
+   return m_true_literal;
+}
+
+int CnfEncoder::FlipPolarity(int polarity)
+{
+   return ((polarity & Positive) ? Negative : 0) | ((polarity & Negative) ? Positive : 0);
+}
+
+} // namespace dm
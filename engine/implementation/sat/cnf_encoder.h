@@ -0,0 +1,56 @@
+#pragma once
+
+#include "cnf_formula.h"
+#include "../expressions/expression_unique_table.h"
+#include "../common/operations.h"
+#include "../common/noncopyable.h"
+
+#include <unordered_map>
+
+namespace dm
+{
+
+// Plaisted-Greenbaum encoding of hash-consed expressions into CNF. Each distinct operation gets
+// an auxiliary variable, but only implications in directions, required by
+// the polarity of the operation occurrence, are added as clauses. Polarity
+// is a mask, since operands of parity operations are required in both.
+class CnfEncoder : public NonCopyable
+{
+public:
+   enum Polarity
+   {
+      Positive = 1,   // literal -> expression
+      Negative = 2,   // expression -> literal
+      Both = Positive | Negative
+   };
+
+   // Variables 1..param_count of the formula represent parameters.
+   CnfEncoder(CnfFormula& formula, long param_count);
+
+   static TCnfLiteral GetParamLiteral(long param_index);
+
+   // Returns the literal, that is connected with the expression in the required polarity.
+   TCnfLiteral Encode(const TUniqueExpressionPtr& expr, int polarity);
+
+private:
+   struct EncodedOperation
+   {
+      TCnfLiteral literal;
+      int polarity;
+   };
+
+   void EncodeOperation(const UniqueExpression& expression, TCnfLiteral output, int polarity);
+   // Adds clauses of the gate output = operation(inputs) for 2-input parity or any-input
+   // conjunction and disjunction.
+   void AddGate(OperationType operation, const TCnfClause& inputs, TCnfLiteral output, int polarity);
+   TCnfLiteral GetTrueLiteral();
+
+   static int FlipPolarity(int polarity);
+
+private:
+   CnfFormula& m_formula;
+   std::unordered_map<const UniqueExpression*, EncodedOperation> m_operations;
+   TCnfLiteral m_true_literal;
+};
+
+} // namespace dm
@@ -0,0 +1,40 @@
+#include "cnf_formula.h"
+
+#include <cstdlib>
+#include <cassert>
+
+namespace dm
+{
+
+CnfFormula::CnfFormula() : m_variable_count(0), m_clauses()
+{
+}
+
+TCnfLiteral CnfFormula::AddVariable()
+{
+   return ++m_variable_count;
+}
+
+void CnfFormula::AddClause(TCnfClause&& clause)
+{
+#ifndef NDEBUG
+   for (auto literal : clause)
+   {
+      assert(literal != 0 && std::labs(literal) <= m_variable_count);
+   }
+#endif
+
+   m_clauses.push_back(std::move(clause));
+}
+
+long CnfFormula::GetVariableCount() const
+{
+   return m_variable_count;
+}
+
+const TCnfClauseVector& CnfFormula::GetClauses() const
+{
+   return m_clauses;
+}
+
+} // namespace dm
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+
+namespace dm
+{
+
+// Literal in DIMACS notation: variable number starting from 1, negative for negated variable.
+using TCnfLiteral = long;
+using TCnfClause = std::vector<TCnfLiteral>;
+using TCnfClauseVector = std::vector<TCnfClause>;
+
+class CnfFormula
+{
+public:
+   CnfFormula();
+
+   // Returns the positive literal of the new variable.
+   TCnfLiteral AddVariable();
+   void AddClause(TCnfClause&& clause);
+
+   long GetVariableCount() const;
+   const TCnfClauseVector& GetClauses() const;
+
+private:
+   long m_variable_count;
+   TCnfClauseVector m_clauses;
+};
+
+} // namespace dm
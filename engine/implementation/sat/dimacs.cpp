@@ -0,0 +1,108 @@
+#include "dimacs.h"
+#include "../common/exception.h"
+
+#include <string>
+#include <sstream>
+#include <cstdlib>
+
+namespace dm
+{
+
+void WriteDimacs(std::ostream& stream, const CnfFormula& formula)
+{
+   stream << "p cnf " << formula.GetVariableCount() << " " << formula.GetClauses().size();
+   for (const auto& clause : formula.GetClauses())
+   {
+      stream << "\n";
+      for (auto literal : clause)
+      {
+         stream << literal << " ";
+      }
+      stream << "0";
+   }
+}
+
+CnfFormula ReadDimacs(std::istream& stream)
+{
+   CnfFormula formula;
+   auto variable_count = -1L;
+   auto clause_count = -1L;
+
+   TCnfClause clause;
+   std::string line;
+   while (std::getline(stream, line))
+   {
+      std::istringstream line_stream(line);
+      std::string token;
+      if (!(line_stream >> token) || token[0] == 'c')
+      {
+         continue;
+      }
+
+      // Some benchmark files end with the '%' line.
+      if (token == "%")
+      {
+         break;
+      }
+
+      if (token == "p")
+      {
+         std::string format;
+         if (variable_count != -1 ||
+             !(line_stream >> format >> variable_count >> clause_count) ||
+             format != "cnf" || variable_count < 0 || clause_count < 0)
+         {
+            Error("Invalid DIMACS problem line '", line, "'.");
+         }
+
+         for (auto index = 0L; index < variable_count; ++index)
+         {
+            formula.AddVariable();
+         }
+         continue;
+      }
+
+      if (-1 == variable_count)
+      {
+         Error("DIMACS problem line is missing.");
+      }
+
+      do
+      {
+         char* end = nullptr;
+         const auto literal = std::strtol(token.c_str(), &end, 10);
+         if (*end != '\0' || std::labs(literal) > variable_count)
+         {
+            Error("Invalid DIMACS literal '", token, "'.");
+         }
+
+         if (0 == literal)
+         {
+            formula.AddClause(std::move(clause));
+            clause = TCnfClause();
+         }
+         else
+         {
+            clause.push_back(literal);
+         }
+      }
+      while (line_stream >> token);
+   }
+
+   if (-1 == variable_count)
+   {
+      Error("DIMACS problem line is missing.");
+   }
+   if (!clause.empty())
+   {
+      Error("The last DIMACS clause is not terminated by 0.");
+   }
+   if (clause_count != (long)formula.GetClauses().size())
+   {
+      Error("DIMACS problem declares ", clause_count, " clauses, but ", formula.GetClauses().size(), " are found.");
+   }
+
+   return formula;
+}
+
+} // namespace dm
@@ -0,0 +1,15 @@
+#pragma once
+
+#include "cnf_formula.h"
+
+#include <istream>
+#include <ostream>
+
+namespace dm
+{
+
+void WriteDimacs(std::ostream& stream, const CnfFormula& formula);
+// Throws exception if the stream doesn't contain a valid DIMACS CNF problem.
+CnfFormula ReadDimacs(std::istream& stream);
+
+} // namespace dm
@@ -0,0 +1,407 @@
+#include "model_counter.h"
+#include "../common/big_integer.h"
+
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+// Cache is cleared when its estimated memory in bytes grows over this limit,
+// so the memory doesn't depend on the size of components.
+const std::size_t g_max_cache_memory_size = 1 << 26;
+// Estimated memory of an entry of the cache except its key.
+const std::size_t g_cache_entry_memory_size = 64;
+
+// Separates clauses and variables in keys of components.
+const std::uint32_t g_component_key_separator = ~std::uint32_t(0);
+
+bool IsZero(const BigInteger& value)
+{
+   return value.IsZero();
+}
+
+bool IsZero(double value)
+{
+   return 0.0 == value;
+}
+
+} // namespace
+
+template <typename TValue>
+std::size_t ModelCounter<TValue>::ComponentKeyHash::operator()(const TComponentKey& key) const
+{
+   std::size_t hash = key.size();
+   for (auto element : key)
+   {
+      hash ^= std::hash<std::uint32_t>()(element) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+   }
+   return hash;
+}
+
+template <typename TValue>
+ModelCounter<TValue>::ModelCounter(
+   const CnfFormula& formula, long decision_variable_count,
+   std::vector<TValue> true_weights, std::vector<TValue> false_weights) :
+   m_variable_count(formula.GetVariableCount()),
+   m_decision_variable_count(decision_variable_count),
+   m_clauses(formula.GetClauses()),
+   m_occurrences(m_variable_count + 1),
+   m_true_weights(std::move(true_weights)),
+   m_false_weights(std::move(false_weights)),
+   m_values(m_variable_count + 1, -1),
+   m_trail(),
+   m_clause_marks(m_clauses.size(), 0),
+   m_variable_marks(m_variable_count + 1, 0),
+   m_mark(0),
+   m_scores(m_variable_count + 1, 0),
+   m_cache(),
+   m_cache_memory_size(0)
+{
+   assert(m_decision_variable_count >= 0 && m_decision_variable_count <= m_variable_count);
+   assert(m_true_weights.size() == static_cast<std::size_t>(m_variable_count));
+   assert(m_false_weights.size() == static_cast<std::size_t>(m_variable_count));
+
+   for (auto index = 0L; index < (long)m_clauses.size(); ++index)
+   {
+      auto& clause = m_clauses[index];
+
+      // Repeated literals don't change the clause.
+      std::sort(clause.begin(), clause.end());
+      clause.erase(std::unique(clause.begin(), clause.end()), clause.end());
+
+      for (auto literal : clause)
+      {
+         auto& occurrences = m_occurrences[std::labs(literal)];
+         if (occurrences.empty() || occurrences.back() != index)
+         {
+            occurrences.push_back(index);
+         }
+      }
+   }
+}
+
+template <typename TValue>
+TValue ModelCounter<TValue>::Count()
+{
+   assert(m_trail.empty());
+
+   auto is_consistent = true;
+   for (const auto& clause : m_clauses)
+   {
+      if (clause.empty())
+      {
+         is_consistent = false;
+      }
+      else if (1 == clause.size() && -1 == GetValue(clause[0]))
+      {
+         m_values[std::labs(clause[0])] = (clause[0] > 0) ? 1 : 0;
+         m_trail.push_back(clause[0]);
+      }
+      else if (1 == clause.size() && 0 == GetValue(clause[0]))
+      {
+         is_consistent = false;
+      }
+   }
+
+   TValue result(0);
+   if (is_consistent && Propagate(0))
+   {
+      std::vector<long> clauses(m_clauses.size());
+      for (auto index = 0L; index < (long)clauses.size(); ++index)
+      {
+         clauses[index] = index;
+      }
+
+      std::vector<long> variables(m_variable_count);
+      for (auto index = 0L; index < m_variable_count; ++index)
+      {
+         variables[index] = index + 1;
+      }
+
+      result = GetTrailWeight(0) * CountResidual(clauses, variables);
+   }
+
+   Undo(0);
+   m_cache.clear();
+   m_cache_memory_size = 0;
+   return result;
+}
+
+template <typename TValue>
+int ModelCounter<TValue>::GetValue(TCnfLiteral literal) const
+{
+   const auto value = m_values[std::labs(literal)];
+   if (value < 0)
+   {
+      return -1;
+   }
+   return (literal > 0) ? value : 1 - value;
+}
+
+template <typename TValue>
+bool ModelCounter<TValue>::IsSatisfied(long clause) const
+{
+   for (auto literal : m_clauses[clause])
+   {
+      if (1 == GetValue(literal))
+      {
+         return true;
+      }
+   }
+   return false;
+}
+
+template <typename TValue>
+bool ModelCounter<TValue>::Assign(TCnfLiteral literal)
+{
+   assert(-1 == GetValue(literal));
+
+   const auto trail_head = m_trail.size();
+   m_values[std::labs(literal)] = (literal > 0) ? 1 : 0;
+   m_trail.push_back(literal);
+   return Propagate(trail_head);
+}
+
+template <typename TValue>
+bool ModelCounter<TValue>::Propagate(std::size_t trail_head)
+{
+   for (; trail_head < m_trail.size(); ++trail_head)
+   {
+      const auto assigned = m_trail[trail_head];
+      for (auto clause : m_occurrences[std::labs(assigned)])
+      {
+         auto unassigned = 0L;
+         auto unit = TCnfLiteral(0);
+         auto is_satisfied = false;
+
+         for (auto literal : m_clauses[clause])
+         {
+            const auto value = GetValue(literal);
+            if (1 == value)
+            {
+               is_satisfied = true;
+               break;
+            }
+            if (-1 == value)
+            {
+               ++unassigned;
+               unit = literal;
+            }
+         }
+
+         if (is_satisfied || unassigned > 1)
+         {
+            continue;
+         }
+         if (0 == unassigned)
+         {
+            return false;
+         }
+
+         m_values[std::labs(unit)] = (unit > 0) ? 1 : 0;
+         m_trail.push_back(unit);
+      }
+   }
+   return true;
+}
+
+template <typename TValue>
+void ModelCounter<TValue>::Undo(std::size_t trail_size)
+{
+   while (m_trail.size() > trail_size)
+   {
+      m_values[std::labs(m_trail.back())] = -1;
+      m_trail.pop_back();
+   }
+}
+
+template <typename TValue>
+TValue ModelCounter<TValue>::GetTrailWeight(std::size_t trail_size) const
+{
+   TValue weight(1);
+   for (auto index = trail_size; index < m_trail.size(); ++index)
+   {
+      const auto literal = m_trail[index];
+      weight *= (literal > 0) ? m_true_weights[literal - 1] : m_false_weights[-literal - 1];
+   }
+   return weight;
+}
+
+template <typename TValue>
+TValue ModelCounter<TValue>::CountResidual(const std::vector<long>& clauses, const std::vector<long>& variables)
+{
+   const auto candidate_mark = ++m_mark;
+   for (auto clause : clauses)
+   {
+      if (!IsSatisfied(clause))
+      {
+         m_clause_marks[clause] = candidate_mark;
+      }
+   }
+
+   // Clauses are connected when they share an unassigned variable.
+   const auto component_mark = ++m_mark;
+   std::vector<Component> components;
+   for (auto first_clause : clauses)
+   {
+      if (m_clause_marks[first_clause] != candidate_mark)
+      {
+         continue;
+      }
+
+      components.emplace_back();
+      auto& component = components.back();
+
+      m_clause_marks[first_clause] = component_mark;
+      component.clauses.push_back(first_clause);
+      for (auto index = 0U; index < component.clauses.size(); ++index)
+      {
+         for (auto literal : m_clauses[component.clauses[index]])
+         {
+            const auto variable = std::labs(literal);
+            if (m_values[variable] >= 0 || m_variable_marks[variable] == component_mark)
+            {
+               continue;
+            }
+
+            m_variable_marks[variable] = component_mark;
+            component.variables.push_back(variable);
+            for (auto clause : m_occurrences[variable])
+            {
+               if (m_clause_marks[clause] == candidate_mark)
+               {
+                  m_clause_marks[clause] = component_mark;
+                  component.clauses.push_back(clause);
+               }
+            }
+         }
+      }
+   }
+
+   // Variables out of components may have any value.
+   TValue result(1);
+   for (auto variable : variables)
+   {
+      if (m_values[variable] < 0 && m_variable_marks[variable] != component_mark)
+      {
+         result *= m_true_weights[variable - 1] + m_false_weights[variable - 1];
+      }
+   }
+
+   for (auto& component : components)
+   {
+      if (IsZero(result))
+      {
+         break;
+      }
+      result *= CountComponent(component);
+   }
+
+   return result;
+}
+
+template <typename TValue>
+TValue ModelCounter<TValue>::CountComponent(Component& component)
+{
+   std::sort(component.clauses.begin(), component.clauses.end());
+
+   auto key = GetComponentKey(component);
+   const auto iter = m_cache.find(key);
+   if (iter != m_cache.end())
+   {
+      return iter->second;
+   }
+
+   const auto variable = PickBranchVariable(component);
+
+   TValue result(0);
+   for (auto literal : { variable, -variable })
+   {
+      const auto trail_size = m_trail.size();
+      if (Assign(literal))
+      {
+         result += GetTrailWeight(trail_size) * CountResidual(component.clauses, component.variables);
+      }
+      Undo(trail_size);
+   }
+
+   const auto memory_size = key.size() * sizeof(std::uint32_t) + g_cache_entry_memory_size;
+   if (m_cache_memory_size + memory_size > g_max_cache_memory_size)
+   {
+      m_cache.clear();
+      m_cache_memory_size = 0;
+   }
+   m_cache_memory_size += memory_size;
+   m_cache.emplace(std::move(key), result);
+
+   return result;
+}
+
+template <typename TValue>
+typename ModelCounter<TValue>::TComponentKey ModelCounter<TValue>::GetComponentKey(const Component& component) const
+{
+   // Unsatisfied clauses are restricted to unassigned variables, so both sorted lists
+   // define the component exactly. Variables are kept in order of their discovery
+   // in the component, which is used for branching.
+   TComponentKey key;
+   key.reserve(component.clauses.size() + component.variables.size() + 1);
+   for (auto clause : component.clauses)
+   {
+      key.push_back(static_cast<std::uint32_t>(clause));
+   }
+   key.push_back(g_component_key_separator);
+   const auto variables_begin = key.size();
+   for (auto variable : component.variables)
+   {
+      key.push_back(static_cast<std::uint32_t>(variable));
+   }
+   std::sort(key.begin() + variables_begin, key.end());
+   return key;
+}
+
+template <typename TValue>
+long ModelCounter<TValue>::PickBranchVariable(const Component& component)
+{
+   // Variable with the most occurrences in the component splits it faster.
+   for (auto variable : component.variables)
+   {
+      m_scores[variable] = 0;
+   }
+   for (auto clause : component.clauses)
+   {
+      for (auto literal : m_clauses[clause])
+      {
+         if (-1 == GetValue(literal))
+         {
+            ++m_scores[std::labs(literal)];
+         }
+      }
+   }
+
+   // Auxiliary variables are defined by decision ones, so they are chosen
+   // only if there are no decision variables in the component.
+   assert(!component.variables.empty());
+   auto best_variable = component.variables[0];
+   for (auto variable : component.variables)
+   {
+      const auto is_decision = (variable <= m_decision_variable_count);
+      const auto is_best_decision = (best_variable <= m_decision_variable_count);
+      if ((is_decision && !is_best_decision) ||
+          (is_decision == is_best_decision && m_scores[variable] > m_scores[best_variable]))
+      {
+         best_variable = variable;
+      }
+   }
+   return best_variable;
+}
+
+template class ModelCounter<BigInteger>;
+template class ModelCounter<double>;
+
+} // namespace dm
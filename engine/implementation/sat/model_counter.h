@@ -0,0 +1,88 @@
+#pragma once
+
+#include "cnf_formula.h"
+#include "../common/noncopyable.h"
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+namespace dm
+{
+
+// Counts models of a formula by DPLL search with unit propagation. After each decision
+// the remaining clauses are split into independent components, which are counted
+// separately and cached, so formulas with local structure are counted without
+// enumeration of their models.
+// Each model contributes the product of weights of its variable values, so with unit
+// weights the result is the amount of models, and with probabilities as weights it's
+// the probability of the formula being true.
+// Variables from 1 to decision_variable_count are chosen for branching first, the rest are
+// expected to be auxiliary variables of the encoding, which are defined by them.
+template <typename TValue>
+class ModelCounter : public NonCopyable
+{
+public:
+   // Weights are indexed by variable number decreased by one.
+   ModelCounter(const CnfFormula& formula, long decision_variable_count,
+                std::vector<TValue> true_weights, std::vector<TValue> false_weights);
+
+   TValue Count();
+
+private:
+   using TComponentKey = std::vector<std::uint32_t>;
+
+   struct ComponentKeyHash
+   {
+      std::size_t operator()(const TComponentKey& key) const;
+   };
+
+   struct Component
+   {
+      std::vector<long> clauses;
+      std::vector<long> variables;
+   };
+
+   // Returns 1 for true, 0 for false and -1 for unassigned literal.
+   int GetValue(TCnfLiteral literal) const;
+   bool IsSatisfied(long clause) const;
+
+   // Assigns the literal and propagates units. Returns false on conflict.
+   bool Assign(TCnfLiteral literal);
+   bool Propagate(std::size_t trail_head);
+   void Undo(std::size_t trail_size);
+   TValue GetTrailWeight(std::size_t trail_size) const;
+
+   // Counts the part of the formula, formed by unsatisfied clauses from the list
+   // and unassigned variables from the list.
+   TValue CountResidual(const std::vector<long>& clauses, const std::vector<long>& variables);
+   TValue CountComponent(Component& component);
+
+   TComponentKey GetComponentKey(const Component& component) const;
+   long PickBranchVariable(const Component& component);
+
+private:
+   long m_variable_count;
+   long m_decision_variable_count;
+   TCnfClauseVector m_clauses;
+   // Clauses that contain the variable, indexed by variable number.
+   std::vector<std::vector<long>> m_occurrences;
+
+   std::vector<TValue> m_true_weights;
+   std::vector<TValue> m_false_weights;
+
+   std::vector<signed char> m_values;
+   std::vector<TCnfLiteral> m_trail;
+
+   // Marks of clauses and variables, that are valid while they are equal to m_mark.
+   std::vector<long> m_clause_marks;
+   std::vector<long> m_variable_marks;
+   long m_mark;
+   std::vector<long> m_scores;
+
+   std::unordered_map<TComponentKey, TValue, ComponentKeyHash> m_cache;
+   // Estimated memory of the cache in bytes.
+   std::size_t m_cache_memory_size;
+};
+
+} // namespace dm
@@ -0,0 +1,658 @@
+#include "sat_solver.h"
+
+#include <algorithm>
+#include <utility>
+#include <cstdlib>
+#include <cassert>
+
+namespace dm
+{
+
+namespace
+{
+
+const double g_variable_decay = 0.95;
+const double g_clause_decay = 0.999;
+const double g_activity_limit = 1e100;
+
+// Amount of conflicts, multiplied by the Luby sequence value between restarts.
+const long g_restart_base = 100;
+
+// Learnt clauses are reduced when their amount exceeds the limit, which grows after each reduction.
+const long g_min_max_learnt_count = 1000;
+const double g_max_learnt_count_growth = 1.1;
+
+inline long GetVariable(long literal)
+{
+   return literal >> 1;
+}
+
+inline long Negate(long literal)
+{
+   return literal ^ 1;
+}
+
+} // namespace
+
+SatSolver::SatSolver(const CnfFormula& formula) :
+   m_variable_count(formula.GetVariableCount()), m_is_ok(true),
+   m_clauses(), m_watches(2 * m_variable_count), m_learnt_count(0),
+   m_max_learnt_count(std::max<long>(g_min_max_learnt_count, formula.GetClauses().size() / 3)),
+   m_values(m_variable_count, -1), m_phases(m_variable_count, 0),
+   m_levels(m_variable_count, 0), m_reasons(m_variable_count, -1),
+   m_trail(), m_trail_limits(), m_propagation_head(0),
+   m_activities(m_variable_count, 0.0), m_variable_increment(1.0), m_clause_increment(1.0),
+   m_heap(), m_heap_positions(m_variable_count, -1), m_seen(m_variable_count, false), m_model()
+{
+   m_trail.reserve(m_variable_count);
+
+   for (auto variable = 0L; variable < m_variable_count; ++variable)
+   {
+      InsertIntoHeap(variable);
+   }
+
+   for (const auto& clause : formula.GetClauses())
+   {
+      if (!m_is_ok)
+      {
+         break;
+      }
+
+      std::vector<TLiteral> literals;
+      literals.reserve(clause.size());
+      for (auto literal : clause)
+      {
+         literals.push_back(ToLiteral(literal));
+      }
+      AddClause(std::move(literals));
+   }
+}
+
+bool SatSolver::Solve(const TCnfClause& assumptions)
+{
+   if (!m_is_ok)
+   {
+      return false;
+   }
+
+   std::vector<TLiteral> assumption_literals;
+   assumption_literals.reserve(assumptions.size());
+   for (auto literal : assumptions)
+   {
+      assumption_literals.push_back(ToLiteral(literal));
+   }
+   const auto assumption_count = static_cast<long>(assumption_literals.size());
+
+   Backtrack(0);
+
+   auto restart_index = 0L;
+   auto conflict_count = 0L;
+   auto restart_conflict_count = GetLubyValue(restart_index) * g_restart_base;
+
+   std::vector<TLiteral> learnt;
+
+   for (;;)
+   {
+      const auto conflict = Propagate();
+      if (-1 != conflict)
+      {
+         if (0 == GetDecisionLevel())
+         {
+            m_is_ok = false;
+            return false;
+         }
+
+         ++conflict_count;
+
+         long backtrack_level;
+         Analyze(conflict, learnt, backtrack_level);
+         Backtrack(backtrack_level);
+
+         if (1 == learnt.size())
+         {
+            Enqueue(learnt[0], -1);
+         }
+         else
+         {
+            const auto asserting_literal = learnt[0];
+            const auto clause = AttachClause(std::move(learnt), true);
+            BumpClause(clause);
+            Enqueue(asserting_literal, clause);
+         }
+
+         DecayActivities();
+         continue;
+      }
+
+      if (conflict_count >= restart_conflict_count)
+      {
+         conflict_count = 0;
+         restart_conflict_count = GetLubyValue(++restart_index) * g_restart_base;
+         Backtrack(0);
+         continue;
+      }
+
+      if (m_learnt_count - static_cast<long>(m_trail.size()) >= m_max_learnt_count)
+      {
+         ReduceLearntClauses();
+         m_max_learnt_count = static_cast<long>(m_max_learnt_count * g_max_learnt_count_growth);
+      }
+
+      // Assumptions are decided first, one per decision level.
+      auto next = -1L;
+      while (GetDecisionLevel() < assumption_count)
+      {
+         const auto assumption = assumption_literals[GetDecisionLevel()];
+         const auto value = GetValue(assumption);
+         if (1 == value)
+         {
+            m_trail_limits.push_back(static_cast<long>(m_trail.size()));
+         }
+         else if (0 == value)
+         {
+            Backtrack(0);
+            return false;
+         }
+         else
+         {
+            next = assumption;
+            break;
+         }
+      }
+
+      if (-1 == next)
+      {
+         next = PickBranchLiteral();
+         if (-1 == next)
+         {
+            m_model.resize(m_variable_count);
+            for (auto variable = 0L; variable < m_variable_count; ++variable)
+            {
+               m_model[variable] = (1 == m_values[variable]);
+            }
+
+            Backtrack(0);
+            return true;
+         }
+      }
+
+      m_trail_limits.push_back(static_cast<long>(m_trail.size()));
+      Enqueue(next, -1);
+   }
+}
+
+bool SatSolver::GetModelValue(TCnfLiteral variable) const
+{
+   assert(variable > 0 && variable <= (long)m_model.size());
+   return m_model[variable - 1];
+}
+
+SatSolver::TLiteral SatSolver::ToLiteral(TCnfLiteral literal)
+{
+   assert(0 != literal);
+   return 2 * (std::labs(literal) - 1) + (literal < 0 ? 1 : 0);
+}
+
+int SatSolver::GetValue(TLiteral literal) const
+{
+   const auto value = m_values[GetVariable(literal)];
+   return value < 0 ? -1 : (value ^ (literal & 1));
+}
+
+long SatSolver::GetDecisionLevel() const
+{
+   return static_cast<long>(m_trail_limits.size());
+}
+
+void SatSolver::AddClause(std::vector<TLiteral> literals)
+{
+   assert(0 == GetDecisionLevel());
+
+   // Duplicates and literals, that are false at the top level, are removed.
+   // Clauses with opposite or true literals are always satisfied.
+   std::sort(literals.begin(), literals.end());
+   auto size = 0L;
+   for (auto index = 0L; index < (long)literals.size(); ++index)
+   {
+      const auto literal = literals[index];
+      const auto value = GetValue(literal);
+      if (1 == value || (size > 0 && literals[size - 1] == Negate(literal)))
+      {
+         return;
+      }
+      if (0 != value && (0 == size || literals[size - 1] != literal))
+      {
+         literals[size++] = literal;
+      }
+   }
+   literals.resize(size);
+
+   if (literals.empty())
+   {
+      m_is_ok = false;
+   }
+   else if (1 == literals.size())
+   {
+      Enqueue(literals[0], -1);
+      m_is_ok = (-1 == Propagate());
+   }
+   else
+   {
+      AttachClause(std::move(literals), false);
+   }
+}
+
+long SatSolver::AttachClause(std::vector<TLiteral>&& literals, bool is_learnt)
+{
+   assert(literals.size() > 1);
+
+   const auto index = static_cast<long>(m_clauses.size());
+   m_watches[literals[0]].push_back({ index, literals[1] });
+   m_watches[literals[1]].push_back({ index, literals[0] });
+   m_clauses.push_back({ std::move(literals), 0.0, is_learnt, false });
+
+   if (is_learnt)
+   {
+      ++m_learnt_count;
+   }
+   return index;
+}
+
+void SatSolver::Enqueue(TLiteral literal, long reason)
+{
+   const auto variable = GetVariable(literal);
+   assert(-1 == GetValue(literal));
+
+   m_values[variable] = static_cast<signed char>(1 ^ (literal & 1));
+   m_levels[variable] = GetDecisionLevel();
+   m_reasons[variable] = reason;
+   m_trail.push_back(literal);
+}
+
+long SatSolver::Propagate()
+{
+   while (m_propagation_head < (long)m_trail.size())
+   {
+      const auto false_literal = Negate(m_trail[m_propagation_head++]);
+      auto& watches = m_watches[false_literal];
+
+      auto target = 0L;
+      const auto watch_count = static_cast<long>(watches.size());
+      for (auto index = 0L; index < watch_count; ++index)
+      {
+         const auto watcher = watches[index];
+         if (1 == GetValue(watcher.blocker))
+         {
+            watches[target++] = watcher;
+            continue;
+         }
+
+         // The false literal is moved to the second position, so the first
+         // one is the only candidate for propagation.
+         auto& literals = m_clauses[watcher.clause].literals;
+         if (literals[0] == false_literal)
+         {
+            std::swap(literals[0], literals[1]);
+         }
+         assert(literals[1] == false_literal);
+
+         const auto first = literals[0];
+         if (first != watcher.blocker && 1 == GetValue(first))
+         {
+            watches[target++] = { watcher.clause, first };
+            continue;
+         }
+
+         auto is_watch_found = false;
+         const auto literal_count = static_cast<long>(literals.size());
+         for (auto literal_index = 2L; literal_index < literal_count; ++literal_index)
+         {
+            if (0 != GetValue(literals[literal_index]))
+            {
+               std::swap(literals[1], literals[literal_index]);
+               m_watches[literals[1]].push_back({ watcher.clause, first });
+               is_watch_found = true;
+               break;
+            }
+         }
+         if (is_watch_found)
+         {
+            continue;
+         }
+
+         watches[target++] = { watcher.clause, first };
+         if (0 == GetValue(first))
+         {
+            for (++index; index < watch_count; ++index)
+            {
+               watches[target++] = watches[index];
+            }
+            watches.resize(target);
+            m_propagation_head = static_cast<long>(m_trail.size());
+            return watcher.clause;
+         }
+
+         Enqueue(first, watcher.clause);
+      }
+      watches.resize(target);
+   }
+
+   return -1;
+}
+
+void SatSolver::Analyze(long conflict, std::vector<TLiteral>& learnt, long& backtrack_level)
+{
+   learnt.assign(1, -1);
+
+   auto path_count = 0L;
+   auto literal = -1L;
+   auto trail_index = static_cast<long>(m_trail.size()) - 1;
+   auto clause = conflict;
+
+   do
+   {
+      assert(-1 != clause);
+      if (m_clauses[clause].is_learnt)
+      {
+         BumpClause(clause);
+      }
+
+      // The first literal of a reason clause is the implied one.
+      const auto& literals = m_clauses[clause].literals;
+      for (auto index = (-1 == literal) ? 0L : 1L; index < (long)literals.size(); ++index)
+      {
+         const auto reason_literal = literals[index];
+         const auto variable = GetVariable(reason_literal);
+         if (!m_seen[variable] && m_levels[variable] > 0)
+         {
+            BumpVariable(variable);
+            m_seen[variable] = true;
+            if (m_levels[variable] >= GetDecisionLevel())
+            {
+               ++path_count;
+            }
+            else
+            {
+               learnt.push_back(reason_literal);
+            }
+         }
+      }
+
+      while (!m_seen[GetVariable(m_trail[trail_index--])])
+      {
+      }
+      literal = m_trail[trail_index + 1];
+      clause = m_reasons[GetVariable(literal)];
+      m_seen[GetVariable(literal)] = false;
+      --path_count;
+   }
+   while (path_count > 0);
+
+   learnt[0] = Negate(literal);
+
+   // Literals, implied by other literals of the clause, are removed.
+   const auto analyzed = learnt;
+   auto size = 1L;
+   for (auto index = 1L; index < (long)learnt.size(); ++index)
+   {
+      if (!IsRedundant(learnt[index]))
+      {
+         learnt[size++] = learnt[index];
+      }
+   }
+   learnt.resize(size);
+
+   for (auto analyzed_literal : analyzed)
+   {
+      m_seen[GetVariable(analyzed_literal)] = false;
+   }
+
+   // The literal with the highest level goes second to be watched.
+   backtrack_level = 0;
+   if (learnt.size() > 1)
+   {
+      auto max_index = 1L;
+      for (auto index = 2L; index < (long)learnt.size(); ++index)
+      {
+         if (m_levels[GetVariable(learnt[index])] > m_levels[GetVariable(learnt[max_index])])
+         {
+            max_index = index;
+         }
+      }
+      std::swap(learnt[1], learnt[max_index]);
+      backtrack_level = m_levels[GetVariable(learnt[1])];
+   }
+}
+
+bool SatSolver::IsRedundant(TLiteral literal) const
+{
+   const auto reason = m_reasons[GetVariable(literal)];
+   if (-1 == reason)
+   {
+      return false;
+   }
+
+   const auto& literals = m_clauses[reason].literals;
+   for (auto index = 1L; index < (long)literals.size(); ++index)
+   {
+      const auto variable = GetVariable(literals[index]);
+      if (!m_seen[variable] && m_levels[variable] > 0)
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+void SatSolver::Backtrack(long level)
+{
+   if (GetDecisionLevel() <= level)
+   {
+      return;
+   }
+
+   const auto limit = m_trail_limits[level];
+   for (auto index = static_cast<long>(m_trail.size()) - 1; index >= limit; --index)
+   {
+      const auto variable = GetVariable(m_trail[index]);
+      m_phases[variable] = m_values[variable];
+      m_values[variable] = -1;
+      m_reasons[variable] = -1;
+      InsertIntoHeap(variable);
+   }
+
+   m_trail.resize(limit);
+   m_trail_limits.resize(level);
+   m_propagation_head = limit;
+}
+
+SatSolver::TLiteral SatSolver::PickBranchLiteral()
+{
+   while (!m_heap.empty())
+   {
+      const auto variable = RemoveHeapTop();
+      if (-1 == m_values[variable])
+      {
+         // Saved phase is reused, initially variables are tried as false.
+         return 2 * variable + (m_phases[variable] ? 0 : 1);
+      }
+   }
+   return -1;
+}
+
+void SatSolver::ReduceLearntClauses()
+{
+   std::vector<long> candidates;
+   for (auto index = 0L; index < (long)m_clauses.size(); ++index)
+   {
+      const auto& clause = m_clauses[index];
+      if (clause.is_learnt && !clause.is_deleted && clause.literals.size() > 2 && !IsLocked(index))
+      {
+         candidates.push_back(index);
+      }
+   }
+
+   // The less active half of clauses is deleted.
+   std::sort(candidates.begin(), candidates.end(), [this](long clause1, long clause2)
+   {
+      return m_clauses[clause1].activity < m_clauses[clause2].activity;
+   });
+   candidates.resize(candidates.size() / 2);
+
+   for (auto index : candidates)
+   {
+      auto& clause = m_clauses[index];
+      clause.is_deleted = true;
+      clause.literals.clear();
+      clause.literals.shrink_to_fit();
+      --m_learnt_count;
+   }
+
+   for (auto& watches : m_watches)
+   {
+      watches.erase(std::remove_if(watches.begin(), watches.end(), [this](const Watcher& watcher)
+      {
+         return m_clauses[watcher.clause].is_deleted;
+      }), watches.end());
+   }
+}
+
+bool SatSolver::IsLocked(long clause) const
+{
+   const auto literal = m_clauses[clause].literals[0];
+   return 1 == GetValue(literal) && m_reasons[GetVariable(literal)] == clause;
+}
+
+void SatSolver::BumpVariable(long variable)
+{
+   m_activities[variable] += m_variable_increment;
+   if (m_activities[variable] > g_activity_limit)
+   {
+      for (auto& activity : m_activities)
+      {
+         activity /= g_activity_limit;
+      }
+      m_variable_increment /= g_activity_limit;
+   }
+
+   if (-1 != m_heap_positions[variable])
+   {
+      SiftHeapUp(m_heap_positions[variable]);
+   }
+}
+
+void SatSolver::BumpClause(long clause)
+{
+   m_clauses[clause].activity += m_clause_increment;
+   if (m_clauses[clause].activity > g_activity_limit)
+   {
+      for (auto& learnt_clause : m_clauses)
+      {
+         learnt_clause.activity /= g_activity_limit;
+      }
+      m_clause_increment /= g_activity_limit;
+   }
+}
+
+void SatSolver::DecayActivities()
+{
+   m_variable_increment /= g_variable_decay;
+   m_clause_increment /= g_clause_decay;
+}
+
+void SatSolver::InsertIntoHeap(long variable)
+{
+   if (-1 == m_heap_positions[variable])
+   {
+      m_heap_positions[variable] = static_cast<long>(m_heap.size());
+      m_heap.push_back(variable);
+      SiftHeapUp(m_heap_positions[variable]);
+   }
+}
+
+long SatSolver::RemoveHeapTop()
+{
+   assert(!m_heap.empty());
+
+   const auto top = m_heap.front();
+   m_heap_positions[top] = -1;
+
+   const auto last = m_heap.back();
+   m_heap.pop_back();
+   if (!m_heap.empty())
+   {
+      m_heap.front() = last;
+      m_heap_positions[last] = 0;
+      SiftHeapDown(0);
+   }
+
+   return top;
+}
+
+void SatSolver::SiftHeapUp(long position)
+{
+   const auto variable = m_heap[position];
+   while (position > 0)
+   {
+      const auto parent = (position - 1) / 2;
+      if (m_activities[m_heap[parent]] >= m_activities[variable])
+      {
+         break;
+      }
+      m_heap[position] = m_heap[parent];
+      m_heap_positions[m_heap[position]] = position;
+      position = parent;
+   }
+   m_heap[position] = variable;
+   m_heap_positions[variable] = position;
+}
+
+void SatSolver::SiftHeapDown(long position)
+{
+   const auto variable = m_heap[position];
+   const auto size = static_cast<long>(m_heap.size());
+   for (;;)
+   {
+      auto child = 2 * position + 1;
+      if (child >= size)
+      {
+         break;
+      }
+      if (child + 1 < size && m_activities[m_heap[child + 1]] > m_activities[m_heap[child]])
+      {
+         ++child;
+      }
+      if (m_activities[m_heap[child]] <= m_activities[variable])
+      {
+         break;
+      }
+      m_heap[position] = m_heap[child];
+      m_heap_positions[m_heap[position]] = position;
+      position = child;
+   }
+   m_heap[position] = variable;
+   m_heap_positions[variable] = position;
+}
+
+long SatSolver::GetLubyValue(long index)
+{
+   // Finds the finite subsequence, that contains the index, and its size.
+   auto size = 1L;
+   auto sequence = 0L;
+   while (size < index + 1)
+   {
+      ++sequence;
+      size = 2 * size + 1;
+   }
+
+   while (size - 1 != index)
+   {
+      size = (size - 1) / 2;
+      --sequence;
+      index = index % size;
+   }
+
+   return 1L << sequence;
+}
+
+} // namespace dm
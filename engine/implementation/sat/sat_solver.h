@@ -0,0 +1,104 @@
+#pragma once
+
+#include "cnf_formula.h"
+#include "../common/noncopyable.h"
+
+#include <vector>
+
+namespace dm
+{
+
+// Conflict-driven clause learning solver: two watched literals, VSIDS branching
+// with phase saving, first-UIP learning, Luby restarts and reduction of learnt clauses.
+class SatSolver : public NonCopyable
+{
+public:
+   SatSolver(const CnfFormula& formula);
+
+   // Returns true if the formula is satisfiable with all assumptions being true.
+   // Learnt clauses are kept between calls, since they don't depend on assumptions.
+   bool Solve(const TCnfClause& assumptions = TCnfClause());
+
+   // Value of the variable in the last found model.
+   bool GetModelValue(TCnfLiteral variable) const;
+
+private:
+   // Internal literal: variable index multiplied by 2, plus 1 for negated variable.
+   using TLiteral = long;
+
+   struct Clause
+   {
+      std::vector<TLiteral> literals;
+      double activity;
+      bool is_learnt;
+      bool is_deleted;
+   };
+
+   struct Watcher
+   {
+      long clause;
+      // Literal of the clause, that allows to skip the clause if it is true.
+      TLiteral blocker;
+   };
+
+   static TLiteral ToLiteral(TCnfLiteral literal);
+
+   // Returns 1 for true, 0 for false and -1 for unassigned literal.
+   int GetValue(TLiteral literal) const;
+   long GetDecisionLevel() const;
+
+   void AddClause(std::vector<TLiteral> literals);
+   long AttachClause(std::vector<TLiteral>&& literals, bool is_learnt);
+   void Enqueue(TLiteral literal, long reason);
+   // Returns index of the conflicting clause or -1.
+   long Propagate();
+   // Builds the first-UIP clause, its first literal is the asserting one.
+   void Analyze(long conflict, std::vector<TLiteral>& learnt, long& backtrack_level);
+   bool IsRedundant(TLiteral literal) const;
+   void Backtrack(long level);
+   TLiteral PickBranchLiteral();
+   void ReduceLearntClauses();
+   bool IsLocked(long clause) const;
+
+   void BumpVariable(long variable);
+   void BumpClause(long clause);
+   void DecayActivities();
+
+   // Binary max-heap of variables by activity.
+   void InsertIntoHeap(long variable);
+   long RemoveHeapTop();
+   void SiftHeapUp(long position);
+   void SiftHeapDown(long position);
+
+   static long GetLubyValue(long index);
+
+private:
+   long m_variable_count;
+   bool m_is_ok;
+
+   std::vector<Clause> m_clauses;
+   std::vector<std::vector<Watcher>> m_watches;
+   long m_learnt_count;
+   long m_max_learnt_count;
+
+   std::vector<signed char> m_values;
+   std::vector<signed char> m_phases;
+   std::vector<long> m_levels;
+   std::vector<long> m_reasons;
+   std::vector<TLiteral> m_trail;
+   std::vector<long> m_trail_limits;
+   long m_propagation_head;
+
+   std::vector<double> m_activities;
+   double m_variable_increment;
+   double m_clause_increment;
+   std::vector<long> m_heap;
+   std::vector<long> m_heap_positions;
+
+   // Temporary marks of variables during conflict analysis.
+   std::vector<bool> m_seen;
+
+   std::vector<bool> m_model;
+};
+
+} // namespace dm
@@ -0,0 +1,134 @@
+#include "sat_utils.h"
+#include "cnf_encoder.h"
+#include "sat_solver.h"
+#include "model_counter.h"
+
+namespace dm
+{
+
+namespace
+{
+
+// Parameters are fixed one by one, trying false first. The last model is reused
+// while it agrees with the chosen prefix, so the solver is called only when
+// the parameter must be checked for false.
+bool FindFirstModel(const CnfFormula& formula, long param_count, std::vector<bool>& param_values)
+{
+   SatSolver solver(formula);
+   if (!solver.Solve())
+   {
+      return false;
+   }
+
+   param_values.resize(param_count);
+   for (auto index = 0L; index < param_count; ++index)
+   {
+      param_values[index] = solver.GetModelValue(CnfEncoder::GetParamLiteral(index));
+   }
+
+   TCnfClause assumptions;
+   assumptions.reserve(param_count);
+   for (auto index = 0L; index < param_count; ++index)
+   {
+      const auto literal = CnfEncoder::GetParamLiteral(index);
+      if (param_values[index])
+      {
+         assumptions.push_back(-literal);
+         if (solver.Solve(assumptions))
+         {
+            for (auto model_index = index; model_index < param_count; ++model_index)
+            {
+               param_values[model_index] = solver.GetModelValue(CnfEncoder::GetParamLiteral(model_index));
+            }
+            continue;
+         }
+         assumptions.pop_back();
+      }
+      assumptions.push_back(param_values[index] ? literal : -literal);
+   }
+
+   return true;
+}
+
+// Unlike the satisfiability encoding, auxiliary variables are defined in both directions,
+// so they are determined by parameters and don't change the amount of models.
+CnfFormula BuildCountingCnf(const TUniqueExpressionPtr& expr, long param_count)
+{
+   CnfFormula formula;
+   CnfEncoder encoder(formula, param_count);
+
+   formula.AddClause({ encoder.Encode(expr, CnfEncoder::Both) });
+   return formula;
+}
+
+} // namespace
+
+CnfFormula BuildSatisfiabilityCnf(const TUniqueExpressionPtr& expr, long param_count)
+{
+   CnfFormula formula;
+   CnfEncoder encoder(formula, param_count);
+
+   formula.AddClause({ encoder.Encode(expr, CnfEncoder::Positive) });
+   return formula;
+}
+
+bool FindFirstSatisfyingCombination(
+   const TUniqueExpressionPtr& expr, long param_count, std::vector<bool>& param_values)
+{
+   return FindFirstModel(BuildSatisfiabilityCnf(expr, param_count), param_count, param_values);
+}
+
+bool FindFirstFalsifyingCombination(
+   const TUniqueExpressionPtr& expr, long param_count, std::vector<bool>& param_values)
+{
+   CnfFormula formula;
+   CnfEncoder encoder(formula, param_count);
+
+   formula.AddClause({ -encoder.Encode(expr, CnfEncoder::Negative) });
+   return FindFirstModel(formula, param_count, param_values);
+}
+
+bool FindFirstDifferingCombination(
+   const TUniqueExpressionPtr& expr1, const TUniqueExpressionPtr& expr2, long param_count, std::vector<bool>& param_values)
+{
+   CnfFormula formula;
+   CnfEncoder encoder(formula, param_count);
+
+   // Miter: outputs of the expressions differ.
+   const auto output1 = encoder.Encode(expr1, CnfEncoder::Both);
+   const auto output2 = encoder.Encode(expr2, CnfEncoder::Both);
+   formula.AddClause({ output1, output2 });
+   formula.AddClause({ -output1, -output2 });
+
+   return FindFirstModel(formula, param_count, param_values);
+}
+
+BigInteger CountSatisfyingCombinations(const TUniqueExpressionPtr& expr, long param_count)
+{
+   const auto formula = BuildCountingCnf(expr, param_count);
+   const auto variable_count = formula.GetVariableCount();
+
+   ModelCounter<BigInteger> counter(formula, param_count,
+      std::vector<BigInteger>(variable_count, 1), std::vector<BigInteger>(variable_count, 1));
+   return counter.Count();
+}
+
+double ComputeTruthProbability(const TUniqueExpressionPtr& expr, const std::vector<double>& param_probabilities)
+{
+   const auto param_count = static_cast<long>(param_probabilities.size());
+   const auto formula = BuildCountingCnf(expr, param_count);
+   const auto variable_count = formula.GetVariableCount();
+
+   std::vector<double> true_weights(variable_count, 1.0);
+   std::vector<double> false_weights(variable_count, 1.0);
+   for (auto index = 0L; index < param_count; ++index)
+   {
+      true_weights[index] = param_probabilities[index];
+      false_weights[index] = 1.0 - param_probabilities[index];
+   }
+
+   ModelCounter<double> counter(formula, param_count, std::move(true_weights), std::move(false_weights));
+   return counter.Count();
+}
+
+} // namespace dm
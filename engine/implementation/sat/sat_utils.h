@@ -0,0 +1,36 @@
+#pragma once
+
+#include "cnf_formula.h"
+#include "../expressions/expression_unique_table.h"
+#include "../common/big_integer.h"
+
+#include <vector>
+
+namespace dm
+{
+
+// Clauses of the formula are satisfiable exactly when the expression is.
+CnfFormula BuildSatisfiabilityCnf(const TUniqueExpressionPtr& expr, long param_count);
+
+// Searches the first combination of parameters in order of the truth table, on which
+// the expression is true. Returns false if the expression is unsatisfiable.
+bool FindFirstSatisfyingCombination(
+   const TUniqueExpressionPtr& expr, long param_count, std::vector<bool>& param_values);
+
+// Searches the first combination of parameters, on which the expression is false.
+// Returns false if the expression is a tautology.
+bool FindFirstFalsifyingCombination(
+   const TUniqueExpressionPtr& expr, long param_count, std::vector<bool>& param_values);
+
+// The same search for the miter of two expressions with the same parameters.
+bool FindFirstDifferingCombination(
+   const TUniqueExpressionPtr& expr1, const TUniqueExpressionPtr& expr2, long param_count, std::vector<bool>& param_values);
+
+// Amount of parameter combinations, on which the expression is true.
+BigInteger CountSatisfyingCombinations(const TUniqueExpressionPtr& expr, long param_count);
+
+// Probability of the expression being true, when parameters are independent
+// and each of them is true with the given probability.
+double ComputeTruthProbability(const TUniqueExpressionPtr& expr, const std::vector<double>& param_probabilities);
+
+} // namespace dm
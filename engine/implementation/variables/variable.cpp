@@ -1,5 +1,7 @@
 #include "variable.h"
 #include "../expressions/expression_param_ref.h"
+#include "../expressions/expression_application.h"
+#include "../expressions/expression_calculator.h"
 
 #include <cassert>
 
@@ -7,22 +9,36 @@ namespace dm
 {
 
 Variable::Variable() :
-   VariableDeclaration(), m_expression()
+   VariableDeclaration(), m_expression(), m_shared_expression(), m_flat_expression(), m_program(), m_native_program(), m_is_native(false), m_has_applications(false),
+   m_is_applied(false)
 {
 }
 
 Variable::Variable(const StringPtrLen& name) :
-   VariableDeclaration(name), m_expression()
+   VariableDeclaration(name), m_expression(), m_shared_expression(), m_flat_expression(), m_program(), m_native_program(), m_is_native(false), m_has_applications(false),
+   m_is_applied(false)
 {
 }
 
 Variable::Variable(const StringPtrLen& name, const Variable& rhs) :
-   VariableDeclaration(name, rhs), m_expression()
+   VariableDeclaration(name, rhs), m_expression(), m_shared_expression(), m_flat_expression(), m_program(), m_native_program(), m_is_native(false), m_has_applications(false),
+   m_is_applied(false)
 {
    const auto param_count = GetParameterCount();
 
    assert(param_count == rhs.GetParameterCount());
 
+   // Hash-consed and flat expressions don't depend on the variable, so they are just shared or copied.
+   if (rhs.m_expression.get() == nullptr)
+   {
+      m_shared_expression = rhs.m_shared_expression;
+      if (rhs.m_flat_expression.get() != nullptr)
+      {
+         m_flat_expression = std::make_unique<FlatExpression>(*rhs.m_flat_expression);
+      }
+      return;
+   }
+
    TExpressionPtrVector replace_params;
    replace_params.reserve(param_count);
    for (auto index = 0L; index < param_count; ++index)
@@ -32,27 +48,184 @@ Variable::Variable(const StringPtrLen& name, const Variable& rhs) :
    }
 
    m_expression = rhs.GetExpression()->CloneWithSubstitution(replace_params);
+   m_has_applications = rhs.m_has_applications;
 }
 
 void Variable::SetExpression(TExpressionPtr&& expression)
 {
    assert(expression.get() != nullptr);
    m_expression = std::move(expression);
+   m_has_applications = ContainsApplications(m_expression);
+   ResetCompiledForms();
 }
 
 const TExpressionPtr& Variable::GetExpression() const
 {
+   if (m_expression.get() == nullptr)
+   {
+      if (m_shared_expression.get() != nullptr)
+      {
+         m_expression = ExpandExpression(m_shared_expression, *this);
+      }
+      else if (m_flat_expression.get() != nullptr)
+      {
+         m_expression = m_flat_expression->ToTree(*this);
+      }
+   }
    return m_expression;
 }
 
 TExpressionPtr& Variable::GetExpression()
 {
+   ((const Variable*)this)->GetExpression();
+   ResetCompiledForms();
    return m_expression;
 }
 
-std::string Variable::ToString() const
+void Variable::SetSharedExpression(TUniqueExpressionPtr&& expression)
+{
+   assert(expression.get() != nullptr);
+   m_expression.reset();
+   m_has_applications = false;
+   ResetCompiledForms();
+   m_shared_expression = std::move(expression);
+   if (m_is_applied)
+   {
+      GetExpression();
+   }
+}
+
+const TUniqueExpressionPtr& Variable::GetSharedExpression() const
+{
+   if (m_shared_expression.get() == nullptr)
+   {
+      assert(GetExpression().get() != nullptr);
+      m_shared_expression = InternExpression(GetExpression());
+   }
+   return m_shared_expression;
+}
+
+void Variable::SetFlatExpression(TFlatExpressionPtr&& expression)
+{
+   assert(expression.get() != nullptr);
+   m_expression.reset();
+   m_has_applications = false;
+   ResetCompiledForms();
+   m_flat_expression = std::move(expression);
+   if (m_is_applied)
+   {
+      GetExpression();
+   }
+}
+
+const FlatExpression* Variable::GetFlatExpression() const
+{
+   return m_flat_expression.get();
+}
+
+bool Variable::HasApplications() const
 {
+   return m_has_applications;
+}
+
+void Variable::ExpandApplications()
+{
+   if (m_has_applications)
+   {
+      dm::ExpandApplications(GetExpression());
+      m_has_applications = false;
+   }
+}
+
+const ExpressionProgram& Variable::GetProgram() const
+{
+   if (m_program.get() == nullptr)
+   {
+      if (m_has_applications)
+      {
+         auto expanded_expression = m_expression->Clone();
+         dm::ExpandApplications(expanded_expression);
+         m_program = std::make_unique<ExpressionProgram>(expanded_expression);
+      }
+      else
+      {
+         m_program = std::make_unique<ExpressionProgram>(GetExpression());
+      }
+
+      if (m_is_native)
+      {
+         m_native_program = NativeExpressionProgram::Create(*m_program);
+      }
+   }
+
+   return *m_program;
+}
+
+bool Variable::CompileNative()
+{
+   m_is_native = true;
+   m_program.reset();
+   m_native_program.reset();
+
+   GetProgram();
+
+   return (m_native_program.get() != nullptr);
+}
+
+bool Variable::IsNative() const
+{
+   if (!m_is_native)
+   {
+      return false;
+   }
+
+   GetProgram();
+   return (m_native_program.get() != nullptr);
+}
+
+TBitBlock Variable::Calculate(const TBitBlock param_values[]) const
+{
+   // Applied variables are calculated with bound parameters, that is cheaper,
+   // than calculation of the expanded program.
+   if (m_has_applications && !m_is_native)
+   {
+      return CalculateExpression(m_expression, param_values);
+   }
+
+   if (m_flat_expression.get() != nullptr && !m_is_native)
+   {
+      return CalculateExpression(*m_flat_expression, param_values);
+   }
+
+   const auto& program = GetProgram();
+
+   // Native code is absent if it couldn't be generated on this platform.
+   return (m_native_program.get() != nullptr) ?
+      m_native_program->Execute(param_values) : program.Execute(param_values);
+}
+
+void Variable::PrepareCalculation() const
+{
+   if ((!m_has_applications && m_flat_expression.get() == nullptr) || m_is_native)
+   {
+      GetProgram();
+   }
+   else if (m_has_applications)
+   {
+      PrepareApplications(m_expression);
+   }
+}
+
+void Variable::PrepareApplication() const
+{
+   m_is_applied = true;
+   GetExpression();
    assert(m_expression.get() != nullptr);
+}
+
+std::string Variable::ToString() const
+{
+   assert(m_expression.get() != nullptr || m_shared_expression.get() != nullptr || m_flat_expression.get() != nullptr);
    
    std::string ret;
 
@@ -61,9 +234,30 @@ std::string Variable::ToString() const
       ret += VariableDeclaration::ToString();
       ret += " := ";
    }
-   ret += m_expression->ToString();
+
+   // Hash-consed and flat expressions are printed without building the tree.
+   if (m_expression.get() != nullptr)
+   {
+      ret += m_expression->ToString();
+   }
+   else if (m_shared_expression.get() != nullptr)
+   {
+      ret += UniqueExpressionToString(m_shared_expression, *this);
+   }
+   else
+   {
+      ret += m_flat_expression->ToString(*this);
+   }
 
    return ret;
 }
 
+void Variable::ResetCompiledForms()
+{
+   m_shared_expression.reset();
+   m_flat_expression.reset();
+   m_program.reset();
+   m_native_program.reset();
+}
+
 } // namespace dm
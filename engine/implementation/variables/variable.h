@@ -2,13 +2,18 @@
 
 #include "variable_declaration.h"
 #include "../expressions/expression_base.h"
+#include "../expressions/expression_unique_table.h"
+#include "../expressions/expression_flat.h"
+#include "../expressions/expression_program.h"
+#include "../expressions/expression_native_program.h"
 
 #include <memory>
 
 namespace dm
 {
 
-class Variable : public VariableDeclaration
+// Variables are shared with applications (see ApplicationExpression), that refer to them.
+class Variable : public VariableDeclaration, public std::enable_shared_from_this<Variable>
 {
 public:
    // Unnamed variable
@@ -18,14 +23,64 @@ public:
    Variable(const StringPtrLen& name, const Variable& rhs);
 
    void SetExpression(TExpressionPtr&& expression);
+   // Expression tree of the variable, that is defined by the hash-consed
+   // or the flat expression only, is built on the first request.
    const TExpressionPtr& GetExpression() const;
+   // Non-constant access implies modification of the expression, so the compiled
+   // program, the hash-consed and the flat expressions are dropped.
    TExpressionPtr& GetExpression();
 
+   // Defines the variable by the hash-consed expression, sharing its nodes
+   // with other expressions. Tree of an applied variable is rebuilt at once.
+   void SetSharedExpression(TUniqueExpressionPtr&& expression);
+   // Returns the hash-consed expression, that is built from the tree on the first request.
+   const TUniqueExpressionPtr& GetSharedExpression() const;
+
+   // Defines the variable by the flat expression, that is used for printing
+   // and calculation without building the tree, unless the variable is applied.
+   void SetFlatExpression(TFlatExpressionPtr&& expression);
+   // Returns nullptr if the variable is not defined by a flat expression.
+   const FlatExpression* GetFlatExpression() const;
+
+   // Returns true if the expression contains applications of other variables.
+   bool HasApplications() const;
+   // Replaces applications of other variables by their expanded expressions.
+   void ExpandApplications();
+
+   // Returns the program, compiled from the expression on the first request.
+   // Applications of other variables are expanded for compilation.
+   const ExpressionProgram& GetProgram() const;
+   // Requests calculation by native machine code, that is regenerated each time
+   // the program is recompiled. Returns false if native code isn't supported,
+   // so the interpreted program is used.
+   bool CompileNative();
+   // Returns whether the variable is calculated by native code.
+   bool IsNative() const;
+   // Calculates the variable for a block of bit-sliced combinations. Flat expression and
+   // expression with applications are calculated directly, unless native code is compiled.
+   TBitBlock Calculate(const TBitBlock param_values[]) const;
+   // Prepares everything, that Calculate needs, so it can be called from concurrent threads.
+   void PrepareCalculation() const;
+   // Builds the tree of the variable, that is referred by applications. Applications are
+   // calculated from concurrent threads, so the tree of the variable is kept built
+   // whatever expression is set later.
+   void PrepareApplication() const;
+
    // IStringable
    virtual std::string ToString() const override;
 
 private:
-   TExpressionPtr m_expression;
+   void ResetCompiledForms();
+
+private:
+   mutable TExpressionPtr m_expression;
+   mutable TUniqueExpressionPtr m_shared_expression;
+   TFlatExpressionPtr m_flat_expression;
+   mutable TExpressionProgramPtr m_program;
+   mutable TNativeExpressionProgramPtr m_native_program;
+   bool m_is_native;
+   bool m_has_applications;
+   mutable bool m_is_applied;
 };
 
 using TVariablePtr = std::unique_ptr<Variable>;
@@ -0,0 +1,37 @@
+#include "variable_calculator.h"
+
+namespace dm
+{
+
+VariableCalculator::VariableCalculator(const Variable& variable) :
+   m_variable(variable), m_incremental_calculator()
+{
+   if (m_variable.IsNative())
+   {
+      return;
+   }
+
+   if (m_variable.GetFlatExpression() != nullptr)
+   {
+      m_incremental_calculator = std::make_unique<IncrementalCalculator>(
+         *m_variable.GetFlatExpression(), m_variable.GetParameterCount());
+   }
+   else if (!m_variable.HasApplications())
+   {
+      // Expression with applications is calculated with bound parameters instead.
+      m_incremental_calculator = std::make_unique<IncrementalCalculator>(
+         m_variable.GetExpression(), m_variable.GetParameterCount());
+   }
+}
+
+TBitBlock VariableCalculator::Calculate(const TBitBlock param_values[], long changed_index)
+{
+   if (m_incremental_calculator.get() != nullptr)
+   {
+      return m_incremental_calculator->Calculate(param_values, changed_index);
+   }
+
+   return m_variable.Calculate(param_values);
+}
+
+} // namespace dm
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "variable.h"
+#include "../expressions/expression_incremental_calculator.h"
+#include "../common/noncopyable.h"
+
+#include <memory>
+
+namespace dm
+{
+
+// Calculates a variable over blocks, generated by BitCombinationGenerator in Gray code mode.
+// Interpreted variables are recalculated incrementally, while native code is fast enough
+// to calculate the whole expression for each block. Variables with applications are
+// calculated by Variable::Calculate too, not to expand their expressions.
+class VariableCalculator : public NonCopyable
+{
+public:
+   VariableCalculator(const Variable& variable);
+
+   TBitBlock Calculate(const TBitBlock param_values[], long changed_index);
+
+private:
+   const Variable& m_variable;
+   std::unique_ptr<IncrementalCalculator> m_incremental_calculator;
+};
+
+} // namespace dm
@@ -6,7 +6,8 @@ namespace dm
 {
 
 VariableManager::VariableManager() : 
-   m_variables(), m_curr_iterator(m_variables.cend())
+   m_variables(), m_curr_iterator(m_variables.cend()), m_is_hash_consing(false), m_is_lazy_application(false), m_is_flat_store(false),
+   m_is_canonical_order(false)
 {
 }
 
@@ -66,4 +67,44 @@ const Variable* VariableManager::GetNextVariable() const
    return (*m_curr_iterator).second.get();
 }
 
+void VariableManager::SetHashConsing(bool is_hash_consing)
+{
+   m_is_hash_consing = is_hash_consing;
+}
+
+bool VariableManager::IsHashConsing() const
+{
+   return m_is_hash_consing;
+}
+
+void VariableManager::SetLazyApplication(bool is_lazy_application)
+{
+   m_is_lazy_application = is_lazy_application;
+}
+
+bool VariableManager::IsLazyApplication() const
+{
+   return m_is_lazy_application;
+}
+
+void VariableManager::SetFlatStore(bool is_flat_store)
+{
+   m_is_flat_store = is_flat_store;
+}
+
+bool VariableManager::IsFlatStore() const
+{
+   return m_is_flat_store;
+}
+
+void VariableManager::SetCanonicalOrder(bool is_canonical_order)
+{
+   m_is_canonical_order = is_canonical_order;
+}
+
+bool VariableManager::IsCanonicalOrder() const
+{
+   return m_is_canonical_order;
+}
+
 } // namespace dm
@@ -23,11 +23,36 @@ public:
    const Variable* GetFirstVariable() const;
    const Variable* GetNextVariable() const;
 
+   // In hash-consing mode declared variables are stored as hash-consed expressions,
+   // and usages of variables are substituted without copying of their expressions.
+   void SetHashConsing(bool is_hash_consing);
+   bool IsHashConsing() const;
+
+   // In lazy application mode usages of variables are parsed into applications,
+   // that refer to the used variables and are expanded on demand.
+   void SetLazyApplication(bool is_lazy_application);
+   bool IsLazyApplication() const;
+
+   // In flat store mode declared variables are stored as flat expressions.
+   void SetFlatStore(bool is_flat_store);
+   bool IsFlatStore() const;
+
+   // In canonical order mode operands of declared variables are sorted, so expressions,
+   // that differ by order of operands only, are the same. Hash-consed and flat
+   // expressions keep the order of operands.
+   void SetCanonicalOrder(bool is_canonical_order);
+   bool IsCanonicalOrder() const;
+
 private:
-   using TVariablePtrMap = std::map<std::string, TVariablePtr>;
+   // Variables are shared with applications, that refer to them.
+   using TVariablePtrMap = std::map<std::string, std::shared_ptr<Variable>>;
 
    TVariablePtrMap m_variables;
    mutable TVariablePtrMap::const_iterator m_curr_iterator;
+   bool m_is_hash_consing;
+   bool m_is_lazy_application;
+   bool m_is_flat_store;
+   bool m_is_canonical_order;
 };
 
 } // namespace dm